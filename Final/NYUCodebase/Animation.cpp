@@ -32,71 +32,39 @@ void Animation::add_sprite(Sprite new_sprite){
 
 
 
-void Animation::advance(){
-	current_index += 1;
-	if (current_index >= sprites.size()){
-		if (loop){
-			current_index = 0;
-		}
-		else{
-			done = true;
-		}
+int Animation::frame_at(float time) const{
+	int count = sprites.size();
+	if (count <= 1){
+		return 0;
 	}
-}
-
-//seconds since program started
-float Animation::get_runtime(){
-	float ticks = (float)SDL_GetTicks() / 1000.0f;
-	return ticks;
-}
 
-void Animation::update(){
-	float current_runtime = get_runtime();
-	if (current_runtime - last_change > interval){
-		advance();
-		last_change = get_runtime();
+	int frame = (int)(time / interval);
+	if (loop){
+		return frame % count;
 	}
+	return frame < count ? frame : -1;
 }
 
-
-void Animation::update_size(float width_, float height_){
-	for (int x = 0; x < sprites.size(); x++){
-		//sprites[x].set_size(width_, height_);
+void Animation::draw(int frame){
+	if (frame >= 0 && frame < sprites.size()){
+		sprites[frame].draw();
 	}
 }
 
 
-void Animation::reset(){
-	start_time = get_runtime();
-	//current_index = 0;
-	//done = false;
+void Animator::play(Animation* clip_){
+	clip = clip_;
+	time = 0;
+	frame = 0;
 }
 
-
-void Animation::draw(){
-
-	if (sprites.size() == 1){
-		current_index = 0;
-	}
-
-
-	if (current_index >= 0 && current_index < sprites.size()){
-		sprites[current_index].draw();
-	}
-
+void Animator::advance(float elapsed){
+	time += elapsed;
+	frame = clip != NULL ? clip->frame_at(time) : 0;
 }
 
-
-bool Animation::done_time_elapsed(float elapsed_){
-	if (!done){
-		return false;
+void advance_animators(Animator** animators, int count, float elapsed){
+	for (int i = 0; i < count; i++){
+		animators[i]->advance(elapsed);
 	}
-
-	float current_runtime = get_runtime();
-	if (current_runtime - last_change > elapsed_){
-		return true;
-	}
-
-	return false;
 }
-
@@ -18,19 +18,15 @@ class Sprite;
 class App;
 
 #include "Sprite.h";
+//A clip: frames and timing, shared by every entity playing it and not
+//changed once set up. Playback state lives in each entity's Animator.
 class Animation{
 public:
 	std::vector<Sprite> sprites;
 	int animation_count = 0;
 
-	float last_change = 0;
-	float interval = .085; //milliseconds (ms)
-	int current_index = 0;
-
+	float interval = .085; //seconds per frame
 	bool loop = true;
-	bool done = false;
-
-	float start_time = 0;
 
 	std::shared_ptr<App> app;
 
@@ -42,23 +38,26 @@ public:
 
 	void add_sprite(Sprite new_sprite);
 
-	float get_runtime();
-
-	void advance();
-
-	void reset();
-	void update();
-
+	//(time / interval) mod frames, so a long step skips frames instead of
+	//slowing down. -1 once a non looping clip of several frames has played out.
+	int frame_at(float time) const;
 
-	void update_size(float width_, float height_);
-
-
-	void draw();
+	void draw(int frame);
 
+};
 
-	bool done_time_elapsed(float elapsed_);
+//Per entity playback, plain data pointing at a shared clip
+struct Animator{
+	Animation* clip = NULL;
+	float time = 0; //sim seconds since the clip started
+	int frame = 0;
 
+	void play(Animation* clip_);
+	void advance(float elapsed);
 };
 
+//One pass over every animator, all stepped by the same sim time
+void advance_animators(Animator** animators, int count, float elapsed);
+
 
 #endif
\ No newline at end of file
@@ -6,41 +6,85 @@
 #endif
 
 void App::init(){
-	Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
-	Mix_Chunk* laser1 = Mix_LoadWAV("resources/pain.wav");
-	sounds["pain"] = laser1;
-
-	//Play music
-	music1 = Mix_LoadMUS("resources/ffx.mp3");
-	Mix_PlayMusic(music1, -1);
-
+	boot_profile.start();
+	Uint64 init_start = boot_profile.now();
+
+	//Audio and shader/font files don't need the window, so they load on
+	//their own threads while the window and GL context come up
+	SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
+
+	std::thread audio_thread([this]{
+		Uint64 step = boot_profile.now();
+		//Music is buffered separately, so the device buffer only sets effect latency
+		Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, sfx_buffer_samples);
+		music.open();
+		boot_profile.record("audio open", step);
+
+		step = boot_profile.now();
+		pain_sound = sounds.load("pain", "resources/pain.wav", 2, 1);
+		sounds.start();
+		boot_profile.record("audio decode", step);
+	});
+
+	std::string shader_sources[5];
+	std::thread file_thread([this, &shader_sources]{
+		Uint64 step = boot_profile.now();
+		shader_sources[0] = ShaderProgram::ReadShaderFile(RESOURCE_FOLDER"vertex_textured.glsl");
+		shader_sources[1] = ShaderProgram::ReadShaderFile(RESOURCE_FOLDER"fragment_textured.glsl");
+		shader_sources[2] = ShaderProgram::ReadShaderFile(RESOURCE_FOLDER"vertex.glsl");
+		shader_sources[3] = ShaderProgram::ReadShaderFile(RESOURCE_FOLDER"fragment.glsl");
+		shader_sources[4] = ShaderProgram::ReadShaderFile(RESOURCE_FOLDER"fragment_sdf.glsl");
+		boot_profile.record("shader source read", step);
+
+		step = boot_profile.now();
+		hud_font.prepare("resources/font.png", "resources/font.sdf");
+		boot_profile.record("sdf font read", step);
+	});
+
+	Uint64 step = boot_profile.now();
+	map = new FlareMap();
 
+	jobs = new JobSystem();
 
-	map = new FlareMap();
+	assets = new AssetLoader();
+	assets->textures = &textures;
+	boot_profile.record("job system + loaders", step);
 
-	SDL_Init(SDL_INIT_VIDEO);
+	step = boot_profile.now();
 	displayWindow = SDL_CreateWindow("Platformer - AFL294@NYU.EDU", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1000, 600, SDL_WINDOW_OPENGL);
 	SDL_GLContext context = SDL_GL_CreateContext(displayWindow);
 	SDL_GL_MakeCurrent(displayWindow, context);
+	//Frames render between sim ticks now, vsync keeps that from spinning
+	SDL_GL_SetSwapInterval(1);
 #ifdef _WINDOWS
 	glewInit();
 #endif
-
-
-
-	font_texture = LoadTexture("resources/font.png", &font_sheet_width, &font_sheet_height);
+	boot_profile.record("window + gl context", step);
 
 
 	glViewport(0, 0, 1000, 600);
 
+	step = boot_profile.now();
+	file_thread.join();
+	boot_profile.record("wait for files", step);
+
+	step = boot_profile.now();
 	tex_program = new ShaderProgram();
 
-	tex_program->Load(RESOURCE_FOLDER"vertex_textured.glsl", RESOURCE_FOLDER"fragment_textured.glsl");
+	tex_program->LoadFromSource(shader_sources[0], shader_sources[1]);
 
 
 	shape_program = new ShaderProgram();
 
-	shape_program->Load(RESOURCE_FOLDER"vertex.glsl", RESOURCE_FOLDER"fragment.glsl");
+	shape_program->LoadFromSource(shader_sources[2], shader_sources[3]);
+
+
+	sdf_program = new ShaderProgram();
+
+	sdf_program->LoadFromSource(shader_sources[0], shader_sources[4]);
+
+	hud_font.upload(textures);
+	boot_profile.record("shader compile + font upload", step);
 
 
 	projectionMatrix.SetOrthoProjection(screen_left, screen_right, screen_bottom, screen_top, -1.0f, 1.0f);
@@ -51,6 +95,13 @@ void App::init(){
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	step = boot_profile.now();
+	audio_thread.join();
+	boot_profile.record("wait for audio", step);
+
+	//Play music
+	music.play("resources/ffx.mp3", 0);
+	boot_profile.record("init total", init_start);
 }
 
 
@@ -61,27 +112,11 @@ float App::get_runtime(){
 }
 
 
-GLuint App::LoadTexture(const char* filePath, float* width, float* height){
-	int w, h, comp;
-	unsigned char* image = stbi_load(filePath, &w, &h, &comp, STBI_rgb_alpha);
-
-	if (image == NULL){
-		std::cout << "Unable to load image. Make sure the path is correct\n";
-		assert(false);
-	}
-
-	*width = w;
-	*height = h;
+TextureManager App::textures;
 
-	GLuint retTexture;
-	glGenTextures(1, &retTexture);
-	glBindTexture(GL_TEXTURE_2D, retTexture);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	stbi_image_free(image);
-	return retTexture;
+GLuint App::LoadTexture(const char* filePath, float* width, float* height){
+	//Cached by path, so per-shot sprites don't keep adding textures
+	return textures.load(filePath, width, height);
 }
 
 std::vector<float> App::quad_verts(float width, float height){
@@ -95,101 +130,80 @@ std::vector<float> App::quad_verts(float width, float height){
 
 
 
-void App::draw_text(std::string text, float x, float y, int fontTexture, float size, float spacing){
-
-
-
-	float texture_size = 1.0 / 16.0f;
-
-	std::vector<float> vertexData;
-	std::vector<float> texCoordData;
-
-	for (int i = 0; i < text.size(); i++){
-		int spriteIndex = (int)text[i];
-		float texture_x = (float)(spriteIndex % 16) / 16.0f;
-		float texture_y = (float)(spriteIndex / 16) / 16.0f;
-
-		vertexData.insert(vertexData.end(), {
-			((spacing * i) + (-0.5f * size)), 0.5f * size,
-			((spacing * i) + (-0.5f * size)), -0.5f * size,
-			((spacing * i) + (0.5f * size)), 0.5f * size,
-			((spacing * i) + (0.5f * size)), -0.5f * size,
-			((spacing * i) + (0.5f * size)), 0.5f * size,
-			((spacing * i) + (-0.5f * size)), -0.5f * size,
-		});
-
-
-		texCoordData.insert(texCoordData.end(), {
-			texture_x, texture_y,
-			texture_x, texture_y + texture_size,
-			texture_x + texture_size, texture_y,
-			texture_x + texture_size, texture_y + texture_size,
-			texture_x + texture_size, texture_y,
-			texture_x, texture_y + texture_size
-		});
-	}
-
-
+void App::batch_draw(int texture_id, std::vector<float>& verts, std::vector<float>& texCoords){
+	tex_program->SetModelMatrix(modelMatrix);
+	tex_program->SetProjectionMatrix(projectionMatrix);
+	tex_program->SetViewMatrix(viewMatrix);
 
 	modelMatrix.Identity();
-	modelMatrix.Translate(x, y, 0);
+	modelMatrix.Translate(0, 0, 0);
 	tex_program->SetModelMatrix(modelMatrix);
-	tex_program->SetProjectionMatrix(projectionMatrix);
 	tex_program->SetViewMatrix(viewMatrix);
+
+	glUseProgram(tex_program->programID);
+
 	glUseProgram(tex_program->programID);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
 	//Draws sprites pixel perfect with no blur
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	glVertexAttribPointer(tex_program->positionAttribute, 2, GL_FLOAT, false, 0, vertexData.data());
+
+	glVertexAttribPointer(tex_program->positionAttribute, 2, GL_FLOAT, false, 0, verts.data());
 	glEnableVertexAttribArray(tex_program->positionAttribute);
 
-	glVertexAttribPointer(tex_program->texCoordAttribute, 2, GL_FLOAT, false, 0, texCoordData.data());
+	glVertexAttribPointer(tex_program->texCoordAttribute, 2, GL_FLOAT, false, 0, texCoords.data());
 	glEnableVertexAttribArray(tex_program->texCoordAttribute);
 
-	glBindTexture(GL_TEXTURE_2D, fontTexture);
-	glDrawArrays(GL_TRIANGLES, 0, text.size() * 6);
+	textures.bind(texture_id);
+	glDrawArrays(GL_TRIANGLES, 0, verts.size() / 2);
 
 	glDisableVertexAttribArray(tex_program->positionAttribute);
 	glDisableVertexAttribArray(tex_program->texCoordAttribute);
 
 }
 
-
-
-
-void App::batch_draw(int texture_id, std::vector<float>& verts, std::vector<float>& texCoords){
-	tex_program->SetModelMatrix(modelMatrix);
+//Same state as above, geometry comes from the mesh's buffers
+void App::batch_draw(int texture_id, TileMesh& mesh){
+	//The mesh sets a model matrix per chunk
 	tex_program->SetProjectionMatrix(projectionMatrix);
 	tex_program->SetViewMatrix(viewMatrix);
 
-	modelMatrix.Identity();
-	modelMatrix.Translate(0, 0, 0);
-	tex_program->SetModelMatrix(modelMatrix);
-	tex_program->SetViewMatrix(viewMatrix);
-
-	glUseProgram(tex_program->programID);
-
 	glUseProgram(tex_program->programID);
+	textures.bind(texture_id);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-	//Draws sprites pixel perfect with no blur
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
+	mesh.upload();
+	mesh.draw(tex_program, origin_tile_x, origin_tile_y, camera.left(), camera.right(), camera.bottom(), camera.top());
+}
 
-	glVertexAttribPointer(tex_program->positionAttribute, 2, GL_FLOAT, false, 0, verts.data());
-	glEnableVertexAttribArray(tex_program->positionAttribute);
+//Baked chunks bind their own textures and set their own model matrix
+void App::batch_draw(TileBake& bake){
+	tex_program->SetProjectionMatrix(projectionMatrix);
+	tex_program->SetViewMatrix(viewMatrix);
 
-	glVertexAttribPointer(tex_program->texCoordAttribute, 2, GL_FLOAT, false, 0, texCoords.data());
-	glEnableVertexAttribArray(tex_program->texCoordAttribute);
+	glUseProgram(tex_program->programID);
+	bake.upload(textures);
+	bake.draw(tex_program, origin_tile_x, origin_tile_y, camera.left(), camera.right(), camera.bottom(), camera.top());
+}
 
-	glBindTexture(GL_TEXTURE_2D, texture_id);
-	glDrawArrays(GL_TRIANGLES, 0, verts.size() / 2);
 
-	glDisableVertexAttribArray(tex_program->positionAttribute);
-	glDisableVertexAttribArray(tex_program->texCoordAttribute);
+void App::draw_debug_overlay(){
+	if (!show_debug_overlay){
+		return;
+	}
 
+	//Fixed to the screen, whatever the camera is doing
+	Matrix screen_view;
+	std::vector<std::string> lines = textures.report(5);
+	std::vector<std::string> systems = scheduler.report();
+	lines.insert(lines.end(), systems.begin(), systems.end());
+	for (int i = 0; i < lines.size(); i++){
+		hud_font.add_text(lines[i], screen_left + 0.2f, screen_top - 0.2f - i * 0.2f, 0.18f);
+	}
+	hud_font.flush(sdf_program, projectionMatrix, screen_view, 1.0f, 1.0f, 0.4f, 1.0f);
 }
 
 float App::radians_to_degrees(float radians) {
@@ -228,18 +242,26 @@ bool App::check_box_collision(GameObject& obj1, GameObject& obj2){
 }
 
 
-
-
-
-void App::play_sound(std::string sound_name){
-	if (sounds.find(sound_name) == sounds.end()){
-		//key not found
-		return;
+//Truncates like the old casts while the origin is at 0; after a rebase positions
+//can be negative relative to it, so those round down
+int App::tile_x(float x){
+	if (origin_tile_x == 0){
+		return (int)(x / tile_world_size);
 	}
-
-	Mix_PlayChannel(-1, sounds[sound_name], 0); //if channel is -1, pick the first free unreserved channel.
+	return origin_tile_x + (int)floorf(x / tile_world_size);
 }
 
+int App::tile_y(float y){
+	if (origin_tile_y == 0){
+		return (int)(-y / tile_world_size);
+	}
+	return origin_tile_y + (int)floorf(-y / tile_world_size);
+}
 
+float App::tile_left(int column){
+	return (column - origin_tile_x) * tile_world_size;
+}
 
-
+float App::tile_top(int row){
+	return -tile_world_size * (row - origin_tile_y);
+}
@@ -21,6 +21,22 @@
 #include "FlareMap.h"
 #include "Vector3.h";
 #include "GroundSpikeScript.h";
+#include "JobSystem.h"
+#include "SdfFont.h"
+#include "AssetLoader.h"
+#include "TextureManager.h"
+#include "StartupProfile.h"
+#include "SoundBank.h"
+#include "MusicStream.h"
+#include "TileMesh.h"
+#include "TileBake.h"
+#include "CollisionMesh.h"
+#include "TileRaycast.h"
+#include "FlowField.h"
+#include "NavGraph.h"
+#include "Camera.h"
+#include "TickScheduler.h"
+#include <thread>
 
 class GameObject;
 
@@ -31,13 +47,19 @@ public:
 	Matrix projectionMatrix;
 	Matrix modelMatrix;
 	Matrix viewMatrix;
+	//World view, applied to viewMatrix once per frame. Its rect culls tiles and sprites.
+	Camera camera;
 	ShaderProgram* tex_program;
 	ShaderProgram* shape_program;
-	GLuint font_texture;
+	ShaderProgram* sdf_program;
 	float elapsed;
+	//Simulation tick. Rendering runs every frame and blends the last two ticks,
+	//so this can go down to 30 Hz to save CPU without motion getting choppier.
+	float sim_timestep = 0.0166666f;
+	float render_alpha = 1.0f; //accumulator / sim_timestep, set before each render
+	//Which systems run on a tick, and what each costs (F3 overlay)
+	TickScheduler scheduler;
 	bool done = false;
-	float font_sheet_width = 0;
-	float font_sheet_height = 0;
 
 	float screen_left = -3.55;
 	float screen_right = 3.55;
@@ -49,20 +71,56 @@ public:
 
 	int TILE_SIZE = 8; //pixel size
 	float tile_world_size = 0.18f;
+	int collision_layer = 3; //layers below it are static decoration
+
+	//Floating origin. Entity positions are floats relative to this tile, so
+	//they stay small however far into a map the player gets; the whole tile
+	//part lives here as ints. Nothing moves until the player is
+	//rebase_distance from the origin, so on the shipped maps it stays at 0
+	//and every result is the same as plain world floats.
+	int origin_tile_x = 0;
+	int origin_tile_y = 0;
+	float rebase_distance = 256.0f;
+
+	//Map column/row under a relative position, what (int)(x / tile_world_size) used to be
+	int tile_x(float x);
+	int tile_y(float y);
+	//Relative position of a column's left edge / a row's top edge
+	float tile_left(int column);
+	float tile_top(int row);
 
 	enum GameMode { STATE_MAIN_MENU, STATE_GAME_LEVEL, STATE_GAME_OVER, STATE_GAME_WON };
 	GameMode mode;
 
 	FlareMap* map;
+	//Collision layer as merged rects, what entities collide against
+	CollisionMesh* collision = NULL;
+	//Walking distances to the player, shared by every ground enemy
+	FlowField* flow = NULL;
+	//Walk, fall and jump edges between platform surfaces, no enemy paths on it yet
+	NavGraph* nav = NULL;
 
+	JobSystem* jobs;
 
+	//Background texture loading, uploads drained each frame
+	AssetLoader* assets;
+	float upload_budget = 0.002f; //seconds of texture uploads per frame
 
+	//Boot step timings, printed after the first frame
+	StartupProfile boot_profile;
 
-	Mix_Music* music1 = NULL;
 
-	std::unordered_map<std::string, Mix_Chunk*> sounds;
 
-	void play_sound(std::string sound_name);
+
+	//Mixer device buffer in sample frames, 1024 is about 23ms at 44.1kHz
+	int sfx_buffer_samples = 1024;
+
+	MusicStream music;
+	float level_crossfade = 1.5f; //seconds, WAV tracks only
+
+	//Effects, resolved to ids when loaded
+	SoundBank sounds;
+	SoundId pain_sound = NO_SOUND;
 
 
 	void init();
@@ -70,15 +128,26 @@ public:
 	float get_runtime();
 
 
-	GLuint LoadTexture(const char* filePath, float* width, float* height);
+	//Static so Sprite(file_path) can load before it has an app
+	static TextureManager textures;
+
+	static GLuint LoadTexture(const char* filePath, float* width, float* height);
 
 	std::vector<float> quad_verts(float width, float height);
 
 
 
-	void draw_text(std::string text, float x, float y, int fontTexture, float size, float spacing);
+	//Scalable font for HUD text, drawn in one batch per flush
+	SdfFont hud_font;
 
 	void batch_draw(int texture_id, std::vector<float>& verts, std::vector<float>& texCoords);
+	//Sends the mesh's pending tile edits first
+	void batch_draw(int texture_id, TileMesh& mesh);
+	void batch_draw(TileBake& bake);
+
+	//F3 in game, texture memory report in screen space
+	bool show_debug_overlay = false;
+	void draw_debug_overlay();
 
 	float radians_to_degrees(float radians);
 
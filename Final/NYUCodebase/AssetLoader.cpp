@@ -0,0 +1,150 @@
+#include "AssetLoader.h"
+#include <iostream>
+#include <algorithm>
+
+AssetLoader::AssetLoader(int worker_count_){
+	completed_head = NULL;
+	pending = 0;
+
+	if (worker_count_ <= 0){
+		worker_count_ = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+		worker_count_ = std::min(worker_count_, 4);
+	}
+
+	for (int x = 0; x < worker_count_; x++){
+		workers.push_back(std::thread(&AssetLoader::worker_loop, this));
+	}
+}
+
+AssetLoader::~AssetLoader(){
+	{
+		std::lock_guard<std::mutex> guard(request_lock);
+		stopping = true;
+	}
+	request_cv.notify_all();
+
+	for (int x = 0; x < workers.size(); x++){
+		workers[x].join();
+	}
+
+	drain_completed();
+}
+
+void AssetLoader::enqueue(const std::shared_ptr<TextureAsset>& texture){
+	pending++;
+	{
+		std::lock_guard<std::mutex> guard(request_lock);
+		requests.push_back(texture);
+	}
+	request_cv.notify_one();
+}
+
+std::shared_ptr<TextureAsset> AssetLoader::load_texture(const std::string& path){
+	std::shared_ptr<TextureAsset> texture = std::make_shared<TextureAsset>();
+	texture->path = path;
+	enqueue(texture);
+	return texture;
+}
+
+int AssetLoader::pending_count(){
+	return pending;
+}
+
+void AssetLoader::worker_loop(){
+	while (true){
+		std::shared_ptr<TextureAsset> request;
+		{
+			std::unique_lock<std::mutex> guard(request_lock);
+			request_cv.wait(guard, [this]{ return stopping || !requests.empty(); });
+			if (stopping){
+				return;
+			}
+			request = requests.front();
+			requests.pop_front();
+		}
+
+		//Read (or cook) here, the GL upload has to happen on the main thread
+		TextureAsset& texture = *request;
+		if (!TextureCooker::load(texture.path, texture.cooked)){
+			texture.failed = true;
+		}
+		else{
+			texture.width = texture.cooked.width;
+			texture.height = texture.cooked.height;
+		}
+		push_completed(request);
+	}
+}
+
+void AssetLoader::push_completed(const std::shared_ptr<TextureAsset>& texture){
+	Completed* node = new Completed();
+	node->texture = texture;
+	node->next = completed_head.load();
+	while (!completed_head.compare_exchange_weak(node->next, node)){
+	}
+}
+
+void AssetLoader::drain_completed(){
+	Completed* node = completed_head.exchange(NULL);
+
+	//The stack is newest first, flip it so uploads go out in completion order
+	std::vector<Completed*> nodes;
+	while (node != NULL){
+		nodes.push_back(node);
+		node = node->next;
+	}
+
+	for (int x = nodes.size() - 1; x >= 0; x--){
+		uploads.push_back(nodes[x]->texture);
+		delete nodes[x];
+	}
+}
+
+void AssetLoader::upload(TextureAsset& texture){
+	if (!texture.failed){
+		if (textures != NULL){
+			texture.texture = textures->upload(texture.path, texture.cooked);
+		}
+		else{
+			texture.texture = TextureCooker::upload(texture.cooked);
+		}
+		texture.cooked.mips.clear();
+	}
+
+	texture.ready = true;
+	pending--;
+}
+
+void AssetLoader::process_uploads(float budget_seconds){
+	drain_completed();
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 budget = (Uint64)(budget_seconds * SDL_GetPerformanceFrequency());
+
+	//Always upload at least one so a tiny budget still makes progress
+	while (!uploads.empty()){
+		std::shared_ptr<TextureAsset> texture = uploads.front();
+		uploads.pop_front();
+		upload(*texture);
+
+		if (SDL_GetPerformanceCounter() - start >= budget){
+			break;
+		}
+	}
+}
+
+void AssetLoader::wait(const std::shared_ptr<TextureAsset>& asset){
+	while (!asset->ready){
+		drain_completed();
+
+		for (int x = 0; x < uploads.size(); x++){
+			if (uploads[x] == asset){
+				uploads.erase(uploads.begin() + x);
+				upload(*asset);
+				return;
+			}
+		}
+
+		std::this_thread::yield();
+	}
+}
@@ -0,0 +1,83 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#include <SDL.h>
+#include <SDL_opengl.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+#include "TextureManager.h"
+
+//Handles returned by AssetLoader. ready flips to true once the asset can be used
+//from the main thread; the other fields must not be read before that.
+struct TextureAsset{
+	std::string path;
+	std::atomic<bool> ready;
+	bool failed = false;
+	GLuint texture = 0;
+	float width = 0;
+	float height = 0;
+
+	CookedTexture cooked; //read on a worker, dropped after the upload
+
+	TextureAsset(){ ready = false; }
+};
+
+//Reads (or cooks) textures on worker threads. Loaded textures go onto a
+//lock-free queue that the main thread drains with process_uploads(), doing
+//the GL uploads under a per-frame time budget. Maps are parsed on the level
+//prefetch thread and sounds decoded on the audio boot thread, not here.
+class AssetLoader{
+public:
+	AssetLoader(int worker_count_ = 0);
+	~AssetLoader();
+
+	std::shared_ptr<TextureAsset> load_texture(const std::string& path);
+
+	//Main thread only. Uploads loaded textures until budget_seconds runs out.
+	void process_uploads(float budget_seconds);
+
+	//Main thread only. Blocks until the asset is ready, uploading as needed.
+	void wait(const std::shared_ptr<TextureAsset>& asset);
+
+	int pending_count();
+
+	//Uploads are registered here when set
+	TextureManager* textures = NULL;
+
+private:
+	//Intrusive lock-free stack, pushed by the workers, emptied in one go by the main thread
+	struct Completed{
+		std::shared_ptr<TextureAsset> texture;
+		Completed* next;
+	};
+	std::atomic<Completed*> completed_head;
+
+	//Drained from completed_head, oldest first, waiting for upload budget
+	std::deque<std::shared_ptr<TextureAsset>> uploads;
+
+	std::vector<std::thread> workers;
+	std::deque<std::shared_ptr<TextureAsset>> requests;
+	std::mutex request_lock;
+	std::condition_variable request_cv;
+	bool stopping = false;
+	std::atomic<int> pending;
+
+	void worker_loop();
+	void push_completed(const std::shared_ptr<TextureAsset>& texture);
+	void drain_completed();
+	void upload(TextureAsset& texture);
+	void enqueue(const std::shared_ptr<TextureAsset>& texture);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "Camera.h"
+#include <math.h>
+
+void Camera::set_size(float width, float height){
+	half_width = width / 2;
+	half_height = height / 2;
+}
+
+void Camera::set_bounds(float left, float right, float bottom, float top){
+	bounded = true;
+	bound_left = left;
+	bound_right = right;
+	bound_bottom = bottom;
+	bound_top = top;
+	clamp();
+}
+
+void Camera::follow(float target_x, float target_y, float elapsed){
+	previous_x = x;
+	previous_y = y;
+	target_x += offset_x;
+	target_y += offset_y;
+
+	//Nearest centre that puts the target back inside the dead zone
+	float goal_x = x;
+	float goal_y = y;
+	float zone_x = dead_zone_width / 2;
+	float zone_y = dead_zone_height / 2;
+	if (target_x > x + zone_x){
+		goal_x = target_x - zone_x;
+	}
+	else if (target_x < x - zone_x){
+		goal_x = target_x + zone_x;
+	}
+	if (target_y > y + zone_y){
+		goal_y = target_y - zone_y;
+	}
+	else if (target_y < y - zone_y){
+		goal_y = target_y + zone_y;
+	}
+
+	//Exponential, so the same fraction of the gap closes per second at any tick rate
+	float t = follow_rate > 0 ? 1.0f - expf(-follow_rate * elapsed) : 1.0f;
+	x += (goal_x - x) * t;
+	y += (goal_y - y) * t;
+	clamp();
+}
+
+void Camera::snap(float target_x, float target_y){
+	x = target_x + offset_x;
+	y = target_y + offset_y;
+	clamp();
+	previous_x = x;
+	previous_y = y;
+}
+
+void Camera::shift(float dx, float dy){
+	x += dx;
+	y += dy;
+	previous_x += dx;
+	previous_y += dy;
+	bound_left += dx;
+	bound_right += dx;
+	bound_bottom += dy;
+	bound_top += dy;
+}
+
+void Camera::clamp(){
+	if (!bounded){
+		return;
+	}
+
+	if (bound_right - bound_left <= half_width * 2){
+		x = (bound_left + bound_right) / 2;
+	}
+	else if (x - half_width < bound_left){
+		x = bound_left + half_width;
+	}
+	else if (x + half_width > bound_right){
+		x = bound_right - half_width;
+	}
+
+	if (bound_top - bound_bottom <= half_height * 2){
+		y = (bound_bottom + bound_top) / 2;
+	}
+	else if (y - half_height < bound_bottom){
+		y = bound_bottom + half_height;
+	}
+	else if (y + half_height > bound_top){
+		y = bound_top - half_height;
+	}
+}
+
+void Camera::apply(Matrix& view, float alpha) const{
+	view.Identity();
+	view.Translate(-(previous_x + (x - previous_x) * alpha), -(previous_y + (y - previous_y) * alpha), 0);
+}
+
+float Camera::left() const{
+	return x - half_width;
+}
+
+float Camera::right() const{
+	return x + half_width;
+}
+
+float Camera::bottom() const{
+	return y - half_height;
+}
+
+float Camera::top() const{
+	return y + half_height;
+}
+
+bool Camera::visible(float cx, float cy, float width, float height) const{
+	return fabsf(cx - x) <= half_width + width / 2 + cull_margin &&
+		fabsf(cy - y) <= half_height + height / 2 + cull_margin;
+}
@@ -0,0 +1,61 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include "Matrix.h"
+
+//2D follow camera. The target can move around a dead zone in the middle of
+//the screen without moving the view; past its edge the camera eases after
+//it at follow_rate, independent of the tick rate, and stays inside the
+//bounds. Positions are in the same (origin relative) space as entities.
+//
+//follow() runs on the sim tick, apply() builds the view once per frame,
+//blending from where the last tick left the camera like entities do.
+class Camera{
+public:
+	float x = 0; //centre
+	float y = 0;
+	float half_width = 3.55f;
+	float half_height = 2.0f;
+
+	float dead_zone_width = 0.8f;
+	float dead_zone_height = 1.0f;
+	float follow_rate = 8.0f; //per second, 0 snaps to the dead zone edge
+	float offset_x = 0; //added to the target, to look ahead or below
+	float offset_y = 0;
+	float cull_margin = 0.5f; //visible() pads the view by this much
+
+	void set_size(float width, float height);
+	//Edges the view stays inside. A view bigger than the bounds centres on them.
+	void set_bounds(float left, float right, float bottom, float top);
+
+	void follow(float target_x, float target_y, float elapsed);
+	//Straight to the target, for spawns and level loads
+	void snap(float target_x, float target_y);
+	//Moves with the world when the origin is rebased
+	void shift(float dx, float dy);
+
+	//Identity, then the camera translation, alpha of the way from the previous tick
+	void apply(Matrix& view, float alpha = 1.0f) const;
+
+	//Visible world rect
+	float left() const;
+	float right() const;
+	float bottom() const;
+	float top() const;
+	//Centre and size, like GameObject. Padded by cull_margin.
+	bool visible(float cx, float cy, float width, float height) const;
+
+private:
+	float previous_x = 0;
+	float previous_y = 0;
+
+	bool bounded = false;
+	float bound_left = 0;
+	float bound_right = 0;
+	float bound_bottom = 0;
+	float bound_top = 0;
+
+	void clamp();
+};
+
+#endif
@@ -0,0 +1,186 @@
+#include "CollisionMesh.h"
+#include <algorithm>
+#include <math.h>
+
+void CollisionMesh::build(const FlareMap& map, int layer, float tile_size_){
+	tile_size = tile_size_;
+	width = map.mapWidth;
+	height = map.mapHeight;
+	rects.clear();
+	solid_tile_count = 0;
+
+	//Widest run first, then grow it down while the whole run stays solid
+	std::vector<bool> used(width * height, false);
+	unsigned int** tiles = map.layers[layer];
+	for (int y = 0; y < height; y++){
+		for (int x = 0; x < width; x++){
+			if (tiles[y][x] == 0 || used[y * width + x]){
+				continue;
+			}
+
+			int run = 1;
+			while (x + run < width && tiles[y][x + run] != 0 && !used[y * width + x + run]){
+				run++;
+			}
+
+			int rows = 1;
+			while (y + rows < height){
+				bool solid = true;
+				for (int i = 0; i < run && solid; i++){
+					solid = tiles[y + rows][x + i] != 0 && !used[(y + rows) * width + x + i];
+				}
+				if (!solid){
+					break;
+				}
+				rows++;
+			}
+
+			for (int j = 0; j < rows; j++){
+				for (int i = 0; i < run; i++){
+					used[(y + j) * width + x + i] = true;
+				}
+			}
+			rects.push_back({ x, y, run, rows });
+			solid_tile_count += run * rows;
+		}
+	}
+
+	cells_wide = (width + cell_tiles - 1) / cell_tiles;
+	cells_high = (height + cell_tiles - 1) / cell_tiles;
+	cells.assign(cells_wide * cells_high, std::vector<int>());
+	free_rects.clear();
+	for (int i = 0; i < rects.size(); i++){
+		const CollisionRect& r = rects[i];
+		for (int cy = r.y / cell_tiles; cy <= (r.y + r.height - 1) / cell_tiles; cy++){
+			for (int cx = r.x / cell_tiles; cx <= (r.x + r.width - 1) / cell_tiles; cx++){
+				cells[cy * cells_wide + cx].push_back(i);
+			}
+		}
+	}
+}
+
+int CollisionMesh::find_rect(int x, int y) const{
+	const std::vector<int>& cell = cells[(y / cell_tiles) * cells_wide + x / cell_tiles];
+	for (int i = 0; i < cell.size(); i++){
+		const CollisionRect& r = rects[cell[i]];
+		if (x >= r.x && x < r.x + r.width && y >= r.y && y < r.y + r.height){
+			return cell[i];
+		}
+	}
+	return -1;
+}
+
+void CollisionMesh::add_rect(const CollisionRect& r){
+	int index;
+	if (free_rects.empty()){
+		index = rects.size();
+		rects.push_back(r);
+	}
+	else{
+		index = free_rects.back();
+		free_rects.pop_back();
+		rects[index] = r;
+	}
+
+	for (int cy = r.y / cell_tiles; cy <= (r.y + r.height - 1) / cell_tiles; cy++){
+		for (int cx = r.x / cell_tiles; cx <= (r.x + r.width - 1) / cell_tiles; cx++){
+			cells[cy * cells_wide + cx].push_back(index);
+		}
+	}
+	solid_tile_count += r.width * r.height;
+}
+
+void CollisionMesh::remove_rect(int index){
+	const CollisionRect& r = rects[index];
+	for (int cy = r.y / cell_tiles; cy <= (r.y + r.height - 1) / cell_tiles; cy++){
+		for (int cx = r.x / cell_tiles; cx <= (r.x + r.width - 1) / cell_tiles; cx++){
+			std::vector<int>& cell = cells[cy * cells_wide + cx];
+			cell.erase(std::find(cell.begin(), cell.end(), index));
+		}
+	}
+	solid_tile_count -= r.width * r.height;
+
+	CollisionRect empty = { 0, 0, 0, 0 };
+	rects[index] = empty;
+	free_rects.push_back(index);
+}
+
+void CollisionMesh::set_tile(int x, int y, bool solid){
+	if (x < 0 || x >= width || y < 0 || y >= height){
+		return;
+	}
+
+	int index = find_rect(x, y);
+	if (solid){
+		if (index < 0){
+			add_rect({ x, y, 1, 1 });
+		}
+		return;
+	}
+	if (index < 0){
+		return;
+	}
+
+	//Full width bands above and below the tile's row, then what's left of the row either side of it
+	CollisionRect r = rects[index];
+	remove_rect(index);
+	if (y > r.y){
+		add_rect({ r.x, r.y, r.width, y - r.y });
+	}
+	if (y + 1 < r.y + r.height){
+		add_rect({ r.x, y + 1, r.width, r.y + r.height - y - 1 });
+	}
+	if (x > r.x){
+		add_rect({ r.x, y, x - r.x, 1 });
+	}
+	if (x + 1 < r.x + r.width){
+		add_rect({ x + 1, y, r.x + r.width - x - 1, 1 });
+	}
+}
+
+void CollisionMesh::query_box(float min_x, float min_y, float max_x, float max_y, std::vector<int>& out, int origin_x, int origin_y) const{
+	out.clear();
+	if (rects.empty()){
+		return;
+	}
+
+	//Tiles from the origin, rows grow downwards
+	float left = min_x / tile_size;
+	float right = max_x / tile_size;
+	float top = -max_y / tile_size;
+	float bottom = -min_y / tile_size;
+
+	int last_tile_x = origin_x + (int)floorf(right);
+	int last_tile_y = origin_y + (int)floorf(bottom);
+	if (last_tile_x < 0 || last_tile_y < 0){
+		return;
+	}
+
+	int first_tile_x = origin_x + (int)floorf(left);
+	int first_tile_y = origin_y + (int)floorf(top);
+	int first_cx = std::max(0, first_tile_x / cell_tiles);
+	int last_cx = std::min(cells_wide - 1, last_tile_x / cell_tiles);
+	int first_cy = std::max(0, first_tile_y / cell_tiles);
+	int last_cy = std::min(cells_high - 1, last_tile_y / cell_tiles);
+
+	for (int cy = first_cy; cy <= last_cy; cy++){
+		for (int cx = first_cx; cx <= last_cx; cx++){
+			const std::vector<int>& cell = cells[cy * cells_wide + cx];
+			for (int i = 0; i < cell.size(); i++){
+				const CollisionRect& r = rects[cell[i]];
+				float rect_left = (float)(r.x - origin_x);
+				float rect_top = (float)(r.y - origin_y);
+				if (rect_left >= right || rect_left + r.width <= left || rect_top >= bottom || rect_top + r.height <= top){
+					continue;
+				}
+
+				//Rects spanning cells show up in each. Only the cell holding the
+				//overlap's top left tile reports it, so no search through out.
+				if (std::max(r.x, first_tile_x) / cell_tiles != cx || std::max(r.y, first_tile_y) / cell_tiles != cy){
+					continue;
+				}
+				out.push_back(cell[i]);
+			}
+		}
+	}
+}
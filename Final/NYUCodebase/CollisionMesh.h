@@ -0,0 +1,61 @@
+#ifndef COLLISIONMESH_H
+#define COLLISIONMESH_H
+
+#include <vector>
+#include "FlareMap.h"
+
+//A run of solid tiles merged into one box, in tiles
+struct CollisionRect{
+	int x;
+	int y; //top row, rows grow downwards like the map
+	int width;
+	int height;
+};
+
+//The collision layer merged greedily into maximal rectangles at load time
+//and bucketed into a uniform grid, so level queries test a few boxes
+//instead of every tile they pass over. Runtime edits patch only the rect
+//and cells around the tile. World space follows the collision
+//code: tile x, y covers [x, x+1] * tile_size horizontally and
+//[-(y+1), -y] * tile_size vertically.
+class CollisionMesh{
+public:
+	int cell_tiles = 8; //grid cell edge in tiles
+
+	//CPU only, safe on the prefetch thread
+	void build(const FlareMap& map, int layer, float tile_size);
+
+	//Runtime edit, seen by the next query. Clearing a tile splits the rect
+	//holding it into up to four, filling one adds a 1x1 rect, so the cost
+	//is the cells of that one rect. Not while other threads query.
+	void set_tile(int x, int y, bool solid);
+
+	//Rects overlapping the box, each at most once. The box is relative to
+	//tile origin_x, origin_y (App's floating origin) and the overlap test
+	//stays in those small numbers. Reads only, safe from any thread.
+	void query_box(float min_x, float min_y, float max_x, float max_y, std::vector<int>& out, int origin_x = 0, int origin_y = 0) const;
+
+	//Rects removed by set_tile stay as 0x0 until a later edit reuses the index
+	const CollisionRect& rect(int index) const { return rects[index]; }
+	int rect_count() const { return rects.size(); }
+	int solid_tiles() const { return solid_tile_count; }
+
+private:
+	float tile_size = 0.18f;
+	int width = 0;
+	int height = 0;
+	int solid_tile_count = 0;
+	std::vector<CollisionRect> rects;
+	std::vector<int> free_rects;
+
+	//Rects overlapping each grid cell, row major
+	int cells_wide = 0;
+	int cells_high = 0;
+	std::vector<std::vector<int>> cells;
+
+	int find_rect(int x, int y) const;
+	void add_rect(const CollisionRect& r);
+	void remove_rect(int index);
+};
+
+#endif
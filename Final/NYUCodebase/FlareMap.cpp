@@ -13,9 +13,9 @@ FlareMap::FlareMap() {
 
 FlareMap::~FlareMap() {
 	for (int i = 0; i < mapHeight; i++) {
-		delete mapData[i];
+		delete[] mapData[i];
 	}
-	delete mapData;
+	delete[] mapData;
 }
 
 bool FlareMap::ReadHeader(std::ifstream &stream) {
@@ -135,4 +135,18 @@ void FlareMap::Load(const std::string fileName) {
 			ReadEntityData(infile);
 		}
 	}
-}
\ No newline at end of file
+}
+unsigned int FlareMap::GetTile(int layer, int x, int y) const {
+	if (layer < 0 || layer >= layers.size() || x < 0 || x >= mapWidth || y < 0 || y >= mapHeight) {
+		return 0;
+	}
+	return layers[layer][y][x];
+}
+
+bool FlareMap::SetTile(int layer, int x, int y, unsigned int tile) {
+	if (layer < 0 || layer >= layers.size() || x < 0 || x >= mapWidth || y < 0 || y >= mapHeight) {
+		return false;
+	}
+	layers[layer][y][x] = tile;
+	return true;
+}
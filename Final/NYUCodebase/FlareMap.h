@@ -16,6 +16,10 @@ public:
 
 	void Load(const std::string fileName);
 
+	//Out of range reads as empty, out of range writes return false
+	unsigned int GetTile(int layer, int x, int y) const;
+	bool SetTile(int layer, int x, int y, unsigned int tile);
+
 	int mapWidth;
 	int mapHeight;
 	unsigned int **mapData;
@@ -0,0 +1,310 @@
+#include "FlowField.h"
+#include <math.h>
+
+const unsigned short FlowField::UNREACHED;
+
+void FlowField::build(const FlareMap& map, int layer_, float tile_size_){
+	width = map.mapWidth;
+	height = map.mapHeight;
+	tile_size = tile_size_;
+	layer = layer_;
+	dirty_tiles.clear();
+
+	unsigned int** tiles = map.layers[layer];
+	walkable.assign(width * height, false);
+	for (int y = 0; y + 1 < height; y++){
+		for (int x = 0; x < width; x++){
+			walkable[y * width + x] = tiles[y][x] == 0 && tiles[y + 1][x] != 0;
+		}
+	}
+
+	distances.assign(width * height, UNREACHED);
+	steps.assign(width * height, 4);
+	back_distances.assign(width * height, UNREACHED);
+	back_steps.assign(width * height, 4);
+	front_valid = false;
+	searching = false;
+
+	//Force the next set_target to search the new layout
+	int last_target = target;
+	target = -1;
+	if (last_target >= 0 && last_target < walkable.size() && walkable[last_target]){
+		start_search(last_target);
+		target = last_target;
+	}
+}
+
+int FlowField::cell_at(float x, float y, int origin_x, int origin_y) const{
+	int tile_x = origin_x + (int)floorf(x / tile_size);
+	int tile_y = origin_y + (int)floorf(-y / tile_size);
+	if (tile_x < 0 || tile_x >= width || tile_y < 0 || tile_y >= height){
+		return -1;
+	}
+	return tile_y * width + tile_x;
+}
+
+void FlowField::set_target(float x, float y, int origin_x, int origin_y){
+	int cell = cell_at(x, y, origin_x, origin_y);
+	if (cell < 0){
+		return;
+	}
+
+	//In the air, target the cell that would be landed on
+	while (!walkable[cell] && cell + width < width * height){
+		cell += width;
+	}
+	if (!walkable[cell] || cell == target){
+		return;
+	}
+
+	target = cell;
+	start_search(cell);
+}
+
+void FlowField::start_search(int cell){
+	std::fill(back_distances.begin(), back_distances.end(), UNREACHED);
+	frontier.clear();
+	frontier_head = 0;
+	frontier.push_back(cell);
+	back_distances[cell] = 0;
+	back_steps[cell] = 4;
+	searching = true;
+}
+
+void FlowField::update(){
+	if (!searching){
+		return;
+	}
+
+	expand(cells_per_tick > 0 ? cells_per_tick : width * height);
+	if (frontier_head == frontier.size()){
+		//Done, agents switch to the new field
+		distances.swap(back_distances);
+		steps.swap(back_steps);
+		front_valid = true;
+		searching = false;
+		searches++;
+		last_search_cells = frontier.size();
+	}
+}
+
+//Unit cost everywhere, so a FIFO frontier visits cells in distance order
+void FlowField::expand(int budget){
+	for (int i = 0; i < budget && frontier_head < frontier.size(); i++){
+		int cell = frontier[frontier_head++];
+		int x = cell % width;
+		int y = cell / width;
+		unsigned short next_distance = back_distances[cell] + 1;
+
+		for (int dx = -1; dx <= 1; dx += 2){
+			int nx = x + dx;
+			if (nx < 0 || nx >= width){
+				continue;
+			}
+			//Level, one tile up, one tile down
+			for (int dy = -1; dy <= 1; dy++){
+				int ny = y + dy;
+				if (ny < 0 || ny >= height){
+					continue;
+				}
+
+				int neighbour = ny * width + nx;
+				if (!walkable[neighbour] || back_distances[neighbour] != UNREACHED){
+					continue;
+				}
+
+				back_distances[neighbour] = next_distance;
+				//The neighbour steps back toward this cell
+				back_steps[neighbour] = (signed char)((-dx + 1) * 3 + (-dy + 1));
+				frontier.push_back(neighbour);
+			}
+		}
+	}
+}
+
+void FlowField::invalidate_tile(int x, int y){
+	dirty_tiles.push_back(x);
+	dirty_tiles.push_back(y);
+}
+
+//The cell steps[cell] points at
+int FlowField::step_to(int cell) const{
+	return cell + (steps[cell] / 3 - 1) + (steps[cell] % 3 - 1) * width;
+}
+
+//Best finished neighbour plus one, same moves as expand
+void FlowField::relax_from_neighbours(int cell){
+	int x = cell % width;
+	int y = cell / width;
+	for (int dx = -1; dx <= 1; dx += 2){
+		for (int dy = -1; dy <= 1; dy++){
+			int nx = x + dx;
+			int ny = y + dy;
+			if (nx < 0 || nx >= width || ny < 0 || ny >= height){
+				continue;
+			}
+
+			int neighbour = ny * width + nx;
+			if (distances[neighbour] != UNREACHED && distances[neighbour] + 1 < distances[cell]){
+				distances[cell] = distances[neighbour] + 1;
+				steps[cell] = (signed char)((dx + 1) * 3 + (dy + 1));
+			}
+		}
+	}
+}
+
+int FlowField::repair(const FlareMap& map){
+	if (dirty_tiles.empty()){
+		return 0;
+	}
+
+	//A tile decides whether its own cell and the one above it can be stood in
+	unsigned int** tiles = map.layers[layer];
+	std::vector<int> changed;
+	for (int i = 0; i < dirty_tiles.size(); i += 2){
+		int x = dirty_tiles[i];
+		for (int y = dirty_tiles[i + 1] - 1; y <= dirty_tiles[i + 1]; y++){
+			if (x < 0 || x >= width || y < 0 || y + 1 >= height){
+				continue;
+			}
+			int cell = y * width + x;
+			bool now = tiles[y][x] == 0 && tiles[y + 1][x] != 0;
+			if (now != walkable[cell]){
+				walkable[cell] = now;
+				changed.push_back(cell);
+			}
+		}
+	}
+	dirty_tiles.clear();
+	if (changed.empty()){
+		return 0;
+	}
+
+	//A search still filling the back buffer started from the old layout
+	if (searching){
+		start_search(target);
+	}
+	if (target >= 0 && !walkable[target]){
+		//Nothing to route to, the next set_target searches from scratch
+		target = -1;
+		front_valid = false;
+		searching = false;
+		return 0;
+	}
+	if (!front_valid){
+		return 0;
+	}
+
+	//Cells that stopped being walkable, then everything whose steps ran through them
+	cleared.clear();
+	for (int i = 0; i < changed.size(); i++){
+		if (!walkable[changed[i]] && distances[changed[i]] != UNREACHED){
+			distances[changed[i]] = UNREACHED;
+			cleared.push_back(changed[i]);
+		}
+	}
+	for (int i = 0; i < cleared.size(); i++){
+		int x = cleared[i] % width;
+		int y = cleared[i] / width;
+		for (int dx = -1; dx <= 1; dx += 2){
+			for (int dy = -1; dy <= 1; dy++){
+				int nx = x + dx;
+				int ny = y + dy;
+				if (nx < 0 || nx >= width || ny < 0 || ny >= height){
+					continue;
+				}
+
+				int neighbour = ny * width + nx;
+				if (distances[neighbour] != UNREACHED && step_to(neighbour) == cleared[i]){
+					distances[neighbour] = UNREACHED;
+					cleared.push_back(neighbour);
+				}
+			}
+		}
+	}
+
+	//Seeds: cleared cells that can still be stood in, and newly walkable ones
+	repair_queue.clear();
+	for (int i = 0; i < cleared.size(); i++){
+		if (walkable[cleared[i]]){
+			relax_from_neighbours(cleared[i]);
+			if (distances[cleared[i]] != UNREACHED){
+				repair_queue.push_back(cleared[i]);
+			}
+		}
+	}
+	for (int i = 0; i < changed.size(); i++){
+		if (walkable[changed[i]]){
+			relax_from_neighbours(changed[i]);
+			if (distances[changed[i]] != UNREACHED){
+				repair_queue.push_back(changed[i]);
+			}
+		}
+	}
+
+	//Seeds start at different distances, so a cell can shorten more than once before it settles
+	int visited = 0;
+	for (int head = 0; head < repair_queue.size(); head++){
+		int cell = repair_queue[head];
+		int x = cell % width;
+		int y = cell / width;
+		unsigned short next_distance = distances[cell] + 1;
+		visited++;
+
+		for (int dx = -1; dx <= 1; dx += 2){
+			for (int dy = -1; dy <= 1; dy++){
+				int nx = x + dx;
+				int ny = y + dy;
+				if (nx < 0 || nx >= width || ny < 0 || ny >= height){
+					continue;
+				}
+
+				int neighbour = ny * width + nx;
+				if (!walkable[neighbour] || distances[neighbour] <= next_distance){
+					continue;
+				}
+
+				distances[neighbour] = next_distance;
+				steps[neighbour] = (signed char)((-dx + 1) * 3 + (-dy + 1));
+				repair_queue.push_back(neighbour);
+			}
+		}
+	}
+
+	last_repair_cells = cleared.size() + visited;
+	return last_repair_cells;
+}
+
+bool FlowField::direction(float x, float y, int* step_x, int* step_y, int origin_x, int origin_y) const{
+	if (!front_valid){
+		return false;
+	}
+
+	int cell = cell_at(x, y, origin_x, origin_y);
+	if (cell < 0){
+		return false;
+	}
+	//Agents centred a little above or inside their standing cell
+	if (!walkable[cell] && cell + width < width * height && walkable[cell + width]){
+		cell += width;
+	}
+	if (distances[cell] == UNREACHED){
+		return false;
+	}
+
+	*step_x = steps[cell] / 3 - 1;
+	//Rows grow downwards, world y up
+	*step_y = -(steps[cell] % 3 - 1);
+	return true;
+}
+
+int FlowField::distance(float x, float y, int origin_x, int origin_y) const{
+	int cell = cell_at(x, y, origin_x, origin_y);
+	if (!front_valid || cell < 0){
+		return -1;
+	}
+	if (!walkable[cell] && cell + width < width * height && walkable[cell + width]){
+		cell += width;
+	}
+	return distances[cell] == UNREACHED ? -1 : distances[cell];
+}
@@ -0,0 +1,82 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include <vector>
+#include "FlareMap.h"
+
+//Breadth first distance map over the cells a ground walker can stand in
+//(empty, solid underneath), flowing toward one target cell. Walkers move
+//sideways, stepping up or down one tile. Each cell stores the step toward
+//the target, so following the field is a lookup per agent per tick no
+//matter how many agents there are.
+//
+//A new search only starts when the target changes cell. It fills a back
+//buffer, optionally a budget of cells per tick, while agents keep reading
+//the last finished field; the buffers swap when the search completes.
+//
+//Map edits don't restart the search. repair() clears the distances that
+//routed through cells which stopped being walkable, then searches outward
+//from the edited cells and the cleared ones until nothing gets shorter.
+class FlowField{
+public:
+	int cells_per_tick = 0; //search budget, 0 finishes in one call
+
+	//CPU only, safe on the prefetch thread
+	void build(const FlareMap& map, int layer, float tile_size);
+	//After a collision edit at tile x, y; the repair waits for repair()
+	void invalidate_tile(int x, int y);
+	//Main thread. Patches the field around the edited tiles, returns the cells it visited.
+	int repair(const FlareMap& map);
+
+	//Positions below are relative to tile origin_x, origin_y (App's floating
+	//origin), like CollisionMesh::query_box.
+
+	//Position of the target. Snaps down to the cell it stands on.
+	void set_target(float x, float y, int origin_x = 0, int origin_y = 0);
+	//Main thread, once per tick before agents read the field
+	void update();
+
+	//Step toward the target from the position. False when there is no
+	//finished field or no path from here. Safe from any thread between updates.
+	bool direction(float x, float y, int* step_x, int* step_y, int origin_x = 0, int origin_y = 0) const;
+	//Steps to the target, -1 when unreachable
+	int distance(float x, float y, int origin_x = 0, int origin_y = 0) const;
+
+	int searches = 0; //completed
+	int last_search_cells = 0; //cells visited by the last completed search
+	int last_repair_cells = 0;
+
+private:
+	static const unsigned short UNREACHED = 0xFFFF;
+
+	int width = 0;
+	int height = 0;
+	float tile_size = 0.18f;
+	int layer = 3;
+	std::vector<bool> walkable;
+
+	int target = -1; //cell index
+
+	//Front is what agents read, back is being filled
+	std::vector<unsigned short> distances;
+	std::vector<signed char> steps; //packed (step_x + 1) * 3 + (step_y + 1)
+	std::vector<unsigned short> back_distances;
+	std::vector<signed char> back_steps;
+	bool front_valid = false;
+
+	std::vector<int> frontier;
+	int frontier_head = 0;
+	bool searching = false;
+
+	std::vector<int> dirty_tiles; //x, y pairs
+	std::vector<int> cleared; //repair scratch
+	std::vector<int> repair_queue;
+
+	int cell_at(float x, float y, int origin_x, int origin_y) const;
+	void start_search(int cell);
+	void expand(int budget);
+	int step_to(int cell) const;
+	void relax_from_neighbours(int cell);
+};
+
+#endif
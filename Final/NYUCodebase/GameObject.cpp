@@ -33,9 +33,12 @@ void GameObject::set_name(const std::string& str_){
 }
 
 
+//Teleports, nothing to blend from
 void GameObject::set_pos(float x, float y){
 	pos.x = x;
 	pos.y = y;
+	previous_pos.x = x;
+	previous_pos.y = y;
 }
 
 void GameObject::destroy(){
@@ -58,8 +61,8 @@ float GameObject::timeAlive(){
 }
 
 void GameObject::add_animation(const std::string& animation_name, int animation_count){
-	Animation run_animation(name + "_" + animation_name, animation_count);
-	run_animation.set_app(app);
+	std::shared_ptr<Animation> run_animation = std::make_shared<Animation>(name + "_" + animation_name, animation_count);
+	run_animation->set_app(app);
 	animations[animation_name] = run_animation;
 	
 }
@@ -67,12 +70,21 @@ void GameObject::add_animation(const std::string& animation_name, int animation_
 
 void GameObject::add_animation(const std::string& animation_name, Animation animation){
 	animation.set_app(app);
+	animations[animation_name] = std::make_shared<Animation>(animation);
+}
+
+void GameObject::add_animation(const std::string& animation_name, std::shared_ptr<Animation> animation){
 	animations[animation_name] = animation;
 }
 
+//Restarts only when the clip changes, so calling it every tick is fine
 void GameObject::set_animation(const std::string& animation_name){
 	current_animation_name = animation_name;
-	animations[current_animation_name].reset();
+	Animation* clip = get_current_animation();
+	if (clip != NULL && clip == animator.clip){
+		return;
+	}
+	animator.play(clip);
 }
 
 void GameObject::move_y(float delta_y){
@@ -146,234 +158,6 @@ void GameObject::worldToTileCoord(float worldX, float worldY, int* gridX, int* g
 }
 
 
-int GameObject::colliding_bottom(){
-	//Check for collision on feet with ground
-	float test_x = x();
-	float test_y = y() - height() / 2;
-
-	int grid_x = (int)(test_x / app->tile_world_size);
-	int grid_y = (int)(-(test_y) / app->tile_world_size);
-
-
-	//layer index 3 = platform
-	//worldToTileCoord(x(), y() + (0.1f), &grid_x, &grid_y);
-	try{
-		int data = app->map->layers[3][grid_y][grid_x];
-		if (data > 0){
-			last_grid_x = grid_x;
-			last_grid_y = grid_y;
-			return data;
-		}
-	}
-	catch (std::exception& e){
-		std::cout << e.what() << std::endl;
-		return 0;
-	}
-
-	/////////
-	grid_x = (int)(test_x / app->tile_world_size) - 1;
-	try{
-		int data = app->map->layers[3][grid_y][grid_x];
-		if (data > 0){
-			last_grid_x = grid_x;
-			last_grid_y = grid_y;
-			return data;
-		}
-	}
-	catch (std::exception& e){
-		std::cout << e.what() << std::endl;
-		return 0;
-	}
-	//////////////////////
-	grid_x = (int)(test_x / app->tile_world_size) + 1;
-	try{
-		int data = app->map->layers[3][grid_y][grid_x];
-		if (data > 0){
-			last_grid_x = grid_x;
-			last_grid_y = grid_y;
-			return data;
-		}
-	}
-	catch (std::exception& e){
-		std::cout << e.what() << std::endl;
-		return 0;
-	}
-
-
-
-	return 0;
-}
-
-bool GameObject::is_colliding_bottom(){
-	int col_data = colliding_bottom();
-	if (col_data > 0){
-		return true;
-	}
-	else{
-		return false;
-	}
-}
-
-
-
-bool GameObject::colliding_directly_left(){
-	//Prevent object from going off left side of screen
-	if (x() - (width() / 2) < 0.1){
-		return true;
-	}
-
-
-	bool col_left = false;
-
-	int grid_x_3 = (int)((x() - (width() / 2)) / 0.18f);
-	int grid_y_3 = (int)(-(y()) / 0.18f);
-	int data3 = app->map->layers[3][grid_y_3][grid_x_3];
-
-
-	if (data3 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		//pos.x -= (x() - width() / 2) - ((app->tile_world_size * grid_x_3) + app->tile_world_size);
-		acceleration.x = 0;
-		//velocity.x = 0;
-		col_left = true;
-	}
-	
-
-	return col_left;
-}
-
-
-
-bool GameObject::colliding_directly_right(){
-	//Prevent object from going off right side of screen
-	if (x() + (width() / 2) > (app->map->mapWidth * app->tile_world_size) - 0.2f){
-		//pos.x = (app->map->mapWidth * app->tile_world_size) - (width() / 2);
-		return true;
-	}
-
-	bool col_right = false;
-
-	//Check for collision on right:
-	int grid_x_4 = (int)((x() + (width() / 2)) / 0.18f);
-	int grid_y_4 = (int)(-(y()) / 0.18f);
-	int data4 = app->map->layers[3][grid_y_4][grid_x_4];
-
-	if (data4 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		acceleration.x = 0;
-		//velocity.x = 0;
-		//pos.x -= fabs((x() + width() / 2) - ((app->tile_world_size * grid_x_4)));
-		col_right = true;
-	}
-
-
-	return col_right;
-}
-
-bool GameObject::colliding_left(){
-	//Prevent object from going off left side of screen
-	if (x() - (width() / 2) < 0){
-		pos.x = 0 + width() / 2;
-		return true;
-	}
-
-
-	int grid_x_3 = (int)((x() - (width() / 2)) / 0.18f);
-	int grid_y_3 = (int)(-(y()) / 0.18f);
-	int data3 = app->map->layers[3][grid_y_3][grid_x_3];
-	collidedLeft = false;
-
-	if (data3 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		pos.x -= (x() - width() / 2) - ((app->tile_world_size * grid_x_3) + app->tile_world_size);
-		acceleration.x = 0;
-		//velocity.x = 0;
-		collidedLeft = true;
-	}
-
-
-	//Collision on left upper
-	grid_y_3 = (int)(-(y()) / 0.18f) + 1;
-	data3 = app->map->layers[3][grid_y_3][grid_x_3];
-
-	if (data3 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		pos.x -= (x() - width() / 2) - ((app->tile_world_size * grid_x_3) + app->tile_world_size);
-		acceleration.x = 0;
-		//velocity.x = 0;
-		collidedLeft = true;
-	}
-
-
-	//Collision on left lower
-	grid_y_3 = (int)(-(y()) / 0.18f) - 1;
-	data3 = app->map->layers[3][grid_y_3][grid_x_3];
-
-	if (data3 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		pos.x -= (x() - width() / 2) - ((app->tile_world_size * grid_x_3) + app->tile_world_size);
-		acceleration.x = 0;
-		//velocity.x = 0;
-		collidedLeft = true;
-	}
-
-	return collidedLeft;
-}
-
-
-bool GameObject::colliding_right(){
-	//Prevent object from going off right side of screen
-	if (x() + (width() / 2) > app->map->mapWidth * app->tile_world_size){
-		pos.x = (app->map->mapWidth * app->tile_world_size) - (width() / 2);
-		return true;
-	}
-
-
-	collidedRight = false;
-	//Check for collision on right:
-	int grid_x_4 = (int)((x() + (width() / 2)) / 0.18f);
-	int grid_y_4 = (int)(-(y()) / 0.18f);
-	int data4 = app->map->layers[3][grid_y_4][grid_x_4];
-
-	if (data4 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		acceleration.x = 0;
-		//velocity.x = 0;
-		pos.x -= fabs((x() + width() / 2) - ((app->tile_world_size * grid_x_4)));
-		collidedRight = true;
-	}
-
-
-	//Check for collision on upper right:
-	grid_y_4 = (int)(-(y()) / 0.18f) + 1;
-	data4 = app->map->layers[3][grid_y_4][grid_x_4];
-
-	if (data4 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		acceleration.x = 0;
-		//velocity.x = 0;
-		pos.x -= fabs((x() + width() / 2) - ((app->tile_world_size * grid_x_4)));
-		collidedRight = true;
-	}
-
-	//Check for collision on lower right:
-	grid_y_4 = (int)(-(y()) / 0.18f) - 1;
-	data4 = app->map->layers[3][grid_y_4][grid_x_4];
-
-	if (data4 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		acceleration.x = 0;
-		//velocity.x = 0;
-		pos.x -= fabs((x() + width() / 2) - ((app->tile_world_size * grid_x_4)));
-		collidedRight = true;
-	}
-
-
-	return collidedRight;
-}
-
-
-
 double GameObject::distance(float x1, float y1, float x2, float y2) {
 	const double x_diff = x1 - x2;
 	const double y_diff = y1 - y2;
@@ -383,177 +167,131 @@ double GameObject::distance(float x1, float y1, float x2, float y2) {
 
 
 void GameObject::broadcast_event(const std::string& event_name){
+	if (defer_events){
+		pending_events.push_back(event_name);
+		return;
+	}
+
 	for (auto it = scripts.begin(); it != scripts.end(); ++it){
 		it->second->on_event(event_name);
 	}
 }
 
-void GameObject::check_for_collisions(){
+void GameObject::flush_events(){
+	for (int x = 0; x < pending_events.size(); x++){
+		for (auto it = scripts.begin(); it != scripts.end(); ++it){
+			it->second->on_event(pending_events[x]);
+		}
+	}
+
+	pending_events.clear();
+}
+
+void GameObject::keep_in_map(){
 	//Prevent object from going off left side of screen
-	if (x() - (width() / 2) < 0){
-		pos.x = 0 + width() / 2;
+	if (x() - (width() / 2) < app->tile_left(0)){
+		pos.x = app->tile_left(0) + width() / 2;
 		broadcast_event("left_collide");
 	}
 
 	//Prevent object from going off right side of screen
-	if (x() + (width() / 2) > app->map->mapWidth * app->tile_world_size){
-		pos.x = (app->map->mapWidth * app->tile_world_size) - (width() / 2);
+	if (x() + (width() / 2) > app->tile_left(app->map->mapWidth)){
+		pos.x = app->tile_left(app->map->mapWidth) - (width() / 2);
 		broadcast_event("right_collide");
 	}
 
 	//Prevent object from going off top
-	if (y() + (height() / 2) > 0){
-		pos.y = 0 - height() / 2;
+	if (y() + (height() / 2) > app->tile_top(0)){
+		pos.y = app->tile_top(0) - height() / 2;
 	}
 
 	//Prevent object from going off bottom
-	if (y() - (height() / 2) < -app->map->mapHeight * app->tile_world_size){
+	if (y() - (height() / 2) < app->tile_top(app->map->mapHeight)){
 		pos.y += 2.8f;
 	}
+}
 
+//Sprites have headroom, the old head probe sat at height / 2.6 above the center
+float GameObject::collision_top(){
+	return y() + height() / 2.6f;
+}
 
-	if (is_colliding_bottom()){
-		jumping = false;
-		velocity.y = 0;
-		pos.y += fabs((last_grid_y * app->tile_world_size) + (y() - height() / 2.0f));
-		collidedBottom = true;
-	}
-	else{
-		collidedBottom = false;
-	}
+//After moving along y. Whichever side of a rect the box started the tick on is the side it goes back to.
+void GameObject::collide_y(){
+	collidedBottom = false;
+	collidedTop = false;
 
+	//Shrunk a little across, so walls the box is flush against don't count
+	float skin = 0.001f;
+	app->collision->query_box(left() + skin, bottom(), right() - skin, collision_top(), collision_rects, app->origin_tile_x, app->origin_tile_y);
+	for (int i = 0; i < collision_rects.size(); i++){
+		const CollisionRect& r = app->collision->rect(collision_rects[i]);
+		float rect_top = app->tile_top(r.y);
+		float rect_bottom = app->tile_top(r.y + r.height);
+		//An earlier rect may have pushed it clear already
+		if (bottom() >= rect_top || collision_top() <= rect_bottom){
+			continue;
+		}
 
+		bool from_above = previous_pos.y - height() / 2 >= rect_top - skin;
+		bool from_below = previous_pos.y + height() / 2.6f <= rect_bottom + skin;
+		if (!from_above && !from_below){
+			//Started inside (a tile placed on it), take the short way out
+			from_above = rect_top - bottom() < collision_top() - rect_bottom;
+		}
 
-	//check for head collision
-	int grid_x_2 = (int)(x() / 0.18f);
-	int grid_y_2 = (int)fabs(-(y() + height() / 2.6f) / 0.18f);
-	int data2 = app->map->layers[3][grid_y_2][grid_x_2];
-	if (data2 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		velocity.y = 0.0f;
-		pos.y -= (y() + height() / 2.6f) - ((-app->tile_world_size * grid_y_2) - app->tile_world_size);
-		collidedTop = true;
-	}
-	else{
-		collidedTop = false;
-	}
-	//Head right side
-	grid_x_2 = (int)(x() / 0.18f) + 1;
-	data2 = app->map->layers[3][grid_y_2][grid_x_2];
-	if (data2 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		velocity.y = 0.0f;
-		pos.y -= (y() + height() / 2.6f) - ((-app->tile_world_size * grid_y_2) - app->tile_world_size);
-		collidedTop = true;
-	}
-	else{
-		collidedTop = false;
-	}
-	//Head left side
-	grid_x_2 = (int)(x() / 0.18f) - 1;
-	data2 = app->map->layers[3][grid_y_2][grid_x_2];
-	if (data2 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		velocity.y = 0.0f;
-		pos.y -= (y() + height() / 2.6f) - ((-app->tile_world_size * grid_y_2) - app->tile_world_size);
-		collidedTop = true;
-	}
-	else{
-		collidedTop = false;
+		velocity.y = 0;
+		if (from_above){
+			pos.y += rect_top - bottom();
+			jumping = false;
+			collidedBottom = true;
+		}
+		else{
+			pos.y -= collision_top() - rect_bottom;
+			collidedTop = true;
+		}
 	}
+}
 
-
-
-	//Check for collision on left:
-	int grid_x_3 = (int)((x() - (width() / 2.0f)) / 0.18f);
-	int grid_y_3 = (int)(-(y()) / 0.18f);
-	int data3 = app->map->layers[3][grid_y_3][grid_x_3];
+//After moving along x
+void GameObject::collide_x(){
 	collidedLeft = false;
+	collidedRight = false;
 
-	if (data3 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		pos.x -= (x() - width() / 2.0f) - ((app->tile_world_size * grid_x_3) + app->tile_world_size);
-		acceleration.x = 0;
-		//velocity.x = 0;
-		collidedLeft = true;
-		broadcast_event("left_collide");
-	}
-
+	//Shrunk a little vertically, so the floor it stands on doesn't count
+	float skin = 0.001f;
+	app->collision->query_box(left(), bottom() + skin, right(), collision_top() - skin, collision_rects, app->origin_tile_x, app->origin_tile_y);
+	for (int i = 0; i < collision_rects.size(); i++){
+		const CollisionRect& r = app->collision->rect(collision_rects[i]);
+		float rect_left = app->tile_left(r.x);
+		float rect_right = app->tile_left(r.x + r.width);
+		if (right() <= rect_left || left() >= rect_right){
+			continue;
+		}
 
-	//Collision on left upper
-	grid_y_3 = (int)(-(y()) / 0.18f) + 1;
-	data3 = app->map->layers[3][grid_y_3][grid_x_3];
+		bool from_left = previous_pos.x + width() / 2 <= rect_left + skin;
+		bool from_right = previous_pos.x - width() / 2 >= rect_right - skin;
+		if (!from_left && !from_right){
+			from_left = right() - rect_left < rect_right - left();
+		}
 
-	if (data3 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		pos.x -= (x() - width() / 2) - ((app->tile_world_size * grid_x_3) + app->tile_world_size);
 		acceleration.x = 0;
-		//velocity.x = 0;
-		collidedLeft = true;
+		if (from_left){
+			pos.x -= right() - rect_left;
+			collidedRight = true;
+		}
+		else{
+			pos.x += rect_right - left();
+			collidedLeft = true;
+		}
 	}
 
-
-	//Collision on left lower
-	grid_y_3 = (int)(-(y()) / 0.18f) - 1;
-	data3 = app->map->layers[3][grid_y_3][grid_x_3];
-
-	if (data3 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		pos.x -= (x() - width() / 2) - ((app->tile_world_size * grid_x_3) + app->tile_world_size);
-		acceleration.x = 0;
-		//velocity.x = 0;
-		collidedLeft = true;
+	if (collidedLeft){
+		broadcast_event("left_collide");
 	}
-
-
-
-	//Check for collision on right:
-	collidedRight = false;
-	int grid_x_4 = (int)((x() + (width() / 2)) / 0.18f);
-	int grid_y_4 = (int)(-(y()) / 0.18f);
-	int data4 = app->map->layers[3][grid_y_4][grid_x_4];
-
-	if (data4 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		acceleration.x = 0;
-		//velocity.x = 0;
-		pos.x -= fabs((x() + width() / 2) - ((app->tile_world_size * grid_x_4)));
-		collidedRight = true;
+	if (collidedRight){
 		broadcast_event("right_collide");
 	}
-	//else{
-	//	collidedRight = false;
-	//}
-
-	//Check for collision on upper right:
-	grid_y_4 = (int)(-(y()) / 0.18f) + 1;
-	data4 = app->map->layers[3][grid_y_4][grid_x_4];
-
-	if (data4 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		acceleration.x = 0;
-		//velocity.x = 0;
-		pos.x -= fabs((x() + width() / 2) - ((app->tile_world_size * grid_x_4)));
-		collidedRight = true;
-	}
-	//else{
-	//	collidedRight = false;
-	//}
-
-	//Check for collision on lower right:
-	grid_y_4 = (int)(-(y()) / 0.18f) - 1;
-	data4 = app->map->layers[3][grid_y_4][grid_x_4];
-
-	if (data4 > 0){
-		//std::cout << "Tile at heroes head: " << data2 << "   grid_x, grid_y" << grid_x_2 << "," << grid_y_2 << std::endl;
-		acceleration.x = 0;
-		//velocity.x = 0;
-		pos.x -= fabs((x() + width() / 2) - ((app->tile_world_size * grid_x_4)));
-		collidedRight = true;
-	}
-	//else{
-	//	collidedRight = false;
-	//}
 }
 
 float GameObject::left(){
@@ -587,8 +325,7 @@ void GameObject::update(){
 	//pos.x += std::cosf(movement_angle) * elapsed * 1.0f;
 	//pos.y += std::sinf(movement_angle) * elapsed * 1.0f;
 
-
-	update_scripts();
+	previous_pos = pos;
 
 
 	if (apply_velocity){
@@ -609,33 +346,34 @@ void GameObject::update(){
 
 		pos.y += app->elapsed * velocity.y;
 		if (check_collisions){
-			check_for_collisions();
+			keep_in_map();
+			collide_y();
 		}
 
 		pos.x += app->elapsed * velocity.x; //velocity contains direction
 	
 		if (check_collisions){
-			check_for_collisions();
+			keep_in_map();
+			collide_x();
 		}
 
 	}
+}
 
+//Scheduled on its own, see GameLevel::update
+void GameObject::update_animation(){
 	Animation* current_animation = get_current_animation();
 
 	//std::cout << current_animation_name << std::endl;
 	if (current_animation != NULL){
 		if (strings["shooter_name"] == "hero"){
-			if (current_animation_name == "idle_shoot" && get_runtime() - last_shoot > 0.2){
+			if (current_animation_name == "idle_shoot" && app->scheduler.time() - last_shoot > 0.2){
 				//std::cout << "SETTING TO IDLE FROM IDLESHOOT" << std::endl;
-				current_animation_name = "idle";
 				set_animation("idle");
 				return;
 			}
 		}
 
-		current_animation->update();
-		current_animation->update_size(size.x, size.y);
-
 
 		//if (!current_animation->loop && current_animation->done_time_elapsed(current_animation->interval)){
 		//	destroy();
@@ -648,8 +386,9 @@ void GameObject::update(){
 }
 
 Animation* GameObject::get_current_animation(){
-	if (animations.count(current_animation_name)){
-		return &animations[current_animation_name];
+	auto found = animations.find(current_animation_name);
+	if (found != animations.end()){
+		return found->second.get();
 	}
 	else{
 		return NULL;
@@ -682,6 +421,14 @@ float GameObject::z(){
 	return pos.z;
 }
 
+float GameObject::render_x(){
+	return previous_pos.x + (pos.x - previous_pos.x) * app->render_alpha;
+}
+
+float GameObject::render_y(){
+	return previous_pos.y + (pos.y - previous_pos.y) * app->render_alpha;
+}
+
 
 float GameObject::top_left_x(){
 	return pos.x - (size.x / 2);
@@ -732,15 +479,13 @@ void GameObject::draw(){
 
 	if (draw_mode == "texture"){
 
-		app->tex_program->SetModelMatrix(app->modelMatrix);
 		app->tex_program->SetProjectionMatrix(app->projectionMatrix);
-		app->tex_program->SetViewMatrix(app->viewMatrix);
 
 
-		if (animations.count(current_animation_name)){
-			app->modelMatrix.Identity();
-			app->modelMatrix.Translate(x(), y(), z());
-			app->modelMatrix.SetScale(direction[0], 1, 1);
+		if (animator.clip != NULL){
+			//Flip, then move into place. Only expanded to a 4x4 for the uniform upload.
+			Transform2D transform = Transform2D::flip(direction[0]) * Transform2D::translate(render_x(), render_y());
+			app->modelMatrix = transform.to_matrix(z());
 			app->tex_program->SetModelMatrix(app->modelMatrix);
 			app->tex_program->SetViewMatrix(app->viewMatrix);
 			app->tex_program->SetColor(1, 1, 0, 1);
@@ -750,18 +495,16 @@ void GameObject::draw(){
 
 			glUseProgram(app->tex_program->programID);
 
-			animations[current_animation_name].draw();
+			animator.clip->draw(animator.frame);
 		}
 	}
 	else if (draw_mode == "shape"){
-		app->shape_program->SetModelMatrix(app->modelMatrix);
 		app->shape_program->SetProjectionMatrix(app->projectionMatrix);
 		app->shape_program->SetViewMatrix(app->viewMatrix);
 		glUseProgram(app->shape_program->programID);
 
 
-		app->modelMatrix.Identity();
-		app->modelMatrix.Translate(x(), y(), z());
+		app->modelMatrix = Transform2D::translate(render_x(), render_y()).to_matrix(z());
 		app->shape_program->SetModelMatrix(app->modelMatrix);
 		app->shape_program->SetColor(color[0], color[1], color[2], color[3]);
 
@@ -788,8 +531,8 @@ float GameObject::height(){
 
 
 
-GameObject GameObject::shoot(Animation animation){
-	last_shoot = get_runtime();
+GameObject GameObject::shoot(std::shared_ptr<Animation> animation){
+	last_shoot = app->scheduler.time();
 	GameObject newBullet;
 	newBullet.set_pos(x(), y() + 0.1f);
 	newBullet.set_velocity(direction[0] * 3.0f, 0);
@@ -802,7 +545,6 @@ GameObject GameObject::shoot(Animation animation){
 	newBullet.check_collisions = false;
 
 	newBullet.set_app(app);
-	animation.set_app(app);
 
 	newBullet.add_animation("idle", animation);
 	newBullet.set_animation("idle");
@@ -823,7 +565,7 @@ void GameObject::take_hit(float dmg){
 	}
 
 
-	app->play_sound("pain");
+	app->sounds.play(app->pain_sound);
 
 	last_hit = app->get_runtime();
 	life -= dmg;
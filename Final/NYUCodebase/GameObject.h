@@ -18,6 +18,7 @@
 #include <memory>
 #include "App.h";
 #include "Animation.h";
+#include "Transform2D.h"
 
 class Animation;
 class App;
@@ -27,11 +28,15 @@ public:
 	float last_change = 0;
 	float interval = .085; //milliseconds (ms)
 
-	std::unordered_map<std::string, Animation> animations;
+	//Clips by name, shared with other entities. animator is this entity's playback.
+	std::unordered_map<std::string, std::shared_ptr<Animation>> animations;
+	Animator animator;
 	std::unordered_map<std::string, std::string> strings;
 	std::unordered_map<std::string, Script*> scripts;
 	std::string current_animation_name = "";
 	Vector3 pos;
+	//pos at the start of the current tick, draw() blends from it to pos
+	Vector3 previous_pos;
 	Vector3 start_pos;
 	float color[4];
 	std::vector<float> verts;
@@ -84,6 +89,8 @@ public:
 
 	
 	void add_animation(const std::string& animation_name, Animation animation);
+	//Shares the clip, the caller has already set its app
+	void add_animation(const std::string& animation_name, std::shared_ptr<Animation> animation);
 	void set_animation(const std::string& animation_name);
 
 
@@ -121,22 +128,25 @@ public:
 	bool collidedLeft = false;
 	bool collidedRight = false;
 
-	int last_grid_x = 0;
-	int last_grid_y = 0;
-	int colliding_bottom();
-
-	bool is_colliding_bottom();
-
 	double distance(float x1, float y1, float x2, float y2);
 
-	void check_for_collisions();
+	//Level collision goes through app->collision's merged rects. The box
+	//spans left()..right() and bottom()..collision_top().
+	void keep_in_map();
+	void collide_y();
+	void collide_x();
+	float collision_top();
+	std::vector<int> collision_rects; //query_box results, reused every tick
 
 
 	bool jumping = false;
 	bool check_collisions = true;
 
 	bool constant_x_velocity = false;
+	//Movement and tile collision. Scripts and animation are separate systems with their own rates.
 	virtual void update();
+	//Clip changes that depend on state. Frames advance in the batch pass, advance_animators.
+	void update_animation();
 
 	Animation* get_current_animation();
 
@@ -152,6 +162,10 @@ public:
 
 	float z();
 
+	//Between previous_pos and pos by app->render_alpha
+	float render_x();
+	float render_y();
+
 
 	float top_left_x();
 
@@ -182,13 +196,16 @@ public:
 	void draw();
 	float width();
 	float height();
-	bool colliding_left();
-	bool colliding_right();
 
 	void broadcast_event(const std::string& event_name);
-	bool colliding_directly_right();
-	bool colliding_directly_left();
-	GameObject shoot(Animation animation);
+
+	//While set, broadcast_event queues events instead of running scripts so
+	//update() can run on a worker thread. flush_events() runs them afterwards.
+	bool defer_events = false;
+	std::vector<std::string> pending_events;
+	void flush_events();
+
+	GameObject shoot(std::shared_ptr<Animation> animation);
 };
 
 #endif
\ No newline at end of file
@@ -15,12 +15,12 @@ void GroundSpikeScript::on_event(const std::string& event_name){
 	}
 }
 
+//Runs at GameLevel::script_rate, not every tick
 void GroundSpikeScript::update() {
-	if (app->get_runtime() - last_check < 0.1){
-		return;
+	int distance = app->flow->distance(obj->x(), obj->y(), app->origin_tile_x, app->origin_tile_y);
+	int step_x, step_y;
+	if (distance > 0 && distance <= chase_steps && app->flow->direction(obj->x(), obj->y(), &step_x, &step_y, app->origin_tile_x, app->origin_tile_y) && step_x != 0){
+		obj->velocity.x = abs(obj->velocity.x) * (float)step_x;
 	}
-
-
-	last_check = app->get_runtime();
 }
 
@@ -9,6 +9,9 @@ public:
 	GroundSpikeScript();
 	GroundSpikeScript(GameObject* go_);
 
+	//Within this many walking steps of the player, follow the flow field instead of patrolling
+	int chase_steps = 20;
+
 	virtual void update();
 
 	void on_event(const std::string& event_name) override;
@@ -0,0 +1,170 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+JobSystem::JobSystem(int worker_count_){
+	queued_jobs = 0;
+	steals = 0;
+
+	if (worker_count_ < 0){
+		//The main thread is a worker too, so leave one core for it
+		worker_count_ = (int)std::thread::hardware_concurrency() - 1;
+		if (worker_count_ < 0){
+			worker_count_ = 0;
+		}
+	}
+
+	for (int x = 0; x < worker_count_ + 1; x++){
+		queues.push_back(new WorkQueue());
+	}
+
+	for (int x = 0; x < worker_count_; x++){
+		workers.push_back(std::thread(&JobSystem::worker_loop, this, x + 1));
+	}
+}
+
+JobSystem::~JobSystem(){
+	{
+		std::lock_guard<std::mutex> guard(sleep_lock);
+		stopping = true;
+	}
+	wake_cv.notify_all();
+
+	for (int x = 0; x < workers.size(); x++){
+		workers[x].join();
+	}
+
+	for (int x = 0; x < queues.size(); x++){
+		delete queues[x];
+	}
+}
+
+int JobSystem::thread_count(){
+	return queues.size();
+}
+
+int JobSystem::steal_count(){
+	return steals.load();
+}
+
+//Workers own queues 1..n, anyone else (the main thread) shares queue 0
+int JobSystem::queue_index_of_this_thread(){
+	std::thread::id self = std::this_thread::get_id();
+	for (int x = 0; x < workers.size(); x++){
+		if (workers[x].get_id() == self){
+			return x + 1;
+		}
+	}
+	return 0;
+}
+
+void JobSystem::parallel_for(int count, int chunk_size, const std::function<void(int, int)>& job){
+	if (count <= 0){
+		return;
+	}
+
+	if (chunk_size < 1){
+		chunk_size = 1;
+	}
+
+	//Not worth waking anyone up
+	if (workers.empty() || count <= chunk_size){
+		job(0, count);
+		return;
+	}
+
+	int chunk_count = (count + chunk_size - 1) / chunk_size;
+	int self = queue_index_of_this_thread();
+
+	//Lives on this stack frame, so nothing may touch a job after it counts itself off
+	std::atomic<int> remaining(chunk_count);
+
+	//Deal the chunks out round robin so every thread starts with local work
+	for (int x = 0; x < chunk_count; x++){
+		Job new_job;
+		new_job.fn = &job;
+		new_job.begin = x * chunk_size;
+		new_job.end = std::min(count, new_job.begin + chunk_size);
+		new_job.remaining = &remaining;
+
+		WorkQueue* queue = queues[(self + x) % queues.size()];
+		std::lock_guard<std::mutex> guard(queue->lock);
+		queue->jobs.push_back(new_job);
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(sleep_lock);
+		queued_jobs += chunk_count;
+	}
+	wake_cv.notify_all();
+
+	//Help out instead of blocking, a nested call would otherwise starve the pool.
+	//Any job will do, finishing someone else's chunk still frees up a thread for ours.
+	while (remaining.load() > 0){
+		Job next_job;
+		if (get_job(self, next_job)){
+			run_job(next_job);
+		}
+		else{
+			//Our last chunks are running elsewhere
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::worker_loop(int queue_index){
+	while (true){
+		Job job;
+		if (get_job(queue_index, job)){
+			run_job(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> guard(sleep_lock);
+		wake_cv.wait(guard, [this]{ return stopping || queued_jobs.load() > 0; });
+		if (stopping){
+			return;
+		}
+	}
+}
+
+bool JobSystem::pop_job(int queue_index, Job& job){
+	WorkQueue* queue = queues[queue_index];
+	std::lock_guard<std::mutex> guard(queue->lock);
+	if (queue->jobs.empty()){
+		return false;
+	}
+
+	job = queue->jobs.back();
+	queue->jobs.pop_back();
+	queued_jobs--;
+	return true;
+}
+
+bool JobSystem::steal_job(int queue_index, Job& job){
+	for (int x = 1; x < queues.size(); x++){
+		WorkQueue* victim = queues[(queue_index + x) % queues.size()];
+		std::lock_guard<std::mutex> guard(victim->lock);
+		if (!victim->jobs.empty()){
+			job = victim->jobs.front();
+			victim->jobs.pop_front();
+			queued_jobs--;
+			steals++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool JobSystem::get_job(int queue_index, Job& job){
+	if (pop_job(queue_index, job)){
+		return true;
+	}
+
+	return steal_job(queue_index, job);
+}
+
+void JobSystem::run_job(const Job& job){
+	(*job.fn)(job.begin, job.end);
+	job.remaining->fetch_sub(1);
+}
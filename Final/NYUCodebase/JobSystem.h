@@ -0,0 +1,64 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+//Splits a range of work into chunks and runs them on a pool of worker threads.
+//Every thread owns a deque: it pops its own work from the back and steals from
+//the front of the other deques when it runs dry.
+//parallel_for can be called from inside a job: the waiting thread keeps running
+//chunks (its own or stolen) until the chunks of its own call are finished.
+class JobSystem{
+public:
+	//worker_count_ < 0 sizes the pool to the core count, 0 runs everything on the calling thread
+	JobSystem(int worker_count_ = -1);
+	~JobSystem();
+
+	//Calls job(begin, end) for every chunk of [0, count) and blocks until all chunks are done.
+	//The calling thread works on chunks too, so a pool of 0 workers just runs serially.
+	void parallel_for(int count, int chunk_size, const std::function<void(int, int)>& job);
+
+	int thread_count();
+
+	//Chunks that ran on a different thread than the one they were dealt to
+	int steal_count();
+
+private:
+	struct Job{
+		const std::function<void(int, int)>* fn;
+		int begin;
+		int end;
+		std::atomic<int>* remaining; //chunks of the owning parallel_for still to finish
+	};
+
+	struct WorkQueue{
+		std::mutex lock;
+		std::deque<Job> jobs;
+	};
+
+	std::vector<std::thread> workers;
+	std::vector<WorkQueue*> queues; //index 0 belongs to the calling thread
+
+	std::atomic<int> queued_jobs;
+	std::atomic<int> steals;
+	bool stopping = false;
+
+	std::mutex sleep_lock;
+	std::condition_variable wake_cv;
+
+	int queue_index_of_this_thread();
+
+	void worker_loop(int queue_index);
+	bool pop_job(int queue_index, Job& job);
+	bool steal_job(int queue_index, Job& job);
+	bool get_job(int queue_index, Job& job);
+	void run_job(const Job& job);
+};
+
+#endif
@@ -2,6 +2,32 @@
 #include "Matrix.h"
 #include <math.h>
 
+#ifdef MATRIX_USE_SSE
+#include <xmmintrin.h>
+
+#define MATRIX_SHUFFLE(v1, v2, x, y, z, w) _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(w, z, y, x))
+#define MATRIX_SWIZZLE(v, x, y, z, w) MATRIX_SHUFFLE(v, v, x, y, z, w)
+
+//2x2 blocks are stored row major in one register: (a b c d) = |a b|
+//                                                              |c d|
+static inline __m128 Mat2Mul(__m128 a, __m128 b) {
+    return _mm_add_ps(_mm_mul_ps(a, MATRIX_SWIZZLE(b, 0, 3, 0, 3)),
+        _mm_mul_ps(MATRIX_SWIZZLE(a, 1, 0, 3, 2), MATRIX_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+//adjugate(a) * b
+static inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(MATRIX_SWIZZLE(a, 3, 3, 0, 0), b),
+        _mm_mul_ps(MATRIX_SWIZZLE(a, 1, 1, 2, 2), MATRIX_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+//a * adjugate(b)
+static inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(a, MATRIX_SWIZZLE(b, 3, 0, 3, 0)),
+        _mm_mul_ps(MATRIX_SWIZZLE(a, 1, 0, 3, 2), MATRIX_SWIZZLE(b, 2, 1, 2, 1)));
+}
+#endif
+
 Matrix::Matrix() {
     Identity();
 }
@@ -29,6 +55,54 @@ void Matrix::Identity() {
 }
 
 Matrix Matrix::Inverse() const {
+#ifdef MATRIX_USE_SSE
+    //Block inverse on the four 2x2 sub matrices |A B|
+    //                                           |C D|
+    __m128 row0 = _mm_loadu_ps(m[0]);
+    __m128 row1 = _mm_loadu_ps(m[1]);
+    __m128 row2 = _mm_loadu_ps(m[2]);
+    __m128 row3 = _mm_loadu_ps(m[3]);
+
+    __m128 A = _mm_movelh_ps(row0, row1);
+    __m128 B = _mm_movehl_ps(row1, row0);
+    __m128 C = _mm_movelh_ps(row2, row3);
+    __m128 D = _mm_movehl_ps(row3, row2);
+
+    //(|A| |B| |C| |D|)
+    __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(MATRIX_SHUFFLE(row0, row2, 0, 2, 0, 2), MATRIX_SHUFFLE(row1, row3, 1, 3, 1, 3)),
+        _mm_mul_ps(MATRIX_SHUFFLE(row0, row2, 1, 3, 1, 3), MATRIX_SHUFFLE(row1, row3, 0, 2, 0, 2)));
+    __m128 detA = MATRIX_SWIZZLE(detSub, 0, 0, 0, 0);
+    __m128 detB = MATRIX_SWIZZLE(detSub, 1, 1, 1, 1);
+    __m128 detC = MATRIX_SWIZZLE(detSub, 2, 2, 2, 2);
+    __m128 detD = MATRIX_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    __m128 D_C = Mat2AdjMul(D, C);
+    __m128 A_B = Mat2AdjMul(A, B);
+    __m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, D_C));
+    __m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, A_B));
+    __m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, A_B));
+    __m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, D_C));
+
+    //|M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    __m128 tr = _mm_mul_ps(A_B, MATRIX_SWIZZLE(D_C, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, MATRIX_SWIZZLE(tr, 1, 0, 3, 2));
+    tr = _mm_add_ps(tr, MATRIX_SWIZZLE(tr, 2, 3, 0, 1));
+    __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+    __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+    X_ = _mm_mul_ps(X_, rDetM);
+    Y_ = _mm_mul_ps(Y_, rDetM);
+    Z_ = _mm_mul_ps(Z_, rDetM);
+    W_ = _mm_mul_ps(W_, rDetM);
+
+    Matrix m2;
+    _mm_storeu_ps(m2.m[0], MATRIX_SHUFFLE(X_, Y_, 3, 1, 3, 1));
+    _mm_storeu_ps(m2.m[1], MATRIX_SHUFFLE(X_, Y_, 2, 0, 2, 0));
+    _mm_storeu_ps(m2.m[2], MATRIX_SHUFFLE(Z_, W_, 3, 1, 3, 1));
+    _mm_storeu_ps(m2.m[3], MATRIX_SHUFFLE(Z_, W_, 2, 0, 2, 0));
+    return m2;
+#else
     float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2], m03 = m[0][3];
     float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2], m13 = m[1][3];
     float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2], m23 = m[2][3];
@@ -100,11 +174,27 @@ Matrix Matrix::Inverse() const {
     m2.m[3][2] = d32;
     m2.m[3][3] = d33;
     return m2;
+#endif
 }
 
 Matrix Matrix::operator * (const Matrix &m2) const {
     Matrix r;
-    
+
+#ifdef MATRIX_USE_SSE
+    //Row i of the result is m[i][0] * row 0 of m2 + ... + m[i][3] * row 3 of m2
+    __m128 b0 = _mm_loadu_ps(m2.m[0]);
+    __m128 b1 = _mm_loadu_ps(m2.m[1]);
+    __m128 b2 = _mm_loadu_ps(m2.m[2]);
+    __m128 b3 = _mm_loadu_ps(m2.m[3]);
+    for (int i = 0; i < 4; i++) {
+        __m128 row = _mm_mul_ps(_mm_set1_ps(m[i][0]), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][1]), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][2]), b2));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][3]), b3));
+        _mm_storeu_ps(r.m[i], row);
+    }
+    return r;
+#else
     r.m[0][0] = m[0][0] * m2.m[0][0] + m[0][1] * m2.m[1][0] + m[0][2] * m2.m[2][0] + m[0][3] * m2.m[3][0];
     r.m[0][1] = m[0][0] * m2.m[0][1] + m[0][1] * m2.m[1][1] + m[0][2] * m2.m[2][1] + m[0][3] * m2.m[3][1];
     r.m[0][2] = m[0][0] * m2.m[0][2] + m[0][1] * m2.m[1][2] + m[0][2] * m2.m[2][2] + m[0][3] * m2.m[3][2];
@@ -126,6 +216,36 @@ Matrix Matrix::operator * (const Matrix &m2) const {
     r.m[3][3] = m[3][0] * m2.m[0][3] + m[3][1] * m2.m[1][3] + m[3][2] * m2.m[2][3] + m[3][3] * m2.m[3][3];
     
     return r;
+#endif
+}
+
+void Matrix::TransformVectors(const float *in, float *out, int count) const {
+#ifdef MATRIX_USE_SSE
+    __m128 r0 = _mm_loadu_ps(m[0]);
+    __m128 r1 = _mm_loadu_ps(m[1]);
+    __m128 r2 = _mm_loadu_ps(m[2]);
+    for (int i = 0; i < count; i++) {
+        const float *v = in + i * 3;
+        __m128 p = _mm_mul_ps(_mm_set1_ps(v[0]), r0);
+        p = _mm_add_ps(p, _mm_mul_ps(_mm_set1_ps(v[1]), r1));
+        p = _mm_add_ps(p, _mm_mul_ps(_mm_set1_ps(v[2]), r2));
+
+        float result[4];
+        _mm_storeu_ps(result, p);
+        out[i * 3] = result[0];
+        out[i * 3 + 1] = result[1];
+        out[i * 3 + 2] = result[2];
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        float x = in[i * 3];
+        float y = in[i * 3 + 1];
+        float z = in[i * 3 + 2];
+        out[i * 3] = (m[0][0] * x) + (m[1][0] * y) + (m[2][0] * z);
+        out[i * 3 + 1] = (m[0][1] * x) + (m[1][1] * y) + (m[2][1] * z);
+        out[i * 3 + 2] = (m[0][2] * x) + (m[1][2] * y) + (m[2][2] * z);
+    }
+#endif
 }
 
 void Matrix::SetPosition(float x, float y, float z) {
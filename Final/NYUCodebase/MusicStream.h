@@ -0,0 +1,107 @@
+#ifndef MUSICSTREAM_H
+#define MUSICSTREAM_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <atomic>
+
+//Streams music from disk instead of holding whole tracks in memory. Each
+//track gets a decoder thread that reads fixed-size chunks into a ring buffer
+//a few seconds deep; the mixer's music hook pulls from the ring and
+//crossfades when a new track starts. Because the ring absorbs decode
+//hiccups, the device buffer (Mix_OpenAudio's chunk size) can be sized for
+//effect latency alone.
+//
+//Only PCM WAV is decoded here. Other formats (mp3, ogg) go through
+//SDL_mixer's own music player, which cuts over with a fade-in.
+class MusicStream{
+public:
+	int chunk_frames = 4096; //frames read per decode step
+	float buffer_seconds = 2.0f; //ring depth per track
+
+	std::atomic<int> underruns;
+
+	MusicStream();
+	~MusicStream();
+
+	//After Mix_OpenAudio
+	void open();
+	void close();
+
+	//Loops path, crossfading from whatever is playing. Playing the current track again does nothing.
+	void play(const std::string& path, float fade_seconds = 1.0f);
+	void stop(float fade_seconds = 1.0f);
+
+	void set_volume(float volume_); //0-1
+
+	//Main thread, once per frame. Frees tracks that finished fading out.
+	void update();
+
+private:
+	//Drives the decoder and the mixer callback directly, without an audio device
+	friend struct MusicStreamTest;
+
+	struct Track{
+		std::string path;
+		std::ifstream file;
+		std::streamoff data_start = 0;
+		int data_bytes = 0;
+		int source_rate = 0;
+		int source_channels = 0;
+		int read_bytes = 0;
+
+		//Interleaved output frames, single producer (decoder) / single consumer (mixer)
+		std::vector<Sint16> ring;
+		std::atomic<unsigned int> write_pos;
+		std::atomic<unsigned int> read_pos;
+
+		//Resampler state, decoder thread only
+		double phase = 0;
+		Sint16 last_frame[2];
+
+		std::thread decoder;
+		std::atomic<bool> stopping;
+		Track* next_retired = NULL;
+
+		Track(){ write_pos = 0; read_pos = 0; stopping = false; last_frame[0] = last_frame[1] = 0; }
+	};
+
+	int device_rate = 44100;
+	int device_channels = 2;
+	bool can_stream = false; //device is 16 bit
+	bool hooked = false;
+	std::atomic<float> volume;
+
+	//Handed from the main thread to the mixer callback
+	std::atomic<Track*> pending;
+	std::atomic<int> pending_fade_samples;
+
+	//Mixer callback only
+	Track* current = NULL;
+	Track* previous = NULL;
+	int fade_samples = 0;
+	int fade_pos = 0;
+	std::vector<Sint16> scratch;
+
+	//Tracks the mixer is done with, freed by update() on the main thread
+	std::atomic<Track*> retired_head;
+	void retire(Track* track);
+
+	std::string current_path;
+	Mix_Music* fallback_music = NULL;
+
+	bool open_wav(Track& track);
+	void decode_loop(Track* track);
+	bool decode_chunk(Track& track, std::vector<Sint16>& source, std::vector<Sint16>& out);
+	void start_track(Track* track, float fade_seconds);
+	void delete_track(Track* track);
+
+	static void mix_callback(void* udata, Uint8* stream, int len);
+	void mix(Sint16* out, int samples);
+};
+
+#endif
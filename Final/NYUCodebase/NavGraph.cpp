@@ -0,0 +1,385 @@
+#include "NavGraph.h"
+#include <algorithm>
+#include <math.h>
+
+void NavGraph::build(const FlareMap& map, int layer_, float tile_size_){
+	width = map.mapWidth;
+	height = map.mapHeight;
+	layer = layer_;
+	tile_size = tile_size_;
+
+	solid.assign(width * height, 0);
+	standing.assign(width * height, false);
+	read_map(map, 0, width);
+
+	int chunk_count = (width + chunk_columns - 1) / chunk_columns;
+	chunks.clear();
+	chunks.resize(chunk_count);
+	for (int i = 0; i < chunk_count; i++){
+		chunks[i].first_column = i * chunk_columns;
+		chunks[i].columns = std::min(chunk_columns, width - chunks[i].first_column);
+		build_chunk(chunks[i]);
+	}
+
+	g_cost.assign(width * height, 0);
+	parent.assign(width * height, -1);
+	parent_edge_type.assign(width * height, NAV_WALK);
+	parent_speed.assign(width * height, 0);
+	visit_stamp.assign(width * height, 0);
+	closed.assign(width * height, false);
+	stamp = 0;
+	dirty_columns.clear();
+	cache.clear();
+	generation++;
+}
+
+void NavGraph::read_map(const FlareMap& map, int first_column, int columns){
+	unsigned int** tiles = map.layers[layer];
+	for (int x = first_column; x < first_column + columns; x++){
+		for (int y = 0; y < height; y++){
+			solid[y * width + x] = tiles[y][x] != 0;
+		}
+		for (int y = 0; y < height; y++){
+			standing[y * width + x] = !solid[y * width + x] && y + 1 < height && solid[(y + 1) * width + x];
+		}
+	}
+}
+
+bool NavGraph::is_solid(int x, int y){
+	if (x < 0 || x >= width || y >= height){
+		return true;
+	}
+	//Open sky above the map
+	if (y < 0){
+		return false;
+	}
+	return solid[y * width + x] != 0;
+}
+
+int NavGraph::fly(float x, float y, float speed_x, float speed_y, int* reach_min, int* reach_max){
+	//Tile units, rows grow downwards
+	float vx = speed_x / tile_size;
+	float vy = -speed_y / tile_size;
+	float g = -gravity / tile_size;
+
+	for (float t = 0; t < max_air_time; t += timestep){
+		float previous_y = y;
+		//Same order as GameObject::update
+		vy += g * timestep;
+		y += vy * timestep;
+		x += vx * timestep;
+
+		int fx = (int)floorf(x);
+		*reach_min = std::min(*reach_min, fx);
+		*reach_max = std::max(*reach_max, fx);
+		if (fx < 0 || fx >= width || y >= height){
+			return -1;
+		}
+
+		//Feet crossed into a new row on the way down
+		int row = (int)floorf(y);
+		if (vy > 0 && row > (int)floorf(previous_y) && is_solid(fx, row)){
+			int landing = (row - 1) * width + fx;
+			return row - 1 >= 0 && standing[landing] ? landing : -1;
+		}
+
+		int feet_row = (int)floorf(y - 0.001f);
+		for (int r = feet_row; r > feet_row - clearance; r--){
+			if (is_solid(fx, r)){
+				return -1;
+			}
+		}
+	}
+	return -1;
+}
+
+void NavGraph::add_edge(std::vector<NavEdge>& edges, int first, int to, NavEdgeType type, float cost, float speed_x){
+	for (int i = first; i < edges.size(); i++){
+		if (edges[i].to == to){
+			if (cost < edges[i].cost){
+				edges[i].type = type;
+				edges[i].cost = cost;
+				edges[i].speed_x = speed_x;
+			}
+			return;
+		}
+	}
+
+	NavEdge edge = { to, type, cost, speed_x };
+	edges.push_back(edge);
+}
+
+void NavGraph::build_chunk(Chunk& chunk){
+	chunk.edges.clear();
+	chunk.first_edge.assign(chunk.columns * height + 1, 0);
+	chunk.reach_min = chunk.first_column;
+	chunk.reach_max = chunk.first_column + chunk.columns - 1;
+
+	for (int x = chunk.first_column; x < chunk.first_column + chunk.columns; x++){
+		for (int y = 0; y < height; y++){
+			int local = (x - chunk.first_column) * height + y;
+			int first = chunk.edges.size();
+			chunk.first_edge[local] = first;
+
+			int cell = y * width + x;
+			if (!standing[cell]){
+				continue;
+			}
+
+			for (int d = -1; d <= 1; d += 2){
+				int nx = x + d;
+				if (nx < 0 || nx >= width){
+					continue;
+				}
+
+				//Walk, level or a one tile step
+				for (int dy = -1; dy <= 1; dy++){
+					int ny = y + dy;
+					if (ny < 0 || ny >= height || !standing[ny * width + nx]){
+						continue;
+					}
+					if (dy < 0 && is_solid(x, y - 1)){
+						continue;
+					}
+					add_edge(chunk.edges, first, ny * width + nx, NAV_WALK, dy == 0 ? 1.0f : sqrtf(2.0f), d * run_speed);
+				}
+
+				//Walk off a ledge, slowly and at full speed
+				if (!is_solid(nx, y) && !standing[y * width + nx]){
+					float speeds[] = { 0.25f, 1.0f };
+					for (int s = 0; s < 2; s++){
+						float start_x = d > 0 ? x + 1.01f : x - 0.01f;
+						int landing = fly(start_x, (float)(y + 1), d * speeds[s] * run_speed, 0, &chunk.reach_min, &chunk.reach_max);
+						if (landing >= 0){
+							float dx = (float)(landing % width - x);
+							float dy = (float)(landing / width - y);
+							add_edge(chunk.edges, first, landing, NAV_FALL, sqrtf(dx * dx + dy * dy) + 0.5f, d * speeds[s] * run_speed);
+						}
+					}
+				}
+			}
+
+			//Jumps at a spread of run speeds either way
+			for (int s = -4; s <= 4; s++){
+				float speed_x = s * run_speed / 4;
+				int landing = fly(x + 0.5f, (float)(y + 1), speed_x, jump_speed, &chunk.reach_min, &chunk.reach_max);
+				if (landing < 0 || landing == cell){
+					continue;
+				}
+
+				float dx = (float)(landing % width - x);
+				float dy = (float)(landing / width - y);
+				bool neighbour = fabsf(dx) <= 1 && fabsf(dy) <= 1;
+				if (!neighbour){
+					add_edge(chunk.edges, first, landing, NAV_JUMP, sqrtf(dx * dx + dy * dy) + 2.0f, speed_x);
+				}
+			}
+		}
+	}
+	chunk.first_edge[chunk.columns * height] = chunk.edges.size();
+	chunk.dirty = false;
+}
+
+void NavGraph::invalidate_column(int x){
+	if (x < 0 || x >= width){
+		return;
+	}
+
+	dirty_columns.push_back(x);
+	for (int i = 0; i < chunks.size(); i++){
+		Chunk& chunk = chunks[i];
+		//Walk edges reach one column past the chunk
+		bool near = x >= chunk.first_column - 1 && x <= chunk.first_column + chunk.columns;
+		if (near || (x >= chunk.reach_min && x <= chunk.reach_max)){
+			chunk.dirty = true;
+		}
+	}
+}
+
+int NavGraph::update(const FlareMap& map){
+	if (dirty_columns.empty()){
+		return 0;
+	}
+
+	for (int i = 0; i < dirty_columns.size(); i++){
+		read_map(map, dirty_columns[i], 1);
+	}
+	dirty_columns.clear();
+
+	int rebuilt = 0;
+	for (int i = 0; i < chunks.size(); i++){
+		if (chunks[i].dirty){
+			build_chunk(chunks[i]);
+			rebuilt++;
+		}
+	}
+	generation++;
+	return rebuilt;
+}
+
+const NavEdge* NavGraph::edges_of(int cell, int* count){
+	int x = cell % width;
+	int y = cell / width;
+	const Chunk& chunk = chunks[x / chunk_columns];
+	int local = (x - chunk.first_column) * height + y;
+	int first = chunk.first_edge[local];
+	*count = chunk.first_edge[local + 1] - first;
+	return *count > 0 ? &chunk.edges[first] : NULL;
+}
+
+int NavGraph::standing_cell(float x, float y, int origin_x, int origin_y){
+	int tile_x = origin_x + (int)floorf(x / tile_size);
+	int tile_y = origin_y + (int)floorf(-y / tile_size);
+	if (tile_x < 0 || tile_x >= width || tile_y >= height){
+		return -1;
+	}
+	tile_y = std::max(0, tile_y);
+
+	//A character's centre is somewhere above the cell it stands in
+	while (tile_y < height && !solid[tile_y * width + tile_x]){
+		if (standing[tile_y * width + tile_x]){
+			return tile_y * width + tile_x;
+		}
+		tile_y++;
+	}
+	return -1;
+}
+
+bool NavGraph::find_path(float from_x, float from_y, float to_x, float to_y, std::vector<NavStep>& path, int origin_x, int origin_y){
+	path.clear();
+	int from = standing_cell(from_x, from_y, origin_x, origin_y);
+	int to = standing_cell(to_x, to_y, origin_x, origin_y);
+	if (from < 0 || to < 0){
+		return false;
+	}
+
+	cache_clock++;
+	for (int i = 0; i < cache.size(); i++){
+		CachedPath& cached = cache[i];
+		if (cached.from == from && cached.to == to && cached.generation == generation){
+			cached.last_used = cache_clock;
+			path = cached.path;
+			cache_hits++;
+			return cached.found;
+		}
+	}
+
+	bool found = search(from, to, path);
+
+	//Replace a stale or the least recently used entry
+	CachedPath* slot = NULL;
+	if (cache.size() < cache_size){
+		cache.push_back(CachedPath());
+		slot = &cache.back();
+	}
+	else{
+		slot = &cache[0];
+		for (int i = 0; i < cache.size(); i++){
+			if (cache[i].generation != generation){
+				slot = &cache[i];
+				break;
+			}
+			if (cache[i].last_used < slot->last_used){
+				slot = &cache[i];
+			}
+		}
+	}
+	slot->from = from;
+	slot->to = to;
+	slot->generation = generation;
+	slot->last_used = cache_clock;
+	slot->found = found;
+	slot->path = path;
+	return found;
+}
+
+bool NavGraph::search(int from, int to, std::vector<NavStep>& path){
+	searches++;
+	last_expanded = 0;
+
+	//A new stamp invalidates every node's g_cost and parent at once
+	stamp++;
+	if (stamp == 0){
+		std::fill(visit_stamp.begin(), visit_stamp.end(), 0);
+		stamp = 1;
+	}
+
+	int goal_x = to % width;
+	int goal_y = to / width;
+	auto heuristic = [&](int cell){
+		//Every edge costs at least the straight line, so this never overestimates
+		float dx = (float)(cell % width - goal_x);
+		float dy = (float)(cell / width - goal_y);
+		return sqrtf(dx * dx + dy * dy);
+	};
+	auto later = [](const std::pair<float, int>& a, const std::pair<float, int>& b){
+		return a.first > b.first;
+	};
+
+	open.clear();
+	visit_stamp[from] = stamp;
+	g_cost[from] = 0;
+	parent[from] = -1;
+	closed[from] = false;
+	open.push_back(std::make_pair(heuristic(from), from));
+
+	while (!open.empty()){
+		std::pop_heap(open.begin(), open.end(), later);
+		int cell = open.back().second;
+		open.pop_back();
+		if (closed[cell]){
+			continue;
+		}
+		closed[cell] = true;
+		last_expanded++;
+
+		if (cell == to){
+			for (int at = to; at != from; at = parent[at]){
+				NavStep step = { at % width, at / width, (NavEdgeType)parent_edge_type[at], parent_speed[at] };
+				path.push_back(step);
+			}
+			std::reverse(path.begin(), path.end());
+			return true;
+		}
+
+		int count;
+		const NavEdge* edges = edges_of(cell, &count);
+		for (int i = 0; i < count; i++){
+			const NavEdge& edge = edges[i];
+			float cost = g_cost[cell] + edge.cost;
+			if (visit_stamp[edge.to] == stamp && (closed[edge.to] || g_cost[edge.to] <= cost)){
+				continue;
+			}
+
+			if (visit_stamp[edge.to] != stamp){
+				visit_stamp[edge.to] = stamp;
+				closed[edge.to] = false;
+			}
+			g_cost[edge.to] = cost;
+			parent[edge.to] = cell;
+			parent_edge_type[edge.to] = edge.type;
+			parent_speed[edge.to] = edge.speed_x;
+			open.push_back(std::make_pair(cost + heuristic(edge.to), edge.to));
+			std::push_heap(open.begin(), open.end(), later);
+		}
+	}
+	return false;
+}
+
+int NavGraph::node_count(){
+	int count = 0;
+	for (int i = 0; i < standing.size(); i++){
+		if (standing[i]){
+			count++;
+		}
+	}
+	return count;
+}
+
+int NavGraph::edge_count(){
+	int count = 0;
+	for (int i = 0; i < chunks.size(); i++){
+		count += chunks[i].edges.size();
+	}
+	return count;
+}
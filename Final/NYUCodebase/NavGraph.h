@@ -0,0 +1,125 @@
+#ifndef NAVGRAPH_H
+#define NAVGRAPH_H
+
+#include <vector>
+#include "FlareMap.h"
+
+enum NavEdgeType { NAV_WALK, NAV_FALL, NAV_JUMP };
+
+struct NavEdge{
+	int to; //cell index
+	NavEdgeType type;
+	float cost;
+	float speed_x; //run speed to leave with, world units/s, signed
+};
+
+struct NavStep{
+	int tile_x;
+	int tile_y;
+	NavEdgeType type; //how this cell was reached
+	float speed_x;
+};
+
+//Platformer navigation over the collision layer. Nodes are the cells a
+//character can stand in (empty, solid underneath). Edges are walks to a
+//neighbouring cell (one tile up or down allowed), falls off ledges and
+//jumps, both found by stepping the same ballistics GameObject uses: jump
+//velocity 4.8, gravity -11.0, run speed 3.2, at the fixed timestep.
+//
+//Edges are stored per chunk of columns. Editing the map only rebuilds the
+//chunks whose falls or jumps pass over the edited column.
+//
+//find_path is A* with node arrays kept between searches (a stamp marks
+//which entries belong to the current search) and a small LRU cache of
+//recent paths, dropped whenever the graph changes.
+//
+//Groundwork for now: nothing calls find_path yet. Ground spikes can't jump
+//and follow the FlowField, greymon doesn't move. The graph is built and kept
+//current with the map so a jumping enemy only has to follow the path.
+class NavGraph{
+public:
+	float jump_speed = 4.8f;
+	float gravity = -11.0f;
+	float run_speed = 3.2f;
+	float timestep = 0.0166666f;
+	float max_air_time = 3.0f;
+	int clearance = 2; //tiles of headroom a jump or fall needs
+	int chunk_columns = 16;
+	int cache_size = 16;
+
+	//CPU only, safe on the prefetch thread
+	void build(const FlareMap& map, int layer, float tile_size);
+	//After a collision edit at column x; the rebuild waits for update()
+	void invalidate_column(int x);
+	//Rebuilds dirty chunks. Returns how many were rebuilt.
+	int update(const FlareMap& map);
+
+	//Positions relative to tile origin_x, origin_y (App's floating origin),
+	//like CollisionMesh::query_box. Path runs from the cell after the start
+	//to the goal, in map tiles.
+	bool find_path(float from_x, float from_y, float to_x, float to_y, std::vector<NavStep>& path, int origin_x = 0, int origin_y = 0);
+
+	int node_count();
+	int edge_count();
+	int cache_hits = 0;
+	int searches = 0;
+	int last_expanded = 0; //nodes popped by the last uncached search
+
+private:
+	//Reads edges cell by cell to compare an incrementally updated graph with a fresh build
+	friend struct NavGraphTest;
+
+	struct Chunk{
+		int first_column = 0;
+		int columns = 0;
+		std::vector<int> first_edge; //per cell in the chunk plus one, cells column major
+		std::vector<NavEdge> edges;
+		//Columns the chunk's falls and jumps fly over
+		int reach_min = 0;
+		int reach_max = 0;
+		bool dirty = true;
+	};
+
+	int width = 0;
+	int height = 0;
+	float tile_size = 0.18f;
+	int layer = 3;
+	std::vector<unsigned char> solid;
+	std::vector<bool> standing;
+	std::vector<Chunk> chunks;
+	std::vector<int> dirty_columns;
+	unsigned int generation = 0;
+
+	//A* scratch, reused between searches
+	std::vector<float> g_cost;
+	std::vector<int> parent;
+	std::vector<unsigned char> parent_edge_type;
+	std::vector<float> parent_speed;
+	std::vector<unsigned int> visit_stamp;
+	std::vector<bool> closed;
+	std::vector<std::pair<float, int>> open;
+	unsigned int stamp = 0;
+
+	struct CachedPath{
+		int from;
+		int to;
+		unsigned int generation;
+		unsigned int last_used;
+		bool found;
+		std::vector<NavStep> path;
+	};
+	std::vector<CachedPath> cache;
+	unsigned int cache_clock = 0;
+
+	bool is_solid(int x, int y);
+	void read_map(const FlareMap& map, int first_column, int columns);
+	void build_chunk(Chunk& chunk);
+	void add_edge(std::vector<NavEdge>& edges, int first, int to, NavEdgeType type, float cost, float speed_x);
+	//Steps an arc from feet at (x, y) in tile units. Returns the standing cell it lands in, or -1.
+	int fly(float x, float y, float speed_x, float speed_y, int* reach_min, int* reach_max);
+	int standing_cell(float x, float y, int origin_x, int origin_y);
+	const NavEdge* edges_of(int cell, int* count);
+	bool search(int from, int to, std::vector<NavStep>& path);
+};
+
+#endif
@@ -20,8 +20,6 @@ public:
 	Script();
 	Script(GameObject* go);
 
-	float last_check = 0;
-
 	virtual void update();
 	virtual void on_event(const std::string& event_name);
 
@@ -0,0 +1,311 @@
+#include "SdfFont.h"
+#include "stb_image.h"
+#include <fstream>
+#include <algorithm>
+#include <math.h>
+
+static const float SDF_INF = 1e20f;
+
+//Felzenszwalb & Huttenlocher squared distance transform along one row/column
+static void distance_transform_1d(const float* f, int n, float* d, int* v, float* z){
+	int k = 0;
+	v[0] = 0;
+	z[0] = -SDF_INF;
+	z[1] = SDF_INF;
+	for (int q = 1; q < n; q++){
+		float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+		while (s <= z[k]){
+			k--;
+			s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = SDF_INF;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++){
+		while (z[k + 1] < q){
+			k++;
+		}
+		d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+	}
+}
+
+//grid holds 0 on feature pixels and SDF_INF elsewhere, and ends up with the squared distance to the nearest feature
+static void distance_transform_2d(std::vector<float>& grid, int w, int h){
+	int n = std::max(w, h);
+	std::vector<float> f(n), d(n), z(n + 1);
+	std::vector<int> v(n);
+
+	for (int x = 0; x < w; x++){
+		for (int y = 0; y < h; y++){
+			f[y] = grid[y * w + x];
+		}
+		distance_transform_1d(&f[0], h, &d[0], &v[0], &z[0]);
+		for (int y = 0; y < h; y++){
+			grid[y * w + x] = d[y];
+		}
+	}
+
+	for (int y = 0; y < h; y++){
+		distance_transform_1d(&grid[y * w], w, &d[0], &v[0], &z[0]);
+		std::copy(d.begin(), d.begin() + w, grid.begin() + y * w);
+	}
+}
+
+void SdfFont::compute_field(const unsigned char* rgba, int w, int h){
+	std::vector<float> outside(w * h);
+	std::vector<float> inside(w * h);
+	for (int i = 0; i < w * h; i++){
+		bool ink = rgba[i * 4 + 3] >= 128;
+		outside[i] = ink ? 0 : SDF_INF;
+		inside[i] = ink ? SDF_INF : 0;
+	}
+
+	distance_transform_2d(outside, w, h);
+	distance_transform_2d(inside, w, h);
+
+	field.resize(w * h);
+	for (int i = 0; i < w * h; i++){
+		//Negative inside the glyph
+		float signed_distance = sqrtf(outside[i]) - sqrtf(inside[i]);
+		float value = 0.5f - signed_distance / (2.0f * spread);
+		value = std::min(1.0f, std::max(0.0f, value));
+		field[i] = (unsigned char)(value * 255.0f + 0.5f);
+	}
+}
+
+void SdfFont::compute_metrics(const unsigned char* rgba, int w, int h){
+	int cell_w = w / 16;
+	int cell_h = h / 16;
+
+	for (int index = 0; index < 256; index++){
+		int cell_x = (index % 16) * cell_w;
+		int cell_y = (index / 16) * cell_h;
+
+		int first = -1;
+		int last = -1;
+		for (int x = 0; x < cell_w; x++){
+			for (int y = 0; y < cell_h; y++){
+				if (rgba[((cell_y + y) * w + cell_x + x) * 4 + 3] >= 128){
+					if (first < 0){
+						first = x;
+					}
+					last = x;
+					break;
+				}
+			}
+		}
+
+		if (first < 0){
+			//Empty cell, e.g. space
+			glyphs[index].left = 0;
+			glyphs[index].advance = 0.35f;
+		}
+		else{
+			//One pixel of padding on each side of the ink
+			glyphs[index].left = (float)first / cell_w;
+			glyphs[index].advance = (float)(last - first + 3) / cell_w;
+		}
+	}
+}
+
+bool SdfFont::generate(const std::string& sheet_path){
+	int w, h, comp;
+	unsigned char* image = stbi_load(sheet_path.c_str(), &w, &h, &comp, STBI_rgb_alpha);
+	if (image == NULL){
+		std::cout << "Unable to load font sheet " << sheet_path << std::endl;
+		return false;
+	}
+
+	texture_width = w;
+	texture_height = h;
+	compute_metrics(image, w, h);
+	compute_field(image, w, h);
+
+	stbi_image_free(image);
+	return true;
+}
+
+//Cooked layout: "SDF1", width, height, spread, 256 x (left, advance), width * height distance bytes
+bool SdfFont::save(const std::string& cooked_path){
+	std::ofstream out(cooked_path, std::ios::binary);
+	if (!out){
+		return false;
+	}
+
+	out.write("SDF1", 4);
+	out.write((const char*)&texture_width, sizeof(int));
+	out.write((const char*)&texture_height, sizeof(int));
+	out.write((const char*)&spread, sizeof(float));
+	for (int i = 0; i < 256; i++){
+		out.write((const char*)&glyphs[i].left, sizeof(float));
+		out.write((const char*)&glyphs[i].advance, sizeof(float));
+	}
+	out.write((const char*)field.data(), field.size());
+	return out.good();
+}
+
+bool SdfFont::read_cooked(const std::string& cooked_path){
+	std::ifstream in(cooked_path, std::ios::binary);
+	if (!in){
+		return false;
+	}
+
+	char magic[4];
+	in.read(magic, 4);
+	if (!in || std::string(magic, 4) != "SDF1"){
+		return false;
+	}
+
+	in.read((char*)&texture_width, sizeof(int));
+	in.read((char*)&texture_height, sizeof(int));
+	in.read((char*)&spread, sizeof(float));
+	for (int i = 0; i < 256; i++){
+		in.read((char*)&glyphs[i].left, sizeof(float));
+		in.read((char*)&glyphs[i].advance, sizeof(float));
+	}
+
+	if (!in || texture_width <= 0 || texture_height <= 0){
+		return false;
+	}
+
+	field.resize(texture_width * texture_height);
+	in.read((char*)&field[0], field.size());
+	return (bool)in;
+}
+
+bool SdfFont::prepare(const std::string& sheet_path, const std::string& cooked_path){
+	//Cached layouts used the old metrics
+	text_cache.clear();
+	if (!read_cooked(cooked_path)){
+		if (!generate(sheet_path)){
+			return false;
+		}
+		save(cooked_path);
+	}
+
+	return true;
+}
+
+bool SdfFont::load(const std::string& sheet_path, const std::string& cooked_path, TextureManager& textures){
+	if (!prepare(sheet_path, cooked_path)){
+		return false;
+	}
+
+	upload(textures);
+	return true;
+}
+
+void SdfFont::upload(TextureManager& textures_){
+	textures = &textures_;
+	//One byte per texel
+	texture = textures->create("sdf font", texture_width, texture_height, texture_width * texture_height);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, texture_width, texture_height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, field.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	//The field has to be filtered, nearest sampling would bring the pixels back
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+
+	//Only needed on the GPU from here on
+	field.clear();
+	field.shrink_to_fit();
+}
+
+float SdfFont::text_width(const std::string& text, float size, float tracking){
+	float width = 0;
+	for (int i = 0; i < text.size(); i++){
+		width += glyphs[(unsigned char)text[i]].advance * size + tracking;
+	}
+	return width;
+}
+
+void SdfFont::begin(){
+	verts.clear();
+	tex_coords.clear();
+}
+
+void SdfFont::add_text(const std::string& text, float x, float y, float size, float tracking){
+	bool hit;
+	TextMesh& mesh = text_cache.get(text, x, y, size, tracking, hit);
+	if (!hit){
+		build_text(mesh, text, x, y, size, tracking);
+	}
+
+	verts.insert(verts.end(), mesh.verts.begin(), mesh.verts.end());
+	tex_coords.insert(tex_coords.end(), mesh.tex_coords.begin(), mesh.tex_coords.end());
+}
+
+void SdfFont::build_text(TextMesh& mesh, const std::string& text, float x, float y, float size, float tracking){
+	float texture_size = 1.0f / 16.0f;
+	float half = 0.5f * size;
+	mesh.verts.reserve(text.size() * 12);
+	mesh.tex_coords.reserve(text.size() * 12);
+
+	//Pen starts at the left edge of the first cell
+	float pen = x - half;
+	for (int i = 0; i < text.size(); i++){
+		int index = (unsigned char)text[i];
+		const GlyphMetrics& glyph = glyphs[index];
+		float texture_x = (float)(index % 16) / 16.0f;
+		float texture_y = (float)(index / 16) / 16.0f;
+
+		//Shift the cell so its ink starts at the pen
+		float left = pen - glyph.left * size;
+		float right = left + size;
+
+		mesh.verts.insert(mesh.verts.end(), {
+			left, y + half,
+			left, y - half,
+			right, y + half,
+			right, y - half,
+			right, y + half,
+			left, y - half,
+		});
+
+		mesh.tex_coords.insert(mesh.tex_coords.end(), {
+			texture_x, texture_y,
+			texture_x, texture_y + texture_size,
+			texture_x + texture_size, texture_y,
+			texture_x + texture_size, texture_y + texture_size,
+			texture_x + texture_size, texture_y,
+			texture_x, texture_y + texture_size
+		});
+
+		pen += glyph.advance * size + tracking;
+	}
+}
+
+void SdfFont::flush(ShaderProgram* program, const Matrix& projection, const Matrix& view, float r, float g, float b, float a){
+	if (verts.empty()){
+		return;
+	}
+
+	//Positions are already in world space
+	Matrix identity;
+	program->SetModelMatrix(identity);
+	program->SetProjectionMatrix(projection);
+	program->SetViewMatrix(view);
+	program->SetColor(r, g, b, a);
+
+	textures->bind(texture);
+
+	glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, verts.data());
+	glEnableVertexAttribArray(program->positionAttribute);
+
+	glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, tex_coords.data());
+	glEnableVertexAttribArray(program->texCoordAttribute);
+
+	glDrawArrays(GL_TRIANGLES, 0, verts.size() / 2);
+	draw_calls++;
+
+	glDisableVertexAttribArray(program->positionAttribute);
+	glDisableVertexAttribArray(program->texCoordAttribute);
+
+	begin();
+}
@@ -0,0 +1,73 @@
+#ifndef SDFFONT_H
+#define SDFFONT_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+
+#include "ShaderProgram.h"
+#include "TextureManager.h"
+#include "TextMeshCache.h"
+
+//Per glyph metrics, in fractions of one cell (1 = the font size)
+struct GlyphMetrics{
+	float left = 0; //first column with ink
+	float advance = 0.5f; //how far the pen moves after this glyph
+};
+
+//Signed distance field version of the 16x16 ASCII font sheet.
+//One texture renders at any size, glyphs get proportional advances, and
+//every add_text between begin() and flush() goes out in a single draw call.
+class SdfFont{
+public:
+	GLuint texture = 0;
+	int texture_width = 0;
+	int texture_height = 0;
+	float spread = 4.0f; //pixels of distance stored on each side of an edge
+	GlyphMetrics glyphs[256];
+
+	int draw_calls = 0;
+
+	//Laid out glyph quads, so a string that stays put is copied into the batch instead of rebuilt
+	TextMeshCache text_cache;
+
+	//Loads cooked_path if it exists, otherwise generates the field from
+	//sheet_path and writes cooked_path so later runs skip the generation.
+	//The atlas is created and bound through textures.
+	bool load(const std::string& sheet_path, const std::string& cooked_path, TextureManager& textures);
+
+	//load() split in two: prepare does the file work and can run on any
+	//thread, upload needs the GL context
+	bool prepare(const std::string& sheet_path, const std::string& cooked_path);
+	void upload(TextureManager& textures);
+
+	//Offline step: font sheet -> distance field + metrics
+	bool generate(const std::string& sheet_path);
+	bool save(const std::string& cooked_path);
+
+	float text_width(const std::string& text, float size, float tracking = 0.0f);
+
+	void begin();
+	//x, y is the center of the first glyph
+	void add_text(const std::string& text, float x, float y, float size, float tracking = 0.0f);
+	//What the next flush() draws, two floats per vertex
+	const std::vector<float>& batch_verts() const { return verts; }
+	const std::vector<float>& batch_tex_coords() const { return tex_coords; }
+	void flush(ShaderProgram* program, const Matrix& projection, const Matrix& view, float r = 1, float g = 1, float b = 1, float a = 1);
+
+private:
+	TextureManager* textures = NULL;
+	std::vector<unsigned char> field;
+	std::vector<float> verts;
+	std::vector<float> tex_coords;
+
+	bool read_cooked(const std::string& cooked_path);
+	void build_text(TextMesh& mesh, const std::string& text, float x, float y, float size, float tracking);
+	void compute_metrics(const unsigned char* rgba, int w, int h);
+	void compute_field(const unsigned char* rgba, int w, int h);
+};
+
+#endif
@@ -2,11 +2,15 @@
 #include "ShaderProgram.h"
 
 void ShaderProgram::Load(const char *vertexShaderFile, const char *fragmentShaderFile) {
+    LoadFromSource(ReadShaderFile(vertexShaderFile), ReadShaderFile(fragmentShaderFile));
+}
+
+void ShaderProgram::LoadFromSource(const std::string &vertexSource, const std::string &fragmentSource) {
     
     // create the vertex shader
-    vertexShader = LoadShaderFromFile(vertexShaderFile, GL_VERTEX_SHADER);
+    vertexShader = LoadShaderFromString(vertexSource, GL_VERTEX_SHADER);
     // create the fragment shader
-    fragmentShader = LoadShaderFromFile(fragmentShaderFile, GL_FRAGMENT_SHADER);
+    fragmentShader = LoadShaderFromString(fragmentSource, GL_FRAGMENT_SHADER);
     
     // Create the final shader program from our vertex and fragment shaders
     programID = glCreateProgram();
@@ -38,7 +42,7 @@ void ShaderProgram::Cleanup() {
     glDeleteShader(fragmentShader);
 }
 
-GLuint ShaderProgram::LoadShaderFromFile(const std::string &shaderFile, GLenum type) {
+std::string ShaderProgram::ReadShaderFile(const std::string &shaderFile) {
     //Open a file stream with the file name
     std::ifstream infile(shaderFile);
     
@@ -49,9 +53,12 @@ GLuint ShaderProgram::LoadShaderFromFile(const std::string &shaderFile, GLenum t
     //Create a string buffer and stream the file to it
     std::stringstream buffer;
     buffer << infile.rdbuf();
-    
+    return buffer.str();
+}
+
+GLuint ShaderProgram::LoadShaderFromFile(const std::string &shaderFile, GLenum type) {
     // Load the shader from the contents of the file
-    return LoadShaderFromString(buffer.str(), type);
+    return LoadShaderFromString(ReadShaderFile(shaderFile), type);
 }
 
 GLuint ShaderProgram::LoadShaderFromString(const std::string &shaderContents, GLenum type) {
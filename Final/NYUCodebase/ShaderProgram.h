@@ -13,6 +13,9 @@
 class ShaderProgram {
     public:
 	void Load(const char *vertexShaderFile, const char *fragmentShaderFile);
+	//Same as Load, for sources that were already read (e.g. on another thread)
+	void LoadFromSource(const std::string &vertexSource, const std::string &fragmentSource);
+	static std::string ReadShaderFile(const std::string &shaderFile);
 	void Cleanup();   
 
         void SetModelMatrix(const Matrix &matrix);
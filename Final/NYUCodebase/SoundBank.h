@@ -0,0 +1,103 @@
+#ifndef SOUNDBANK_H
+#define SOUNDBANK_H
+
+#include <SDL_mixer.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+typedef int SoundId;
+#define NO_SOUND -1
+
+//The mixer calls the audio thread makes. SDL_mixer by default, tests swap
+//in fakes so the bank runs without an audio device.
+struct SoundMixer{
+	int(*allocate_channels)(int count);
+	int(*play_channel)(int channel, Mix_Chunk* chunk);
+	bool(*playing)(int channel);
+	void(*free_chunk)(Mix_Chunk* chunk);
+};
+
+//Sound effects by id. Names are resolved once at load time, play() only
+//does a lock-free push onto a command queue that the bank's audio thread
+//polls and turns into Mix_PlayChannel calls. That thread owns the voices: each sound
+//has a voice cap, and when every channel is busy a new sound steals the
+//oldest voice of equal or lower priority.
+class SoundBank{
+public:
+	SoundBank();
+	~SoundBank();
+
+	SoundMixer mixer;
+
+	//Load everything before start()
+	SoundId load(const std::string& name, const std::string& path, int max_voices = 2, int priority = 0);
+	//For a chunk loaded elsewhere, the bank frees it in stop()
+	SoundId add(const std::string& name, Mix_Chunk* chunk, int max_voices = 2, int priority = 0);
+	SoundId find(const std::string& name);
+
+	//After Mix_OpenAudio. Allocates voice_count mixer channels.
+	void start(int voice_count = 16);
+	//Stops the audio thread and frees the chunks
+	void stop();
+
+	//Any thread, never blocks. A sound played more than once in the same tick plays once.
+	void play(SoundId id);
+
+	//Once per simulation tick
+	void end_tick();
+
+	std::atomic<int> played;
+	std::atomic<int> coalesced;
+	std::atomic<int> stolen;
+	std::atomic<int> dropped;
+
+private:
+	struct Sound{
+		std::string name;
+		Mix_Chunk* chunk;
+		int max_voices;
+		int priority;
+		std::atomic<unsigned int> queued_tick;
+	};
+	std::vector<std::unique_ptr<Sound>> sounds;
+
+	std::atomic<unsigned int> tick;
+
+	//Bounded multi producer, single consumer ring. Each slot's sequence
+	//says whether it is free for the producer at that position or holds a
+	//command for the consumer.
+	static const unsigned int QUEUE_SIZE = 256;
+	struct Command{
+		std::atomic<unsigned int> sequence;
+		SoundId sound;
+	};
+	Command commands[QUEUE_SIZE];
+	std::atomic<unsigned int> enqueue_pos;
+	unsigned int dequeue_pos = 0;
+
+	bool push(SoundId id);
+	bool pop(SoundId& id);
+
+	//Audio thread only
+	struct Voice{
+		SoundId sound = NO_SOUND;
+		int priority = 0;
+		unsigned int started = 0;
+	};
+	std::vector<Voice> voices;
+	unsigned int voice_clock = 0;
+	void start_voice(SoundId id);
+
+	std::thread audio_thread;
+	std::mutex wake_lock;
+	std::condition_variable wake;
+	std::atomic<bool> stopping;
+	void audio_loop();
+};
+
+#endif
@@ -1,8 +1,9 @@
 #include "Sprite.h";
 #include "App.h";
+#include "Transform2D.h"
 
 Sprite::Sprite(const std::string& file_path){
-	texture_id = app->LoadTexture(file_path.c_str(), &width, &height);
+	texture_id = App::LoadTexture(file_path.c_str(), &width, &height);
 
 	aspect_ratio = (width*1.0f) / (height*1.0f);
 	x_size *= aspect_ratio;
@@ -138,12 +139,9 @@ void Sprite::set_app(std::shared_ptr<App> app_){
 
 void Sprite::draw(){
 	if (update_position){
-		app->tex_program->SetModelMatrix(app->modelMatrix);
 		app->tex_program->SetProjectionMatrix(app->projectionMatrix);
-		app->tex_program->SetViewMatrix(app->viewMatrix);
 
-		app->modelMatrix.Identity();
-		app->modelMatrix.Translate(x, y, z);
+		app->modelMatrix = Transform2D::translate(x, y).to_matrix(z);
 		app->tex_program->SetModelMatrix(app->modelMatrix);
 		app->tex_program->SetViewMatrix(app->viewMatrix);
 
@@ -176,7 +174,7 @@ void Sprite::draw(){
 	//glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 
-	glBindTexture(GL_TEXTURE_2D, texture_id);
+	app->textures.bind(texture_id);
 	glDrawArrays(GL_TRIANGLES, 0, 6);
 
 	glDisableVertexAttribArray(app->tex_program->positionAttribute);
@@ -0,0 +1,51 @@
+#include "StartupProfile.h"
+#include <iostream>
+#include <stdio.h>
+
+void StartupProfile::start(){
+	boot_start = SDL_GetPerformanceCounter();
+}
+
+Uint64 StartupProfile::now(){
+	return SDL_GetPerformanceCounter();
+}
+
+float StartupProfile::to_ms(Uint64 ticks){
+	return (float)((double)ticks * 1000.0 / (double)SDL_GetPerformanceFrequency());
+}
+
+void StartupProfile::record(const std::string& name, Uint64 since){
+	Uint64 until = now();
+
+	Step step;
+	step.name = name;
+	step.start_ms = to_ms(since - boot_start);
+	step.duration_ms = to_ms(until - since);
+
+	std::lock_guard<std::mutex> guard(lock);
+	steps.push_back(step);
+}
+
+void StartupProfile::first_frame(){
+	if (reported){
+		return;
+	}
+
+	reported = true;
+	time_to_first_frame_ms = to_ms(now() - boot_start);
+	print();
+}
+
+void StartupProfile::print(){
+	std::lock_guard<std::mutex> guard(lock);
+
+	std::cout << "Startup breakdown (start / duration, ms):" << std::endl;
+	for (int x = 0; x < steps.size(); x++){
+		printf("  %-28s %8.1f %8.1f\n", steps[x].name.c_str(), steps[x].start_ms, steps[x].duration_ms);
+	}
+
+	printf("  %-28s %8.1f (target %.0f)\n", "time to first frame", time_to_first_frame_ms, target_ms);
+	if (time_to_first_frame_ms > target_ms){
+		std::cout << "WARNING: time to first frame is over target" << std::endl;
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <mutex>
+
+//Times each boot step (some run on other threads) and the time to the first
+//presented frame, then prints the breakdown once that frame is out.
+class StartupProfile{
+public:
+	float target_ms = 1000.0f; //time to first frame we want to stay under
+	float time_to_first_frame_ms = 0;
+
+	void start();
+	Uint64 now();
+
+	//Records a step that ran from since until now. Safe to call from any thread.
+	void record(const std::string& name, Uint64 since);
+
+	//Call right after the first SDL_GL_SwapWindow
+	void first_frame();
+
+	void print();
+
+private:
+	struct Step{
+		std::string name;
+		float start_ms;
+		float duration_ms;
+	};
+
+	std::mutex lock;
+	std::vector<Step> steps;
+	Uint64 boot_start = 0;
+	bool reported = false;
+
+	float to_ms(Uint64 ticks);
+};
+
+#endif
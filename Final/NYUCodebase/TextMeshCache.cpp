@@ -0,0 +1,62 @@
+#include "TextMeshCache.h"
+#include <string.h>
+
+std::string TextMeshCache::make_key(const std::string& text, float x, float y, float size, float tracking){
+	//Raw float bytes up front, so a text can never be mistaken for the numbers part
+	float numbers[4] = { x, y, size, tracking };
+	std::string key(sizeof(numbers), '\0');
+	memcpy(&key[0], numbers, sizeof(numbers));
+	key += text;
+	return key;
+}
+
+TextMesh& TextMeshCache::get(const std::string& text, float x, float y, float size, float tracking, bool& hit){
+	std::string key = make_key(text, x, y, size, tracking);
+
+	auto found = lookup.find(key);
+	if (found != lookup.end()){
+		hits++;
+		hit = true;
+		entries.splice(entries.begin(), entries, found->second);
+		return found->second->mesh;
+	}
+
+	misses++;
+	hit = false;
+
+	if (max_entries > 0 && entries.size() >= max_entries){
+		//Recycle the least recently used entry so its buffers keep their capacity
+		evictions++;
+		lookup.erase(entries.back().key);
+		entries.splice(entries.begin(), entries, --entries.end());
+	}
+	else{
+		entries.push_front(Entry());
+	}
+
+	Entry& entry = entries.front();
+	entry.key = key;
+	entry.mesh.verts.clear();
+	entry.mesh.tex_coords.clear();
+	entry.mesh.glyph_count = text.size();
+	rebuilt_glyphs += text.size();
+	lookup[key] = entries.begin();
+
+	return entry.mesh;
+}
+
+void TextMeshCache::reset_stats(){
+	hits = 0;
+	misses = 0;
+	rebuilt_glyphs = 0;
+	evictions = 0;
+}
+
+void TextMeshCache::clear(){
+	entries.clear();
+	lookup.clear();
+}
+
+int TextMeshCache::size(){
+	return entries.size();
+}
@@ -0,0 +1,48 @@
+#ifndef TEXTMESHCACHE_H
+#define TEXTMESHCACHE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+
+//Glyph quads for one string, already at its place on screen
+struct TextMesh{
+	std::vector<float> verts;
+	std::vector<float> tex_coords;
+	int glyph_count = 0;
+};
+
+//Keeps built text meshes keyed by (text, position, size, tracking) so static
+//strings are only laid out once. Least recently used meshes are evicted past max_entries.
+class TextMeshCache{
+public:
+	int max_entries = 64;
+
+	//Counters, reset with reset_stats()
+	int hits = 0;
+	int misses = 0;
+	int rebuilt_glyphs = 0;
+	int evictions = 0;
+
+	//The cached mesh. On a miss hit is false and the mesh comes back empty for the caller to build.
+	TextMesh& get(const std::string& text, float x, float y, float size, float tracking, bool& hit);
+
+	void reset_stats();
+	void clear();
+	int size();
+
+private:
+	struct Entry{
+		std::string key;
+		TextMesh mesh;
+	};
+
+	//Front is the most recently used
+	std::list<Entry> entries;
+	std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+
+	static std::string make_key(const std::string& text, float x, float y, float size, float tracking);
+};
+
+#endif
@@ -0,0 +1,683 @@
+#include "TextureCooker.h"
+#include "stb_image.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+#include <sys/stat.h>
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+float TextureCooker::block_error_limit = 6.0f;
+
+static int block_bytes(TextureFormat format){
+	return format == TEXTURE_BC1 ? 8 : 16;
+}
+
+static int mip_size(int w, int h, TextureFormat format){
+	switch (format){
+	case TEXTURE_RGBA8:
+		return w * h * 4;
+	case TEXTURE_RGBA4444:
+	case TEXTURE_RGB565:
+		return w * h * 2;
+	default:
+		return ((w + 3) / 4) * ((h + 3) / 4) * block_bytes(format);
+	}
+}
+
+int CookedTexture::byte_size() const {
+	int size = 0;
+	for (int i = 0; i < mips.size(); i++){
+		size += mips[i].data.size();
+	}
+	return size;
+}
+
+int CookedTexture::baseline_size() const {
+	return width * height * 4;
+}
+
+int CookedTexture::rgba8_size() const {
+	int size = 0;
+	for (int i = 0; i < mips.size(); i++){
+		size += mips[i].width * mips[i].height * 4;
+	}
+	return size;
+}
+
+static unsigned char expand5(int v){
+	return (unsigned char)((v << 3) | (v >> 2));
+}
+
+static unsigned char expand6(int v){
+	return (unsigned char)((v << 2) | (v >> 4));
+}
+
+static unsigned short pack565(int r, int g, int b){
+	return (unsigned short)((((r * 31 + 127) / 255) << 11) | (((g * 63 + 127) / 255) << 5) | ((b * 31 + 127) / 255));
+}
+
+static void unpack565(unsigned short c, int* rgb){
+	rgb[0] = expand5((c >> 11) & 31);
+	rgb[1] = expand6((c >> 5) & 63);
+	rgb[2] = expand5(c & 31);
+}
+
+//Alpha weighted 2x2 box filter, so transparent texels don't darken the edges
+static void downsample(const TextureMip& src, TextureMip& dst){
+	dst.width = std::max(1, src.width / 2);
+	dst.height = std::max(1, src.height / 2);
+	dst.data.resize(dst.width * dst.height * 4);
+
+	for (int y = 0; y < dst.height; y++){
+		for (int x = 0; x < dst.width; x++){
+			int sum[4] = { 0, 0, 0, 0 };
+			for (int i = 0; i < 4; i++){
+				int sx = std::min(x * 2 + (i & 1), src.width - 1);
+				int sy = std::min(y * 2 + (i >> 1), src.height - 1);
+				const unsigned char* p = &src.data[(sy * src.width + sx) * 4];
+				sum[0] += p[0] * p[3];
+				sum[1] += p[1] * p[3];
+				sum[2] += p[2] * p[3];
+				sum[3] += p[3];
+			}
+
+			unsigned char* out = &dst.data[(y * dst.width + x) * 4];
+			for (int c = 0; c < 3; c++){
+				out[c] = sum[3] > 0 ? (unsigned char)(sum[c] / sum[3]) : 0;
+			}
+			out[3] = (unsigned char)((sum[3] + 2) / 4);
+		}
+	}
+}
+
+//Root mean square error over the visible texels after a round trip through format
+static float format_error(const unsigned char* rgba, int w, int h, TextureFormat format){
+	TextureMip mip;
+	mip.width = w;
+	mip.height = h;
+	TextureCooker::encode(rgba, w, h, format, mip.data);
+
+	std::vector<unsigned char> decoded;
+	TextureCooker::decode(mip, format, decoded);
+
+	double error = 0;
+	int count = 0;
+	for (int i = 0; i < w * h; i++){
+		if (rgba[i * 4 + 3] == 0 && decoded[i * 4 + 3] == 0){
+			continue;
+		}
+		for (int c = 0; c < 4; c++){
+			int difference = rgba[i * 4 + c] - decoded[i * 4 + c];
+			error += difference * difference;
+		}
+		count += 4;
+	}
+	return count > 0 ? (float)sqrt(error / count) : 0.0f;
+}
+
+TextureFormat TextureCooker::choose_format(const unsigned char* rgba, int w, int h){
+	bool opaque = true;
+	bool binary_alpha = true;
+	for (int i = 0; i < w * h; i++){
+		unsigned char a = rgba[i * 4 + 3];
+		opaque = opaque && a == 255;
+		binary_alpha = binary_alpha && (a == 0 || a == 255);
+	}
+
+	TextureFormat block_format = binary_alpha ? TEXTURE_BC1 : TEXTURE_BC3;
+	if (format_error(rgba, w, h, block_format) <= block_error_limit){
+		return block_format;
+	}
+
+	//Pixel art with hard outlines falls apart in 4x4 blocks, but loses
+	//nothing visible at 16 bits as long as there is no alpha gradient
+	if (binary_alpha){
+		return opaque ? TEXTURE_RGB565 : TEXTURE_RGBA4444;
+	}
+
+	return TEXTURE_RGBA8;
+}
+
+//Picks endpoints along the block's bounding box diagonal, flipped to follow the color spread
+static void block_endpoints(const int block[16][4], const bool* use, int* lo, int* hi){
+	int min_c[3] = { 255, 255, 255 };
+	int max_c[3] = { 0, 0, 0 };
+	int mean[3] = { 0, 0, 0 };
+	int count = 0;
+	for (int i = 0; i < 16; i++){
+		if (!use[i]){
+			continue;
+		}
+		for (int c = 0; c < 3; c++){
+			min_c[c] = std::min(min_c[c], block[i][c]);
+			max_c[c] = std::max(max_c[c], block[i][c]);
+			mean[c] += block[i][c];
+		}
+		count++;
+	}
+
+	if (count == 0){
+		for (int c = 0; c < 3; c++){
+			lo[c] = hi[c] = 0;
+		}
+		return;
+	}
+
+	int cov_rg = 0;
+	int cov_rb = 0;
+	for (int i = 0; i < 16; i++){
+		if (use[i]){
+			int r = block[i][0] * count - mean[0];
+			cov_rg += r * (block[i][1] * count - mean[1]);
+			cov_rb += r * (block[i][2] * count - mean[2]);
+		}
+	}
+
+	for (int c = 0; c < 3; c++){
+		//Inset a little, the extremes are rarely the best endpoints
+		int inset = (max_c[c] - min_c[c]) / 16;
+		lo[c] = min_c[c] + inset;
+		hi[c] = max_c[c] - inset;
+	}
+	if (cov_rg < 0){
+		std::swap(lo[1], hi[1]);
+	}
+	if (cov_rb < 0){
+		std::swap(lo[2], hi[2]);
+	}
+}
+
+static void encode_color_block(const int block[16][4], bool allow_transparent, unsigned char* out){
+	bool use[16];
+	bool any_transparent = false;
+	for (int i = 0; i < 16; i++){
+		use[i] = !allow_transparent || block[i][3] >= 128;
+		any_transparent = any_transparent || !use[i];
+	}
+
+	int lo[3], hi[3];
+	block_endpoints(block, use, lo, hi);
+	unsigned short c0 = pack565(hi[0], hi[1], hi[2]);
+	unsigned short c1 = pack565(lo[0], lo[1], lo[2]);
+
+	//c0 > c1 selects four colors, c0 <= c1 three colors plus transparent
+	if (any_transparent ? c0 > c1 : c0 < c1){
+		std::swap(c0, c1);
+	}
+
+	int palette[4][3];
+	unpack565(c0, palette[0]);
+	unpack565(c1, palette[1]);
+	int colors = 4;
+	for (int c = 0; c < 3; c++){
+		if (any_transparent){
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			colors = 3;
+		}
+		else{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+	}
+
+	unsigned int indices = 0;
+	if (c0 != c1 || any_transparent){
+		for (int i = 0; i < 16; i++){
+			int best = 3;
+			if (use[i]){
+				int best_distance = 0x7fffffff;
+				for (int p = 0; p < colors; p++){
+					int dr = block[i][0] - palette[p][0];
+					int dg = block[i][1] - palette[p][1];
+					int db = block[i][2] - palette[p][2];
+					int distance = dr * dr + dg * dg + db * db;
+					if (distance < best_distance){
+						best_distance = distance;
+						best = p;
+					}
+				}
+			}
+			indices |= best << (i * 2);
+		}
+	}
+
+	out[0] = c0 & 0xff;
+	out[1] = c0 >> 8;
+	out[2] = c1 & 0xff;
+	out[3] = c1 >> 8;
+	for (int i = 0; i < 4; i++){
+		out[4 + i] = (indices >> (i * 8)) & 0xff;
+	}
+}
+
+static void encode_alpha_block(const int block[16][4], unsigned char* out){
+	int a0 = 0;
+	int a1 = 255;
+	for (int i = 0; i < 16; i++){
+		a0 = std::max(a0, block[i][3]);
+		a1 = std::min(a1, block[i][3]);
+	}
+
+	//a0 > a1 selects eight interpolated steps
+	int palette[8];
+	palette[0] = a0;
+	palette[1] = a1;
+	for (int p = 1; p < 7; p++){
+		palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+	}
+
+	unsigned long long indices = 0;
+	if (a0 != a1){
+		for (int i = 0; i < 16; i++){
+			int best = 0;
+			for (int p = 1; p < 8; p++){
+				if (abs(block[i][3] - palette[p]) < abs(block[i][3] - palette[best])){
+					best = p;
+				}
+			}
+			indices |= (unsigned long long)best << (i * 3);
+		}
+	}
+
+	out[0] = (unsigned char)a0;
+	out[1] = (unsigned char)a1;
+	for (int i = 0; i < 6; i++){
+		out[2 + i] = (indices >> (i * 8)) & 0xff;
+	}
+}
+
+void TextureCooker::encode(const unsigned char* rgba, int w, int h, TextureFormat format, std::vector<unsigned char>& out){
+	out.resize(mip_size(w, h, format));
+
+	if (format == TEXTURE_RGBA8){
+		std::copy(rgba, rgba + w * h * 4, out.begin());
+		return;
+	}
+
+	if (format == TEXTURE_RGBA4444 || format == TEXTURE_RGB565){
+		unsigned short* texels = (unsigned short*)&out[0];
+		for (int i = 0; i < w * h; i++){
+			const unsigned char* p = &rgba[i * 4];
+			if (format == TEXTURE_RGBA4444){
+				texels[i] = (unsigned short)(((p[0] + 8) / 17 << 12) | ((p[1] + 8) / 17 << 8) | ((p[2] + 8) / 17 << 4) | ((p[3] + 8) / 17));
+			}
+			else{
+				texels[i] = pack565(p[0], p[1], p[2]);
+			}
+		}
+		return;
+	}
+
+	int blocks_x = (w + 3) / 4;
+	int blocks_y = (h + 3) / 4;
+	unsigned char* block_out = &out[0];
+	for (int by = 0; by < blocks_y; by++){
+		for (int bx = 0; bx < blocks_x; bx++){
+			//Edge blocks repeat the last row/column
+			int block[16][4];
+			for (int i = 0; i < 16; i++){
+				int x = std::min(bx * 4 + (i & 3), w - 1);
+				int y = std::min(by * 4 + (i >> 2), h - 1);
+				for (int c = 0; c < 4; c++){
+					block[i][c] = rgba[(y * w + x) * 4 + c];
+				}
+			}
+
+			if (format == TEXTURE_BC3){
+				encode_alpha_block(block, block_out);
+				encode_color_block(block, false, block_out + 8);
+			}
+			else{
+				encode_color_block(block, true, block_out);
+			}
+			block_out += block_bytes(format);
+		}
+	}
+}
+
+void TextureCooker::decode(const TextureMip& mip, TextureFormat format, std::vector<unsigned char>& rgba){
+	int w = mip.width;
+	int h = mip.height;
+	rgba.resize(w * h * 4);
+
+	if (format == TEXTURE_RGBA8){
+		rgba = mip.data;
+		return;
+	}
+
+	if (format == TEXTURE_RGBA4444 || format == TEXTURE_RGB565){
+		const unsigned short* texels = (const unsigned short*)mip.data.data();
+		for (int i = 0; i < w * h; i++){
+			unsigned short t = texels[i];
+			unsigned char* out = &rgba[i * 4];
+			if (format == TEXTURE_RGBA4444){
+				out[0] = ((t >> 12) & 15) * 17;
+				out[1] = ((t >> 8) & 15) * 17;
+				out[2] = ((t >> 4) & 15) * 17;
+				out[3] = (t & 15) * 17;
+			}
+			else{
+				int rgb[3];
+				unpack565(t, rgb);
+				out[0] = rgb[0];
+				out[1] = rgb[1];
+				out[2] = rgb[2];
+				out[3] = 255;
+			}
+		}
+		return;
+	}
+
+	int blocks_x = (w + 3) / 4;
+	int blocks_y = (h + 3) / 4;
+	const unsigned char* block = mip.data.data();
+	for (int by = 0; by < blocks_y; by++){
+		for (int bx = 0; bx < blocks_x; bx++){
+			const unsigned char* color = format == TEXTURE_BC3 ? block + 8 : block;
+
+			int alpha[16];
+			if (format == TEXTURE_BC3){
+				int palette[8];
+				palette[0] = block[0];
+				palette[1] = block[1];
+				for (int p = 1; p < 7; p++){
+					palette[p + 1] = block[0] > block[1] ? ((7 - p) * block[0] + p * block[1]) / 7 : 0;
+				}
+				if (block[0] <= block[1]){
+					for (int p = 1; p < 5; p++){
+						palette[p + 1] = ((5 - p) * block[0] + p * block[1]) / 5;
+					}
+					palette[6] = 0;
+					palette[7] = 255;
+				}
+
+				unsigned long long indices = 0;
+				for (int i = 0; i < 6; i++){
+					indices |= (unsigned long long)block[2 + i] << (i * 8);
+				}
+				for (int i = 0; i < 16; i++){
+					alpha[i] = palette[(indices >> (i * 3)) & 7];
+				}
+			}
+
+			unsigned short c0 = color[0] | (color[1] << 8);
+			unsigned short c1 = color[2] | (color[3] << 8);
+			int palette[4][4];
+			unpack565(c0, palette[0]);
+			unpack565(c1, palette[1]);
+			bool four_colors = c0 > c1 || format == TEXTURE_BC3;
+			for (int c = 0; c < 3; c++){
+				if (four_colors){
+					palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+				}
+				else{
+					palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+					palette[3][c] = 0;
+				}
+			}
+			for (int p = 0; p < 4; p++){
+				palette[p][3] = 255;
+			}
+			if (!four_colors){
+				palette[3][3] = 0;
+			}
+
+			unsigned int indices = color[4] | (color[5] << 8) | (color[6] << 16) | ((unsigned int)color[7] << 24);
+			for (int i = 0; i < 16; i++){
+				int x = bx * 4 + (i & 3);
+				int y = by * 4 + (i >> 2);
+				if (x >= w || y >= h){
+					continue;
+				}
+				const int* texel = palette[(indices >> (i * 2)) & 3];
+				unsigned char* out = &rgba[(y * w + x) * 4];
+				out[0] = texel[0];
+				out[1] = texel[1];
+				out[2] = texel[2];
+				out[3] = format == TEXTURE_BC3 ? alpha[i] : texel[3];
+			}
+
+			block += block_bytes(format);
+		}
+	}
+}
+
+bool TextureCooker::cook(const std::string& image_path, CookedTexture& out){
+	int w, h, comp;
+	unsigned char* image = stbi_load(image_path.c_str(), &w, &h, &comp, STBI_rgb_alpha);
+	if (image == NULL){
+		std::cout << "Unable to load image " << image_path << std::endl;
+		return false;
+	}
+
+	out.width = w;
+	out.height = h;
+	out.format = choose_format(image, w, h);
+	out.mips.clear();
+
+	TextureMip level;
+	level.width = w;
+	level.height = h;
+	level.data.assign(image, image + w * h * 4);
+	stbi_image_free(image);
+
+	while (true){
+		TextureMip cooked;
+		cooked.width = level.width;
+		cooked.height = level.height;
+		encode(level.data.data(), level.width, level.height, out.format, cooked.data);
+		out.mips.push_back(cooked);
+
+		if (level.width == 1 && level.height == 1){
+			break;
+		}
+		TextureMip next;
+		downsample(level, next);
+		level.width = next.width;
+		level.height = next.height;
+		level.data.swap(next.data);
+	}
+
+	return true;
+}
+
+//Size and modification time of a file, false if it can't be read
+static bool source_stamp(const std::string& path, long long* size, long long* time){
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0){
+		return false;
+	}
+	*size = info.st_size;
+	*time = info.st_mtime;
+	return true;
+}
+
+//Mip chain length for a w x h texture, halving down to 1x1
+static int full_mip_count(int w, int h){
+	int count = 1;
+	while (w > 1 || h > 1){
+		w = std::max(1, w / 2);
+		h = std::max(1, h / 2);
+		count++;
+	}
+	return count;
+}
+
+//Cooked layout: "TEX2", source size and time (2 x 64 bit), width, height, format, mip count,
+//then per mip width, height, byte count, bytes
+bool TextureCooker::save(const CookedTexture& texture, const std::string& cooked_path){
+	std::ofstream out(cooked_path, std::ios::binary);
+	if (!out){
+		return false;
+	}
+
+	long long source[2] = { texture.source_size, texture.source_time };
+	int header[4] = { texture.width, texture.height, (int)texture.format, (int)texture.mips.size() };
+	out.write("TEX2", 4);
+	out.write((const char*)source, sizeof(source));
+	out.write((const char*)header, sizeof(header));
+	for (int i = 0; i < texture.mips.size(); i++){
+		const TextureMip& mip = texture.mips[i];
+		int mip_header[3] = { mip.width, mip.height, (int)mip.data.size() };
+		out.write((const char*)mip_header, sizeof(mip_header));
+		out.write((const char*)mip.data.data(), mip.data.size());
+	}
+	return out.good();
+}
+
+bool TextureCooker::read(CookedTexture& texture, const std::string& cooked_path){
+	std::ifstream in(cooked_path, std::ios::binary);
+	if (!in){
+		return false;
+	}
+
+	char magic[4];
+	long long source[2];
+	int header[4];
+	in.read(magic, 4);
+	in.read((char*)source, sizeof(source));
+	in.read((char*)header, sizeof(header));
+	if (!in || std::string(magic, 4) != "TEX2"){
+		return false;
+	}
+
+	//Anything GL could take, and no more mips than the size allows
+	int max_size = 16384;
+	if (header[0] <= 0 || header[1] <= 0 || header[0] > max_size || header[1] > max_size ||
+		header[2] < TEXTURE_RGBA8 || header[2] > TEXTURE_BC3 ||
+		header[3] < 1 || header[3] > full_mip_count(header[0], header[1])){
+		return false;
+	}
+
+	texture.source_size = source[0];
+	texture.source_time = source[1];
+	texture.width = header[0];
+	texture.height = header[1];
+	texture.format = (TextureFormat)header[2];
+	texture.mips.clear();
+	texture.mips.resize(header[3]);
+
+	//Each level is half the last one, so sizes can't run away
+	int expected_width = texture.width;
+	int expected_height = texture.height;
+	for (int i = 0; i < texture.mips.size(); i++){
+		TextureMip& mip = texture.mips[i];
+		int mip_header[3];
+		in.read((char*)mip_header, sizeof(mip_header));
+		if (!in || mip_header[0] != expected_width || mip_header[1] != expected_height ||
+			mip_header[2] != mip_size(mip_header[0], mip_header[1], texture.format)){
+			return false;
+		}
+
+		mip.width = mip_header[0];
+		mip.height = mip_header[1];
+		mip.data.resize(mip_header[2]);
+		in.read((char*)mip.data.data(), mip.data.size());
+		if (!in){
+			return false;
+		}
+
+		expected_width = std::max(1, expected_width / 2);
+		expected_height = std::max(1, expected_height / 2);
+	}
+	return true;
+}
+
+std::string TextureCooker::cooked_path(const std::string& image_path){
+	size_t dot = image_path.find_last_of('.');
+	return image_path.substr(0, dot) + ".ctex";
+}
+
+bool TextureCooker::load(const std::string& image_path, CookedTexture& out){
+	std::string cooked = cooked_path(image_path);
+
+	//Without the png (a stripped build) the cooked file is all there is
+	long long source_size = 0;
+	long long source_time = 0;
+	bool have_source = source_stamp(image_path, &source_size, &source_time);
+
+	if (read(out, cooked)){
+		if (!have_source || (out.source_size == source_size && out.source_time == source_time)){
+			return true;
+		}
+	}
+
+	//Missing, damaged or stale
+	if (!cook(image_path, out)){
+		return false;
+	}
+	out.source_size = source_size;
+	out.source_time = source_time;
+	save(out, cooked);
+	return true;
+}
+
+bool TextureCooker::compression_supported(){
+	static int supported = -1;
+	if (supported < 0){
+		supported = SDL_GL_ExtensionSupported("GL_EXT_texture_compression_s3tc") ? 1 : 0;
+	}
+	return supported == 1;
+}
+
+static bool needs_expand(const CookedTexture& texture){
+	bool block_format = texture.format == TEXTURE_BC1 || texture.format == TEXTURE_BC3;
+	return block_format && !TextureCooker::compression_supported();
+}
+
+int TextureCooker::gpu_size(const CookedTexture& texture){
+	return needs_expand(texture) ? texture.rgba8_size() : texture.byte_size();
+}
+
+GLuint TextureCooker::upload(const CookedTexture& texture, GLuint id){
+	bool expand = needs_expand(texture);
+
+	if (id == 0){
+		glGenTextures(1, &id);
+	}
+	glBindTexture(GL_TEXTURE_2D, id);
+
+	//16 bit rows of odd width aren't 4 byte aligned
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+	std::vector<unsigned char> expanded;
+	for (int i = 0; i < texture.mips.size(); i++){
+		const TextureMip& mip = texture.mips[i];
+		if (expand){
+			decode(mip, texture.format, expanded);
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, expanded.data());
+			continue;
+		}
+
+		switch (texture.format){
+		case TEXTURE_RGBA8:
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, mip.data.data());
+			break;
+		case TEXTURE_RGBA4444:
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA4, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, mip.data.data());
+			break;
+		case TEXTURE_RGB565:
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGB5, mip.width, mip.height, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, mip.data.data());
+			break;
+		case TEXTURE_BC1:
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, mip.width, mip.height, 0, mip.data.size(), mip.data.data());
+			break;
+		case TEXTURE_BC3:
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, mip.width, mip.height, 0, mip.data.size(), mip.data.data());
+			break;
+		}
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.mips.size() - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.mips.size() > 1 ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	return id;
+}
@@ -0,0 +1,75 @@
+#ifndef TEXTURECOOKER_H
+#define TEXTURECOOKER_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+
+enum TextureFormat {
+	TEXTURE_RGBA8, //4 bytes per texel, what stbi gives us
+	TEXTURE_RGBA4444, //2 bytes, pixel art with cut-out alpha
+	TEXTURE_RGB565, //2 bytes, opaque pixel art
+	TEXTURE_BC1, //DXT1, 0.5 bytes, opaque or cut-out alpha
+	TEXTURE_BC3 //DXT5, 1 byte, smooth alpha
+};
+
+struct TextureMip{
+	int width = 0;
+	int height = 0;
+	std::vector<unsigned char> data;
+};
+
+struct CookedTexture{
+	int width = 0;
+	int height = 0;
+	TextureFormat format = TEXTURE_RGBA8;
+	std::vector<TextureMip> mips;
+
+	//Source image the cooked file was made from, a changed png is recooked
+	long long source_size = 0;
+	long long source_time = 0;
+
+	int byte_size() const;
+	//What the same mips would take as plain RGBA8
+	int rgba8_size() const;
+	//What the png cost before cooking: RGBA8, top level only
+	int baseline_size() const;
+};
+
+//Turns sprite/tile sheets into a cooked container with a full mip chain in
+//the smallest format that keeps them looking right. LoadTexture reads the
+//cooked file next to the png, cooking it the first time like SdfFont does.
+class TextureCooker{
+public:
+	//Offline step: png -> mips in the chosen format
+	static bool cook(const std::string& image_path, CookedTexture& out);
+	static bool save(const CookedTexture& texture, const std::string& cooked_path);
+	//False for anything short, truncated or inconsistent
+	static bool read(CookedTexture& texture, const std::string& cooked_path);
+
+	//Reads the cooked file for image_path, cooking and saving it if missing,
+	//unreadable or older than the png. Safe to call from any thread.
+	static bool load(const std::string& image_path, CookedTexture& out);
+
+	//GL thread only. Block formats are expanded to RGBA8 when the driver has no S3TC.
+	//Passing an existing id refills that texture name instead of making a new one.
+	static GLuint upload(const CookedTexture& texture, GLuint id = 0);
+	//Bytes upload() will actually put on the GPU
+	static int gpu_size(const CookedTexture& texture);
+
+	static std::string cooked_path(const std::string& image_path);
+	static bool compression_supported();
+
+	//Block formats are only used when they stay under this RMS error (0-255 scale)
+	static float block_error_limit;
+
+	static TextureFormat choose_format(const unsigned char* rgba, int w, int h);
+	static void encode(const unsigned char* rgba, int w, int h, TextureFormat format, std::vector<unsigned char>& out);
+	static void decode(const TextureMip& mip, TextureFormat format, std::vector<unsigned char>& rgba);
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include "TextureManager.h"
+#include <iostream>
+#include <algorithm>
+#include <assert.h>
+
+static std::string kilobytes(int bytes){
+	return std::to_string((bytes + 512) / 1024) + " KB";
+}
+
+void TextureManager::add(const std::string& path, GLuint id, const CookedTexture& cooked){
+	TextureEntry& entry = entries[id];
+	entry.path = path;
+	entry.id = id;
+	entry.width = cooked.width;
+	entry.height = cooked.height;
+	entry.mip_count = cooked.mips.size();
+	entry.bytes = TextureCooker::gpu_size(cooked);
+	entry.baseline_bytes = cooked.baseline_size();
+	entry.resident = true;
+	entry.last_bind_frame = frame;
+
+	ids_by_path[path] = id;
+	total_bytes += entry.bytes;
+	total_baseline_bytes += entry.baseline_bytes;
+}
+
+GLuint TextureManager::load(const std::string& path, float* width, float* height){
+	auto found = ids_by_path.find(path);
+	if (found != ids_by_path.end()){
+		TextureEntry& entry = entries[found->second];
+		*width = entry.width;
+		*height = entry.height;
+		return entry.id;
+	}
+
+	CookedTexture cooked;
+	if (!TextureCooker::load(path, cooked)){
+		std::cout << "Unable to load image. Make sure the path is correct\n";
+		assert(false);
+	}
+
+	*width = cooked.width;
+	*height = cooked.height;
+
+	GLuint id = TextureCooker::upload(cooked);
+	add(path, id, cooked);
+	return id;
+}
+
+GLuint TextureManager::upload(const std::string& path, const CookedTexture& cooked){
+	auto found = ids_by_path.find(path);
+	if (found != ids_by_path.end()){
+		return found->second;
+	}
+
+	GLuint id = TextureCooker::upload(cooked);
+	add(path, id, cooked);
+	return id;
+}
+
+GLuint TextureManager::create(const std::string& name, int width, int height, int bytes){
+	GLuint id;
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+
+	TextureEntry& entry = entries[id];
+	entry.path = name;
+	entry.id = id;
+	entry.width = width;
+	entry.height = height;
+	entry.mip_count = 1;
+	entry.bytes = bytes;
+	entry.baseline_bytes = bytes;
+	entry.resident = true;
+	entry.generated = true;
+	entry.last_bind_frame = frame;
+
+	total_bytes += bytes;
+	total_baseline_bytes += bytes;
+	return id;
+}
+
+void TextureManager::bind(GLuint id){
+	auto found = entries.find(id);
+	if (found != entries.end()){
+		TextureEntry& entry = found->second;
+		if (!entry.resident){
+			reload(entry);
+		}
+		entry.last_bind_frame = frame;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, id);
+}
+
+void TextureManager::release(GLuint id){
+	auto found = entries.find(id);
+	if (found == entries.end()){
+		return;
+	}
+
+	TextureEntry& entry = found->second;
+	if (entry.resident){
+		total_bytes -= entry.bytes;
+		total_baseline_bytes -= entry.baseline_bytes;
+	}
+	if (!entry.generated){
+		ids_by_path.erase(entry.path);
+	}
+	glDeleteTextures(1, &id);
+	entries.erase(found);
+}
+
+//Drops the storage but keeps the name, so ids held by sprites stay valid
+void TextureManager::evict(TextureEntry& entry){
+	glBindTexture(GL_TEXTURE_2D, entry.id);
+	for (int level = 0; level < entry.mip_count; level++){
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	}
+
+	entry.resident = false;
+	total_bytes -= entry.bytes;
+	total_baseline_bytes -= entry.baseline_bytes;
+	evictions++;
+}
+
+void TextureManager::reload(TextureEntry& entry){
+	CookedTexture cooked;
+	if (!TextureCooker::load(entry.path, cooked)){
+		std::cout << "Unable to reload " << entry.path << std::endl;
+		return;
+	}
+
+	TextureCooker::upload(cooked, entry.id);
+	entry.resident = true;
+	entry.reloads++;
+	total_bytes += entry.bytes;
+	total_baseline_bytes += entry.baseline_bytes;
+}
+
+void TextureManager::end_frame(){
+	if (total_bytes > budget_bytes){
+		//Oldest bind first, never anything drawn this frame
+		std::vector<TextureEntry*> candidates;
+		for (auto it = entries.begin(); it != entries.end(); ++it){
+			if (it->second.resident && !it->second.generated && it->second.last_bind_frame < frame){
+				candidates.push_back(&it->second);
+			}
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const TextureEntry* a, const TextureEntry* b){
+			return a->last_bind_frame < b->last_bind_frame;
+		});
+
+		for (int i = 0; i < candidates.size() && total_bytes > budget_bytes; i++){
+			evict(*candidates[i]);
+		}
+	}
+
+	frame++;
+}
+
+const TextureEntry* TextureManager::find(GLuint id){
+	auto found = entries.find(id);
+	return found == entries.end() ? NULL : &found->second;
+}
+
+int TextureManager::count(){
+	return entries.size();
+}
+
+int TextureManager::resident_bytes(){
+	return total_bytes;
+}
+
+int TextureManager::baseline_bytes(){
+	return total_baseline_bytes;
+}
+
+std::vector<const TextureEntry*> TextureManager::sorted_by_size(){
+	std::vector<const TextureEntry*> sorted;
+	for (auto it = entries.begin(); it != entries.end(); ++it){
+		sorted.push_back(&it->second);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const TextureEntry* a, const TextureEntry* b){
+		return a->bytes > b->bytes;
+	});
+	return sorted;
+}
+
+std::vector<std::string> TextureManager::report(int top_count){
+	std::vector<std::string> lines;
+	lines.push_back("textures: " + std::to_string(count()) + "  " + kilobytes(total_bytes) + " / " + kilobytes(budget_bytes)
+		+ "  evictions: " + std::to_string(evictions));
+
+	std::vector<const TextureEntry*> sorted = sorted_by_size();
+	for (int i = 0; i < sorted.size() && i < top_count; i++){
+		const TextureEntry& entry = *sorted[i];
+		lines.push_back(entry.path + "  " + kilobytes(entry.bytes) + (entry.resident ? "" : " (evicted)"));
+	}
+	return lines;
+}
+
+void TextureManager::dump(){
+	std::cout << "Textures: " << count() << ", resident " << kilobytes(total_bytes) << " of " << kilobytes(budget_bytes)
+		<< " budget (" << kilobytes(total_baseline_bytes) << " before cooking), " << evictions << " evictions" << std::endl;
+
+	std::vector<const TextureEntry*> sorted = sorted_by_size();
+	for (int i = 0; i < sorted.size(); i++){
+		const TextureEntry& entry = *sorted[i];
+		std::cout << "  " << entry.id << " " << entry.path << " " << entry.width << "x" << entry.height
+			<< " " << kilobytes(entry.bytes) << (entry.resident ? "" : " evicted")
+			<< " last bound frame " << entry.last_bind_frame << " reloads " << entry.reloads << std::endl;
+	}
+}
@@ -0,0 +1,80 @@
+#ifndef TEXTUREMANAGER_H
+#define TEXTUREMANAGER_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "TextureCooker.h"
+
+struct TextureEntry{
+	std::string path;
+	GLuint id = 0;
+	int width = 0;
+	int height = 0;
+	int mip_count = 0;
+	int bytes = 0; //on the GPU while resident
+	int baseline_bytes = 0;
+	bool resident = false;
+	bool generated = false; //built in memory, no file to reload from
+	unsigned int last_bind_frame = 0;
+	int reloads = 0;
+};
+
+//Owns every texture loaded from a file. Loads are cached by path, every
+//allocation's size is recorded, and when the total goes over budget_bytes
+//the least recently bound textures give up their storage. Their ids stay
+//valid: the next bind reloads them from the cooked file.
+class TextureManager{
+public:
+	int budget_bytes = 64 * 1024 * 1024;
+	int evictions = 0;
+
+	//Returns the cached texture if path was loaded before
+	GLuint load(const std::string& path, float* width, float* height);
+	//For textures read elsewhere (the asset loader), same caching as load
+	GLuint upload(const std::string& path, const CookedTexture& cooked);
+	//For textures built in memory (font atlas, baked tiles). Never cached by
+	//name and never evicted, there is nothing to reload them from. The new
+	//texture is left bound for the caller's glTexImage2D.
+	GLuint create(const std::string& name, int width, int height, int bytes);
+
+	//Use instead of glBindTexture for managed textures. Unknown ids are just bound.
+	void bind(GLuint id);
+
+	//Frees the texture for good, the id must not be used afterwards
+	void release(GLuint id);
+
+	//Once per frame, after drawing. Evicts down to the budget.
+	void end_frame();
+
+	//NULL for ids the manager doesn't own
+	const TextureEntry* find(GLuint id);
+
+	int count();
+	int resident_bytes();
+	int baseline_bytes(); //what the resident textures took before cooking, RGBA8 without mips
+
+	//Short summary plus the top_count largest resident textures, for the debug overlay
+	std::vector<std::string> report(int top_count);
+	//Every texture, largest first, to stdout
+	void dump();
+
+private:
+	std::unordered_map<GLuint, TextureEntry> entries;
+	std::unordered_map<std::string, GLuint> ids_by_path;
+	unsigned int frame = 1;
+	int total_bytes = 0;
+	int total_baseline_bytes = 0;
+
+	void add(const std::string& path, GLuint id, const CookedTexture& cooked);
+	void evict(TextureEntry& entry);
+	void reload(TextureEntry& entry);
+	std::vector<const TextureEntry*> sorted_by_size();
+};
+
+#endif
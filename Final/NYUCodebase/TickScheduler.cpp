@@ -0,0 +1,105 @@
+#include "TickScheduler.h"
+#include <math.h>
+
+void TickScheduler::set_tick_rate(float ticks_per_second){
+	tick_rate = ticks_per_second;
+	for (int i = 0; i < systems.size(); i++){
+		set_rate(i, systems[i].rate);
+	}
+}
+
+int TickScheduler::period_for(float rate){
+	if (rate <= 0 || rate >= tick_rate){
+		return 1;
+	}
+	return (int)floorf(tick_rate / rate + 0.5f);
+}
+
+static int gcd(int a, int b){
+	return b == 0 ? a : gcd(b, a % b);
+}
+
+//Two systems ever share a tick when their phases agree modulo the gcd of their periods
+int TickScheduler::least_loaded_phase(int period, int skip){
+	int best = 0;
+	int best_load = -1;
+	for (int phase = 0; phase < period; phase++){
+		int load = 0;
+		for (int i = 0; i < systems.size(); i++){
+			int common = gcd(period, systems[i].period);
+			if (i != skip && systems[i].period > 1 && phase % common == systems[i].phase % common){
+				load++;
+			}
+		}
+		if (best_load < 0 || load < best_load){
+			best = phase;
+			best_load = load;
+		}
+	}
+	return best;
+}
+
+int TickScheduler::add(const std::string& name, float rate){
+	System system;
+	system.name = name;
+	systems.push_back(system);
+	set_rate(systems.size() - 1, rate);
+	return systems.size() - 1;
+}
+
+void TickScheduler::set_rate(int system, float rate){
+	System& s = systems[system];
+	s.rate = rate;
+	s.period = period_for(rate);
+	s.phase = s.period > 1 ? least_loaded_phase(s.period, system) : 0;
+}
+
+void TickScheduler::begin_tick(){
+	current_tick++;
+
+	if (current_tick - window_start >= report_ticks){
+		int ticks = current_tick - window_start;
+		for (int i = 0; i < systems.size(); i++){
+			System& s = systems[i];
+			s.ms_per_run = s.window_runs > 0 ? (float)(s.window_ms / s.window_runs) : 0;
+			s.ms_per_tick = (float)(s.window_ms / ticks);
+			s.window_ms = 0;
+			s.window_runs = 0;
+		}
+		window_start = current_tick;
+	}
+}
+
+int TickScheduler::tick() const{
+	return current_tick;
+}
+
+float TickScheduler::time() const{
+	return current_tick / tick_rate;
+}
+
+bool TickScheduler::due(int system) const{
+	const System& s = systems[system];
+	return current_tick % s.period == s.phase;
+}
+
+float TickScheduler::elapsed(int system) const{
+	return systems[system].period / tick_rate;
+}
+
+static std::string milliseconds(float ms){
+	//Three decimals, std::to_string always gives six
+	int micros = (int)(ms * 1000.0f + 0.5f);
+	std::string fraction = std::to_string(1000 + micros % 1000).substr(1);
+	return std::to_string(micros / 1000) + "." + fraction + " ms";
+}
+
+std::vector<std::string> TickScheduler::report(){
+	std::vector<std::string> lines;
+	for (int i = 0; i < systems.size(); i++){
+		const System& s = systems[i];
+		lines.push_back(s.name + "  " + std::to_string((int)(tick_rate / s.period + 0.5f)) + " Hz  "
+			+ milliseconds(s.ms_per_run) + "/run  " + milliseconds(s.ms_per_tick) + "/tick");
+	}
+	return lines;
+}
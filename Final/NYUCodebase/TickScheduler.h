@@ -0,0 +1,71 @@
+#ifndef TICKSCHEDULER_H
+#define TICKSCHEDULER_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+//Decides which systems run on each sim tick. A system asks for a rate in Hz
+//and runs every tick_rate / rate ticks, on its phase within that period.
+//Phases are picked so systems with the same period land on different ticks
+//instead of all piling onto tick 0.
+//
+//run() times each system, report() gives the per system cost for the overlay.
+class TickScheduler{
+public:
+	//Sim ticks per second. Recomputes every system's period.
+	void set_tick_rate(float ticks_per_second);
+
+	//rate 0 (or at least the tick rate) runs every tick. Returns the system id.
+	int add(const std::string& name, float rate);
+	void set_rate(int system, float rate);
+
+	//Once per sim tick, before any system runs
+	void begin_tick();
+	int tick() const;
+	//Sim seconds since start, advances with the ticks not the wall clock
+	float time() const;
+
+	bool due(int system) const;
+	//Sim seconds a system's run covers, its period in ticks times the timestep
+	float elapsed(int system) const;
+
+	//Runs f if the system is due this tick and adds its time to the report
+	template <typename F>
+	void run(int system, F f){
+		if (!due(system)){
+			return;
+		}
+		Uint64 start = SDL_GetPerformanceCounter();
+		f();
+		systems[system].window_ms += (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+		systems[system].window_runs++;
+	}
+
+	//One line per system: rate, ms per run, ms per tick averaged over the last report_ticks
+	std::vector<std::string> report();
+	int report_ticks = 120;
+
+private:
+	struct System{
+		std::string name;
+		float rate = 0;
+		int period = 1;
+		int phase = 0;
+
+		double window_ms = 0;
+		int window_runs = 0;
+		float ms_per_run = 0;
+		float ms_per_tick = 0;
+	};
+
+	std::vector<System> systems;
+	float tick_rate = 60.0f;
+	int current_tick = -1;
+	int window_start = 0;
+
+	int period_for(float rate);
+	int least_loaded_phase(int period, int skip);
+};
+
+#endif
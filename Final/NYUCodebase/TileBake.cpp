@@ -0,0 +1,239 @@
+#include "TileBake.h"
+#include "Transform2D.h"
+#include "TextureCooker.h"
+#include <algorithm>
+#include <iostream>
+
+TileBake::~TileBake(){
+	release();
+}
+
+bool TileBake::build(const FlareMap& map, const std::vector<int>& layers, const std::string& sheet_path, int tile_pixels_, float tile_world_size_){
+	width = map.mapWidth;
+	height = map.mapHeight;
+	tile_pixels = tile_pixels_;
+	tile_world_size = tile_world_size_;
+	baked_layers = layers;
+
+	CookedTexture cooked;
+	if (!TextureCooker::load(sheet_path, cooked) || cooked.mips.empty()){
+		std::cout << "TileBake: unable to read " << sheet_path << std::endl;
+		return false;
+	}
+	TextureCooker::decode(cooked.mips[0], cooked.format, sheet);
+	sheet_width = cooked.width;
+	sheet_height = cooked.height;
+
+	chunks_wide = (width + chunk_tiles - 1) / chunk_tiles;
+	int chunks_high = (height + chunk_tiles - 1) / chunk_tiles;
+	chunks.clear();
+	chunks.resize(chunks_wide * chunks_high);
+
+	for (int cy = 0; cy < chunks_high; cy++){
+		for (int cx = 0; cx < chunks_wide; cx++){
+			Chunk& chunk = chunks[cy * chunks_wide + cx];
+			chunk.tile_x = cx * chunk_tiles;
+			chunk.tile_y = cy * chunk_tiles;
+			chunk.tiles_wide = std::min(chunk_tiles, width - chunk.tile_x);
+			chunk.tiles_high = std::min(chunk_tiles, height - chunk.tile_y);
+
+			bool empty = true;
+			for (int l = 0; l < layers.size() && empty; l++){
+				for (int y = chunk.tile_y; y < chunk.tile_y + chunk.tiles_high && empty; y++){
+					for (int x = chunk.tile_x; x < chunk.tile_x + chunk.tiles_wide; x++){
+						if (map.layers[layers[l]][y][x] != 0){
+							empty = false;
+							break;
+						}
+					}
+				}
+			}
+			if (empty){
+				continue;
+			}
+
+			chunk.pixels.assign(chunk.tiles_wide * tile_pixels * chunk.tiles_high * tile_pixels * 4, 0);
+			for (int y = chunk.tile_y; y < chunk.tile_y + chunk.tiles_high; y++){
+				for (int x = chunk.tile_x; x < chunk.tile_x + chunk.tiles_wide; x++){
+					composite_tile(map, chunk, x, y);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+//Blends every baked layer's tile at x, y, bottom layer first
+void TileBake::composite_tile(const FlareMap& map, Chunk& chunk, int x, int y){
+	int sheet_columns = sheet_width / tile_pixels;
+	int row_bytes = chunk.tiles_wide * tile_pixels * 4;
+	int origin_x = (x - chunk.tile_x) * tile_pixels;
+	int origin_y = (y - chunk.tile_y) * tile_pixels;
+
+	for (int py = 0; py < tile_pixels; py++){
+		for (int px = 0; px < tile_pixels; px++){
+			//Premultiplied, so the result is exact for straight alpha blending later
+			float color[3] = { 0, 0, 0 };
+			float alpha = 0;
+			for (int l = 0; l < baked_layers.size(); l++){
+				unsigned int tile_id = map.layers[baked_layers[l]][y][x];
+				if (tile_id == 0){
+					continue;
+				}
+
+				//Same lookup as TileMesh, clamped like GL_CLAMP would
+				int tile_x = (tile_id % sheet_columns) - 1;
+				int tile_y = tile_id / sheet_columns;
+				int sx = std::max(0, std::min(sheet_width - 1, tile_x * tile_pixels + px));
+				int sy = std::max(0, std::min(sheet_height - 1, tile_y * tile_pixels + py));
+				const unsigned char* src = &sheet[(sy * sheet_width + sx) * 4];
+
+				float a = src[3] / 255.0f;
+				for (int c = 0; c < 3; c++){
+					color[c] = src[c] * a + color[c] * (1.0f - a);
+				}
+				alpha = a + alpha * (1.0f - a);
+			}
+
+			unsigned char* out = &chunk.pixels[(origin_y + py) * row_bytes + (origin_x + px) * 4];
+			for (int c = 0; c < 3; c++){
+				out[c] = alpha > 0 ? (unsigned char)std::min(255.0f, color[c] / alpha + 0.5f) : 0;
+			}
+			out[3] = (unsigned char)(alpha * 255.0f + 0.5f);
+		}
+	}
+}
+
+bool TileBake::bakes(int layer){
+	return std::find(baked_layers.begin(), baked_layers.end(), layer) != baked_layers.end();
+}
+
+void TileBake::set_tile(const FlareMap& map, int x, int y){
+	if (x < 0 || x >= width || y < 0 || y >= height || chunks.empty()){
+		return;
+	}
+
+	Chunk& chunk = chunks[(y / chunk_tiles) * chunks_wide + x / chunk_tiles];
+	if (chunk.pixels.empty()){
+		//First decoration in an empty chunk, the whole texture goes up on the next upload
+		chunk.pixels.assign(chunk.tiles_wide * tile_pixels * chunk.tiles_high * tile_pixels * 4, 0);
+	}
+	composite_tile(map, chunk, x, y);
+
+	int index = (y - chunk.tile_y) * chunk.tiles_wide + (x - chunk.tile_x);
+	if (chunk.texture != 0 && !chunk.tile_dirty[index]){
+		chunk.tile_dirty[index] = true;
+		chunk.dirty_tiles.push_back(index);
+	}
+}
+
+void TileBake::upload(TextureManager& textures_){
+	textures = &textures_;
+	std::vector<unsigned char> tile(tile_pixels * tile_pixels * 4);
+	for (int i = 0; i < chunks.size(); i++){
+		Chunk& chunk = chunks[i];
+		if (chunk.pixels.empty()){
+			continue;
+		}
+
+		int chunk_width = chunk.tiles_wide * tile_pixels;
+		int chunk_height = chunk.tiles_high * tile_pixels;
+		if (chunk.texture == 0){
+			chunk.texture = textures->create("baked chunk " + std::to_string(i), chunk_width, chunk_height, chunk.pixels.size());
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, chunk_width, chunk_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, chunk.pixels.data());
+			//Same texel density as the sheet, so no mips
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			chunk.tile_dirty.assign(chunk.tiles_wide * chunk.tiles_high, false);
+			continue;
+		}
+
+		if (chunk.dirty_tiles.empty()){
+			continue;
+		}
+
+		textures->bind(chunk.texture);
+		for (int d = 0; d < chunk.dirty_tiles.size(); d++){
+			int origin_x = (chunk.dirty_tiles[d] % chunk.tiles_wide) * tile_pixels;
+			int origin_y = (chunk.dirty_tiles[d] / chunk.tiles_wide) * tile_pixels;
+			for (int row = 0; row < tile_pixels; row++){
+				const unsigned char* src = &chunk.pixels[((origin_y + row) * chunk_width + origin_x) * 4];
+				std::copy(src, src + tile_pixels * 4, &tile[row * tile_pixels * 4]);
+			}
+			glTexSubImage2D(GL_TEXTURE_2D, 0, origin_x, origin_y, tile_pixels, tile_pixels, GL_RGBA, GL_UNSIGNED_BYTE, tile.data());
+			chunk.tile_dirty[chunk.dirty_tiles[d]] = false;
+		}
+		chunk.dirty_tiles.clear();
+	}
+}
+
+//Caller sets the matrices
+void TileBake::draw(ShaderProgram* program, int origin_x, int origin_y, float view_left, float view_right, float view_bottom, float view_top){
+	float half = 0.5f * tile_world_size;
+	float tex_coords[] = { 0, 1, 1, 0, 0, 0, 1, 0, 0, 1, 1, 1 };
+
+	glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, tex_coords);
+	glEnableVertexAttribArray(program->texCoordAttribute);
+	glEnableVertexAttribArray(program->positionAttribute);
+
+	for (int i = 0; i < chunks.size(); i++){
+		const Chunk& chunk = chunks[i];
+		if (chunk.texture == 0){
+			continue;
+		}
+
+		//Chunk's first tile, relative to the origin
+		float x = (chunk.tile_x - origin_x) * tile_world_size;
+		float y = -(chunk.tile_y - origin_y) * tile_world_size;
+		float left = -half;
+		float right = left + chunk.tiles_wide * tile_world_size;
+		float top = half;
+		float bottom = top - chunk.tiles_high * tile_world_size;
+		if (x + right < view_left || x + left > view_right || y + top < view_bottom || y + bottom > view_top){
+			continue;
+		}
+		float verts[] = { left, bottom, right, top, left, top, right, top, left, bottom, right, bottom };
+
+		program->SetModelMatrix(Transform2D::translate(x, y).to_matrix());
+		textures->bind(chunk.texture);
+		glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, verts);
+		glDrawArrays(GL_TRIANGLES, 0, 6);
+	}
+
+	glDisableVertexAttribArray(program->positionAttribute);
+	glDisableVertexAttribArray(program->texCoordAttribute);
+}
+
+void TileBake::release(){
+	for (int i = 0; i < chunks.size(); i++){
+		if (chunks[i].texture != 0){
+			textures->release(chunks[i].texture);
+			chunks[i].texture = 0;
+		}
+	}
+}
+
+int TileBake::chunk_count(){
+	int count = 0;
+	for (int i = 0; i < chunks.size(); i++){
+		if (!chunks[i].pixels.empty()){
+			count++;
+		}
+	}
+	return count;
+}
+
+int TileBake::texture_bytes(){
+	int bytes = 0;
+	for (int i = 0; i < chunks.size(); i++){
+		bytes += chunks[i].pixels.size();
+	}
+	return bytes;
+}
+
+int TileBake::covered_texels(){
+	return texture_bytes() / 4;
+}
@@ -0,0 +1,78 @@
+#ifndef TILEBAKE_H
+#define TILEBAKE_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include "FlareMap.h"
+#include "ShaderProgram.h"
+#include "TextureManager.h"
+
+//Static decoration layers composited into one RGBA8 texture per chunk of
+//tiles, so the background draws as a handful of chunk quads instead of a
+//blended quad per tile per layer. Layers are blended in order the same way
+//GL_SRC_ALPHA/GL_ONE_MINUS_SRC_ALPHA would have on screen, and fully empty
+//chunks are skipped. Editing a baked tile re-composites that one tile and
+//sends it with glTexSubImage2D.
+class TileBake{
+public:
+	int chunk_tiles = 16; //chunk edge in tiles
+
+	~TileBake();
+
+	//CPU only, safe on the prefetch thread. Reads the tile sheet's cooked file for its pixels.
+	bool build(const FlareMap& map, const std::vector<int>& layers, const std::string& sheet_path, int tile_pixels, float tile_world_size);
+
+	//Re-composites the tile at x, y from the map's current layers
+	void set_tile(const FlareMap& map, int x, int y);
+	bool bakes(int layer);
+
+	//Main thread. Chunk textures are created, bound and released through textures.
+	void upload(TextureManager& textures);
+	//Skips chunks outside the rect, which is relative to tile origin_x, origin_y.
+	//Each chunk quad is built around its own first tile and moved into place
+	//with the model matrix; caller sets the view and projection.
+	void draw(ShaderProgram* program, int origin_x, int origin_y, float left, float right, float bottom, float top);
+	void release();
+
+	int chunk_count();
+	int texture_bytes();
+	//Texels the baked chunks cover, every pixel of each chunk quad gets shaded
+	int covered_texels();
+
+private:
+	TextureManager* textures = NULL;
+
+	struct Chunk{
+		int tile_x = 0;
+		int tile_y = 0;
+		int tiles_wide = 0;
+		int tiles_high = 0;
+		std::vector<unsigned char> pixels;
+		GLuint texture = 0;
+		std::vector<int> dirty_tiles; //index within the chunk
+		std::vector<bool> tile_dirty;
+	};
+
+	int width = 0;
+	int height = 0;
+	int tile_pixels = 8;
+	float tile_world_size = 0.18f;
+	int chunks_wide = 0;
+	std::vector<int> baked_layers;
+
+	int sheet_width = 0;
+	int sheet_height = 0;
+	std::vector<unsigned char> sheet;
+
+	//Empty chunks stay in the grid with no pixels
+	std::vector<Chunk> chunks;
+
+	void composite_tile(const FlareMap& map, Chunk& chunk, int x, int y);
+};
+
+#endif
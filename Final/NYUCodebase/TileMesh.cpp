@@ -0,0 +1,216 @@
+#include "TileMesh.h"
+#include "Transform2D.h"
+#include <algorithm>
+#include <math.h>
+
+TileMesh::~TileMesh(){
+	release();
+}
+
+void TileMesh::build(const FlareMap& map, const std::vector<int>& layers, float sheet_width_, float sheet_height_, int tile_pixels_, float tile_world_size_){
+	width = map.mapWidth;
+	height = map.mapHeight;
+	layer_count = layers.size();
+	mesh_layers.assign(map.layers.size(), -1);
+	for (int i = 0; i < layers.size(); i++){
+		mesh_layers[layers[i]] = i;
+	}
+	sheet_width = sheet_width_;
+	sheet_height = sheet_height_;
+	tile_pixels = tile_pixels_;
+	tile_world_size = tile_world_size_;
+
+	chunks_wide = (width + chunk_tiles - 1) / chunk_tiles;
+	chunks_high = (height + chunk_tiles - 1) / chunk_tiles;
+
+	//Chunks on the right and bottom edges keep their slots past the map, left degenerate
+	int slot_count = layer_count * chunks_wide * chunks_high * chunk_tiles * chunk_tiles;
+	verts.assign(slot_count * SLOT_FLOATS, 0.0f);
+	tex_coords.assign(slot_count * SLOT_FLOATS, 0.0f);
+	slot_dirty.assign(slot_count, false);
+	dirty_slots.clear();
+	edits = 0;
+
+	for (int z = 0; z < layer_count; z++){
+		for (int y = 0; y < height; y++){
+			for (int x = 0; x < width; x++){
+				write_slot(slot_index(z, x, y), x, y, map.layers[layers[z]][y][x]);
+			}
+		}
+	}
+}
+
+int TileMesh::slot_index(int layer, int x, int y){
+	int chunk = (layer * chunks_high + y / chunk_tiles) * chunks_wide + x / chunk_tiles;
+	return (chunk * chunk_tiles + y % chunk_tiles) * chunk_tiles + x % chunk_tiles;
+}
+
+//Same quad and sheet lookup the old per tile Sprite built
+void TileMesh::write_slot(int slot, int x, int y, unsigned int tile_id){
+	float* v = &verts[slot * SLOT_FLOATS];
+	float* t = &tex_coords[slot * SLOT_FLOATS];
+	if (tile_id == 0){
+		std::fill(v, v + SLOT_FLOATS, 0.0f);
+		std::fill(t, t + SLOT_FLOATS, 0.0f);
+		return;
+	}
+
+	//Ids count from the top left of the sheet, row by row
+	int sheet_columns = (int)sheet_width / tile_pixels;
+	int tile_x = (tile_id % sheet_columns) - 1;
+	int tile_y = tile_id / sheet_columns;
+
+	float u = (tile_x * tile_pixels) / sheet_width;
+	float w = tile_pixels / sheet_width;
+	float tv = (tile_y * tile_pixels) / sheet_height;
+	float h = tile_pixels / sheet_height;
+
+	//From the chunk's first tile
+	float cx = (x % chunk_tiles) * tile_world_size;
+	float cy = -(y % chunk_tiles) * tile_world_size;
+	float half = 0.5f * tile_world_size;
+	float left = cx - half, right = cx + half;
+	float bottom = cy - half, top = cy + half;
+
+	float quad[SLOT_FLOATS] = { left, bottom, right, top, left, top, right, top, left, bottom, right, bottom };
+	float uvs[SLOT_FLOATS] = { u, tv + h, u + w, tv, u, tv, u + w, tv, u, tv + h, u + w, tv + h };
+	std::copy(quad, quad + SLOT_FLOATS, v);
+	std::copy(uvs, uvs + SLOT_FLOATS, t);
+}
+
+void TileMesh::set_tile(int layer, int x, int y, unsigned int tile_id){
+	if (layer < 0 || layer >= mesh_layers.size() || mesh_layers[layer] < 0 || x < 0 || x >= width || y < 0 || y >= height){
+		return;
+	}
+
+	int slot = slot_index(mesh_layers[layer], x, y);
+	write_slot(slot, x, y, tile_id);
+	if (!slot_dirty[slot]){
+		slot_dirty[slot] = true;
+		dirty_slots.push_back(slot);
+	}
+	edits++;
+}
+
+int TileMesh::quad_count(){
+	int count = 0;
+	for (int slot = 0; slot < verts.size() / SLOT_FLOATS; slot++){
+		//Degenerate slots are all zero
+		const float* v = &verts[slot * SLOT_FLOATS];
+		if (v[0] != v[2] || v[1] != v[3]){
+			count++;
+		}
+	}
+	return count;
+}
+
+void TileMesh::upload_range(int first_slot, int slot_count){
+	GLintptr offset = first_slot * SLOT_FLOATS * sizeof(float);
+	GLsizeiptr size = slot_count * SLOT_FLOATS * sizeof(float);
+	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+	glBufferSubData(GL_ARRAY_BUFFER, offset, size, &verts[first_slot * SLOT_FLOATS]);
+	glBindBuffer(GL_ARRAY_BUFFER, tex_coord_buffer);
+	glBufferSubData(GL_ARRAY_BUFFER, offset, size, &tex_coords[first_slot * SLOT_FLOATS]);
+	uploaded_floats += slot_count * SLOT_FLOATS * 2;
+	uploaded_ranges++;
+}
+
+void TileMesh::upload(){
+	uploaded_floats = 0;
+	uploaded_ranges = 0;
+	if (verts.empty()){
+		return;
+	}
+
+	if (vertex_buffer == 0){
+		glGenBuffers(1, &vertex_buffer);
+		glGenBuffers(1, &tex_coord_buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+		glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(float), verts.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, tex_coord_buffer);
+		glBufferData(GL_ARRAY_BUFFER, tex_coords.size() * sizeof(float), tex_coords.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		uploaded_floats = verts.size() * 2;
+	}
+	else if (!dirty_slots.empty()){
+		//Neighbouring edits (a door, a row of blocks) merge into one range
+		std::sort(dirty_slots.begin(), dirty_slots.end());
+		std::vector<std::pair<int, int>> runs;
+		for (int i = 0; i < dirty_slots.size(); i++){
+			int slot = dirty_slots[i];
+			if (!runs.empty() && runs.back().first + runs.back().second == slot){
+				runs.back().second++;
+			}
+			else{
+				runs.push_back(std::make_pair(slot, 1));
+			}
+		}
+
+		if (runs.size() > max_upload_runs){
+			upload_range(dirty_slots.front(), dirty_slots.back() - dirty_slots.front() + 1);
+		}
+		else{
+			for (int i = 0; i < runs.size(); i++){
+				upload_range(runs[i].first, runs[i].second);
+			}
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	for (int i = 0; i < dirty_slots.size(); i++){
+		slot_dirty[dirty_slots[i]] = false;
+	}
+	dirty_slots.clear();
+}
+
+//Caller sets the view and projection and binds the tile sheet
+void TileMesh::draw(ShaderProgram* program, int origin_x, int origin_y, float left, float right, float bottom, float top){
+	if (vertex_buffer == 0){
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+	glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, 0);
+	glEnableVertexAttribArray(program->positionAttribute);
+
+	glBindBuffer(GL_ARRAY_BUFFER, tex_coord_buffer);
+	glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, 0);
+	glEnableVertexAttribArray(program->texCoordAttribute);
+
+	//Everything else draws from client memory
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	//Cells are centred on their tile position
+	int first_column = std::max(0, origin_x + (int)floorf(left / tile_world_size + 0.5f));
+	int last_column = std::min(width - 1, origin_x + (int)floorf(right / tile_world_size + 0.5f));
+	int first_row = std::max(0, origin_y + (int)floorf(-top / tile_world_size + 0.5f));
+	int last_row = std::min(height - 1, origin_y + (int)floorf(-bottom / tile_world_size + 0.5f));
+	int chunk_vertices = chunk_tiles * chunk_tiles * SLOT_FLOATS / 2;
+
+	if (first_column <= last_column && first_row <= last_row){
+		//A chunk's slots are contiguous, one draw per chunk per layer
+		for (int cy = first_row / chunk_tiles; cy <= last_row / chunk_tiles; cy++){
+			for (int cx = first_column / chunk_tiles; cx <= last_column / chunk_tiles; cx++){
+				float x = (cx * chunk_tiles - origin_x) * tile_world_size;
+				float y = -(cy * chunk_tiles - origin_y) * tile_world_size;
+				program->SetModelMatrix(Transform2D::translate(x, y).to_matrix());
+				for (int z = 0; z < layer_count; z++){
+					int chunk = (z * chunks_high + cy) * chunks_wide + cx;
+					glDrawArrays(GL_TRIANGLES, chunk * chunk_vertices, chunk_vertices);
+				}
+			}
+		}
+	}
+
+	glDisableVertexAttribArray(program->positionAttribute);
+	glDisableVertexAttribArray(program->texCoordAttribute);
+}
+
+void TileMesh::release(){
+	if (vertex_buffer != 0){
+		glDeleteBuffers(1, &vertex_buffer);
+		glDeleteBuffers(1, &tex_coord_buffer);
+		vertex_buffer = 0;
+		tex_coord_buffer = 0;
+	}
+}
@@ -0,0 +1,80 @@
+#ifndef TILEMESH_H
+#define TILEMESH_H
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <vector>
+#include "FlareMap.h"
+#include "ShaderProgram.h"
+
+//Tile geometry for a map, kept in vertex buffers. Every cell of every layer
+//owns a fixed slot of 6 vertices (empty cells are degenerate), so changing
+//one tile rewrites one slot and marks it dirty. upload() then sends only the
+//dirty ranges with glBufferSubData instead of rebuilding the whole map.
+//
+//Slots are grouped by square chunk of tiles, and vertices are relative to
+//their chunk's first tile, so they stay small on any map size. draw() moves
+//each chunk into place with a model matrix relative to the floating origin.
+class TileMesh{
+public:
+	int chunk_tiles = 16; //chunk edge in tiles, set before build()
+	//Above this many separate dirty runs, one upload spanning all of them is cheaper
+	int max_upload_runs = 32;
+
+	int edits = 0; //set_tile calls since build
+	int uploaded_floats = 0; //floats sent by the last upload()
+	int uploaded_ranges = 0; //glBufferSubData ranges in the last upload()
+
+	~TileMesh();
+
+	//CPU only, safe on the prefetch thread. Only the listed map layers get slots, drawn in that order.
+	void build(const FlareMap& map, const std::vector<int>& layers, float sheet_width, float sheet_height, int tile_pixels, float tile_world_size);
+
+	//O(1). Doesn't touch GL, the slot goes out with the next upload(). Layers not in the mesh are ignored.
+	void set_tile(int layer, int x, int y, unsigned int tile_id);
+	int quad_count(); //non-empty slots
+
+	//CPU copies of the buffers, 12 floats per slot. Slots are ordered by mesh
+	//layer, chunk row, chunk column, then row and column within the chunk.
+	const std::vector<float>& vertex_data() const { return verts; }
+	const std::vector<float>& tex_coord_data() const { return tex_coords; }
+
+	//Main thread. The first call creates the buffers, later ones patch dirty slots.
+	void upload();
+	//Only the chunks overlapping the rect, which is relative to tile origin_x,
+	//origin_y. Sets the model matrix; caller sets the view and projection.
+	void draw(ShaderProgram* program, int origin_x, int origin_y, float left, float right, float bottom, float top);
+	void release();
+
+private:
+	static const int SLOT_FLOATS = 12; //6 vertices, 2 floats each
+
+	int width = 0;
+	int height = 0;
+	int layer_count = 0;
+	int chunks_wide = 0;
+	int chunks_high = 0;
+	std::vector<int> mesh_layers; //map layer -> mesh layer, -1 when not in the mesh
+	float sheet_width = 0;
+	float sheet_height = 0;
+	int tile_pixels = 8;
+	float tile_world_size = 0.18f;
+
+	std::vector<float> verts;
+	std::vector<float> tex_coords;
+
+	std::vector<int> dirty_slots;
+	std::vector<bool> slot_dirty;
+
+	GLuint vertex_buffer = 0;
+	GLuint tex_coord_buffer = 0;
+
+	int slot_index(int layer, int x, int y);
+	void write_slot(int slot, int x, int y, unsigned int tile_id);
+	void upload_range(int first_slot, int slot_count);
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "TileRaycast.h"
+#include <math.h>
+
+int TileRaycast::batch_chunk_size = 256;
+
+TileHit TileRaycast::cast(const FlareMap& map, int layer, float tile_size, const TileRay& ray, int origin_tile_x, int origin_tile_y){
+	TileHit result;
+	float length = sqrtf(ray.direction_x * ray.direction_x + ray.direction_y * ray.direction_y);
+	if (length == 0 || layer < 0 || layer >= map.layers.size()){
+		return result;
+	}
+	unsigned int** tiles = map.layers[layer];
+
+	//Tile space from the origin tile, y flipped so rows grow downwards.
+	//The map tile is x, y; only the small offset from the origin is a float.
+	float ox = ray.origin_x / tile_size;
+	float oy = -ray.origin_y / tile_size;
+	float dx = ray.direction_x / length;
+	float dy = -ray.direction_y / length;
+	float max_t = ray.max_distance / tile_size;
+
+	int first_x = (int)floorf(ox);
+	int first_y = (int)floorf(oy);
+	int x = origin_tile_x + first_x;
+	int y = origin_tile_y + first_y;
+	int step_x = dx > 0 ? 1 : -1;
+	int step_y = dy > 0 ? 1 : -1;
+	float delta_x = dx != 0 ? fabsf(1.0f / dx) : INFINITY;
+	float delta_y = dy != 0 ? fabsf(1.0f / dy) : INFINITY;
+	float next_x = dx != 0 ? ((first_x + (dx > 0 ? 1 : 0)) - ox) / dx : INFINITY;
+	float next_y = dy != 0 ? ((first_y + (dy > 0 ? 1 : 0)) - oy) / dy : INFINITY;
+
+	//Axis of the last boundary crossed, gives the normal. Starting inside a solid tile has none.
+	int side = -1;
+	float t = 0;
+	while (t <= max_t){
+		if (x >= 0 && x < map.mapWidth && y >= 0 && y < map.mapHeight && tiles[y][x] != 0){
+			result.hit = true;
+			result.tile_x = x;
+			result.tile_y = y;
+			result.tile = tiles[y][x];
+			result.distance = t * tile_size;
+			result.x = ray.origin_x + ray.direction_x / length * result.distance;
+			result.y = ray.origin_y + ray.direction_y / length * result.distance;
+			if (side == 0){
+				result.normal_x = (float)-step_x;
+			}
+			else if (side == 1){
+				//Back to world y
+				result.normal_y = (float)step_y;
+			}
+			return result;
+		}
+
+		//Once the ray has left the map heading away from it, nothing more can be hit
+		if ((x < 0 && step_x < 0) || (x >= map.mapWidth && step_x > 0) || (y < 0 && step_y < 0) || (y >= map.mapHeight && step_y > 0)){
+			break;
+		}
+
+		if (next_x < next_y){
+			t = next_x;
+			next_x += delta_x;
+			x += step_x;
+			side = 0;
+		}
+		else{
+			t = next_y;
+			next_y += delta_y;
+			y += step_y;
+			side = 1;
+		}
+	}
+	return result;
+}
+
+void TileRaycast::cast(const FlareMap& map, int layer, float tile_size, const TileRay* rays, int count, TileHit* hits, JobSystem* jobs, int origin_tile_x, int origin_tile_y){
+	if (jobs == NULL || count <= batch_chunk_size){
+		for (int i = 0; i < count; i++){
+			hits[i] = cast(map, layer, tile_size, rays[i], origin_tile_x, origin_tile_y);
+		}
+		return;
+	}
+
+	jobs->parallel_for(count, batch_chunk_size, [&](int begin, int end){
+		for (int i = begin; i < end; i++){
+			hits[i] = cast(map, layer, tile_size, rays[i], origin_tile_x, origin_tile_y);
+		}
+	});
+}
+
+bool TileRaycast::line_of_sight(const FlareMap& map, int layer, float tile_size, float from_x, float from_y, float to_x, float to_y, int origin_tile_x, int origin_tile_y){
+	TileRay ray = { from_x, from_y, to_x - from_x, to_y - from_y, 0 };
+	ray.max_distance = sqrtf(ray.direction_x * ray.direction_x + ray.direction_y * ray.direction_y);
+	if (ray.max_distance == 0){
+		return true;
+	}
+	return !cast(map, layer, tile_size, ray, origin_tile_x, origin_tile_y).hit;
+}
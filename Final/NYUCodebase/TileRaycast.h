@@ -0,0 +1,47 @@
+#ifndef TILERAYCAST_H
+#define TILERAYCAST_H
+
+#include "FlareMap.h"
+#include "JobSystem.h"
+
+struct TileRay{
+	float origin_x;
+	float origin_y;
+	float direction_x; //needn't be normalized
+	float direction_y;
+	float max_distance;
+};
+
+struct TileHit{
+	bool hit = false;
+	int tile_x = -1;
+	int tile_y = -1;
+	unsigned int tile = 0;
+	float distance = 0;
+	float x = 0;
+	float y = 0;
+	float normal_x = 0;
+	float normal_y = 0;
+};
+
+//Grid DDA over one map layer: steps tile boundary to tile boundary and stops
+//at the first non-zero tile. Uses the same world/tile mapping as the
+//collision code, floorf(x / tile_size) and floorf(-y / tile_size). Outside the
+//map counts as empty. Only reads the map, so any number of threads can cast.
+//
+//Ray origins and hit points are relative to tile origin_tile_x, origin_tile_y
+//(App's floating origin), like CollisionMesh::query_box; hit tiles are map tiles.
+class TileRaycast{
+public:
+	static TileHit cast(const FlareMap& map, int layer, float tile_size, const TileRay& ray, int origin_tile_x = 0, int origin_tile_y = 0);
+
+	//hits[i] answers rays[i]. With a job system, big batches are split across its workers.
+	static void cast(const FlareMap& map, int layer, float tile_size, const TileRay* rays, int count, TileHit* hits, JobSystem* jobs = NULL, int origin_tile_x = 0, int origin_tile_y = 0);
+
+	//True when nothing solid lies between the two points
+	static bool line_of_sight(const FlareMap& map, int layer, float tile_size, float from_x, float from_y, float to_x, float to_y, int origin_tile_x = 0, int origin_tile_y = 0);
+
+	static int batch_chunk_size; //rays per job
+};
+
+#endif
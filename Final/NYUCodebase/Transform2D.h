@@ -0,0 +1,69 @@
+#ifndef TRANSFORM2D_H
+#define TRANSFORM2D_H
+
+#include <math.h>
+#include "Matrix.h"
+
+//VS2013 (v120) has no constexpr
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define TRANSFORM2D_CONSTEXPR inline
+#else
+#define TRANSFORM2D_CONSTEXPR constexpr
+#endif
+
+//2D affine transform, the 2x3 part of a Matrix that sprites actually use.
+//Uses the same row vector order as Matrix: (a * b) applies a first, then b.
+//	x' = a * x + c * y + tx
+//	y' = b * x + d * y + ty
+struct Transform2D{
+	float a, b, c, d;
+	float tx, ty;
+
+	TRANSFORM2D_CONSTEXPR Transform2D() : a(1), b(0), c(0), d(1), tx(0), ty(0) {}
+
+	TRANSFORM2D_CONSTEXPR Transform2D(float a_, float b_, float c_, float d_, float tx_, float ty_) : a(a_), b(b_), c(c_), d(d_), tx(tx_), ty(ty_) {}
+
+	static TRANSFORM2D_CONSTEXPR Transform2D translate(float x, float y){
+		return Transform2D(1, 0, 0, 1, x, y);
+	}
+
+	static TRANSFORM2D_CONSTEXPR Transform2D scale(float x, float y){
+		return Transform2D(x, 0, 0, y, 0, 0);
+	}
+
+	//direction_x is -1 or 1, like GameObject::direction[0]
+	static TRANSFORM2D_CONSTEXPR Transform2D flip(float direction_x){
+		return Transform2D(direction_x, 0, 0, 1, 0, 0);
+	}
+
+	//Same sign convention as Matrix::SetRotation
+	static inline Transform2D rotate(float radians){
+		return Transform2D(cosf(radians), sinf(radians), -sinf(radians), cosf(radians), 0, 0);
+	}
+
+	TRANSFORM2D_CONSTEXPR Transform2D operator * (const Transform2D& o) const {
+		return Transform2D(a * o.a + b * o.c, a * o.b + b * o.d,
+			c * o.a + d * o.c, c * o.b + d * o.d,
+			tx * o.a + ty * o.c + o.tx, tx * o.b + ty * o.d + o.ty);
+	}
+
+	inline void apply(float x, float y, float* out_x, float* out_y) const {
+		*out_x = a * x + c * y + tx;
+		*out_y = b * x + d * y + ty;
+	}
+
+	//Only needed at the GL boundary, when a uniform has to be uploaded
+	inline Matrix to_matrix(float z = 0) const {
+		Matrix m;
+		m.m[0][0] = a;
+		m.m[0][1] = b;
+		m.m[1][0] = c;
+		m.m[1][1] = d;
+		m.m[3][0] = tx;
+		m.m[3][1] = ty;
+		m.m[3][2] = z;
+		return m;
+	}
+};
+
+#endif
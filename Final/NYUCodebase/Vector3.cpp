@@ -51,6 +51,12 @@ Vector3 Vector3::operator * (const Matrix &m){
 	return new_v3;
 }
 
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be three packed floats");
+
+void Vector3::transform(const Vector3* in, Vector3* out, int count, const Matrix &m){
+	m.TransformVectors(&in->x, &out->x, count);
+}
+
 void Vector3::clear(){
 	init(0, 0, 0);
 }
@@ -24,6 +24,9 @@ public:
 
 	Vector3 operator * (const Matrix &m);
 
+	//Same as out[i] = in[i] * m for count vectors, in one call
+	static void transform(const Vector3* in, Vector3* out, int count, const Matrix &m);
+
 	void clear();
 };
 
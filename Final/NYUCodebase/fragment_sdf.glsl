@@ -0,0 +1,11 @@
+uniform sampler2D diffuse;
+uniform vec4 color;
+varying vec2 texCoordVar;
+
+//Alpha holds the distance to the glyph edge, 0.5 on the edge and above 0.5 inside
+void main() {
+	float distance = texture2D(diffuse, texCoordVar).a;
+	float smoothing = 0.7 * fwidth(distance);
+	float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+	gl_FragColor = vec4(color.rgb, color.a * alpha);
+}
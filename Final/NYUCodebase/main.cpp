@@ -85,11 +85,12 @@ public:
 
 	void render(){
 
-		app->draw_text("Platformer", -1.5f, 1.0f, app->font_texture, 0.4, 0.165f);
-		app->draw_text("Press Spacebar to play", -1.5f, 0.0f, app->font_texture, 0.4, 0.165f);
-		app->draw_text("Press ESC to quit", -1.5f, -0.5f, app->font_texture, 0.4, 0.165f);
+		app->hud_font.add_text("Platformer", -1.5f, 1.0f, 0.6f);
+		app->hud_font.add_text("Press Spacebar to play", -1.5f, 0.0f, 0.4f);
+		app->hud_font.add_text("Press ESC to quit", -1.5f, -0.5f, 0.4f);
 
-		app->draw_text("Controls: Press K to shoot. Spacebar to jump", -1.5f, -1.0f, app->font_texture, 0.4, 0.165f);
+		app->hud_font.add_text("Controls: Press K to shoot. Spacebar to jump", -1.5f, -1.0f, 0.4f);
+		app->hud_font.flush(app->sdf_program, app->projectionMatrix, app->viewMatrix);
 	}
 
 	void update(){
@@ -159,15 +160,38 @@ bool shouldRemoveEnemy(GameObject enemy) {
 class Level {
 public:
 	std::string name;
+	//Not WAV, so MusicStream hands it to SDL_mixer and level changes fade it in
+	//instead of crossfading. Every level shares it for now, so play() skips it.
+	std::string music = "resources/ffx.mp3";
 	GLuint tile_texture;
 	float tile_sheet_width = 0;
 	float tile_sheet_height = 0;
 	std::shared_ptr<App> app;
 
 
+	//Set while the tile sheet is still streaming in
+	std::shared_ptr<TextureAsset> tile_asset;
+
 	Level(const std::string& name_){
 		name = name_;
 	}
+
+	void load_tile_texture_async(){
+		tile_asset = app->assets->load_texture("resources/" + name + ".png");
+	}
+
+	//Blocks until the tile sheet is on the GPU
+	void resolve_tile_texture(){
+		if (!tile_asset){
+			return;
+		}
+
+		app->assets->wait(tile_asset);
+		tile_texture = tile_asset->texture;
+		tile_sheet_width = tile_asset->width;
+		tile_sheet_height = tile_asset->height;
+		tile_asset.reset();
+	}
 };
 
 
@@ -199,8 +223,11 @@ public:
 	int enemies_per_row = 11;
 
 
-	std::vector<float> verts;
-	std::vector<float> tex_coords;
+	//Decoration layers baked into chunk textures, collision layer and up as tile quads.
+	//Both are patched in place by set_tile.
+	TileBake* tile_bake = NULL;
+	TileMesh* tile_mesh = NULL;
+	bool paths_dirty = false; //flow field and nav graph wait for the tick's edits
 
 
 	GameObject box;
@@ -227,17 +254,14 @@ public:
 		enemy_ground_spike->set_draw_mode("texture");
 		enemy_ground_spike->set_velocity(speed * direction, 0);
 		enemy_ground_spike->apply_velocity = true;
-		enemy_ground_spike->set_size(0.36, 0.36);
+		enemy_ground_spike->set_size(ground_spike_size, ground_spike_size);
 		enemy_ground_spike->set_verts(app->quad_verts(enemy_ground_spike->size.x, enemy_ground_spike->size.y));
 		enemy_ground_spike->set_direction(1, 0.0f);
 		enemy_ground_spike->apply_gravity = false;
 
 		enemy_ground_spike->acceleration.x = 0;
 		enemy_ground_spike->set_app(app);
-		Animation ground_spike_animation = load_animation_from_sheet("resources/ground_spike.png", 7, 24, 24, enemy_ground_spike->size.x);
-		ground_spike_animation.interval = 0.05;
-		ground_spike_animation.set_app(app);
-		enemy_ground_spike->add_animation("idle", ground_spike_animation);
+		enemy_ground_spike->add_animation("idle", ground_spike_clip);
 		enemy_ground_spike->set_animation("idle");
 
 
@@ -250,24 +274,71 @@ public:
 
 	float health_bar_height = 0.8f;
 
+	//Scheduler ids. Physics runs every tick, the rest at their own rates (Hz).
+	int physics_system;
+	int script_system;
+	int sight_system;
+	int animation_system;
+	int gui_system;
+	float script_rate = 10.0f;
+	float sight_rate = 10.0f;
+	float animation_rate = 30.0f;
+	float gui_rate = 10.0f;
+
+	std::shared_ptr<Animation> bullet_clip;
+	std::shared_ptr<Animation> spell_hit_clip;
+	std::shared_ptr<Animation> ground_spike_clip;
+	std::shared_ptr<Animation> greymon_clip;
+	float ground_spike_size = 0.36f;
+	std::vector<Animator*> animators; //gathered for the batch pass, reused
+
 	GameLevel(std::shared_ptr<App> app_){
 		app = app_;
+
+		physics_system = app->scheduler.add("physics", 0);
+		script_system = app->scheduler.add("scripts", script_rate);
+		sight_system = app->scheduler.add("sight", sight_rate);
+		animation_system = app->scheduler.add("animation", animation_rate);
+		gui_system = app->scheduler.add("gui", gui_rate);
 		sprite_sheet_texture = app->LoadTexture("resources/sheet.png", &sheet_width, &sheet_height);
 
+		//Every shot and hit plays these, each with its own Animator
+		bullet_clip = std::make_shared<Animation>();
+		bullet_clip->add_sprite(Sprite("resources/blast_1_1.png"));
+		bullet_clip->add_sprite(Sprite("resources/blast_1_2.png"));
+		bullet_clip->set_app(app);
+
+		spell_hit_clip = std::make_shared<Animation>();
+		spell_hit_clip->add_sprite(Sprite("resources/blast_hit_1.png"));
+		spell_hit_clip->add_sprite(Sprite("resources/blast_hit_2.png"));
+		spell_hit_clip->add_sprite(Sprite("resources/blast_hit_3.png"));
+		spell_hit_clip->add_sprite(Sprite("resources/blast_hit_4.png"));
+		spell_hit_clip->loop = false;
+		spell_hit_clip->set_app(app);
 
+		//And every enemy of a kind shares its clip
+		ground_spike_clip = std::make_shared<Animation>(load_animation_from_sheet("resources/ground_spike.png", 7, 24, 24, ground_spike_size));
+		ground_spike_clip->interval = 0.05;
+		ground_spike_clip->set_app(app);
 
+		greymon_clip = std::make_shared<Animation>("greymon_idle", 1);
+		greymon_clip->set_app(app);
 
+
+
+
+		//Tile sheets decode in the background; load_current_level waits for the one it needs
 		Level* level1 = new Level("map_1");
 		level1->app = app;
-		level1->tile_texture = app->LoadTexture("resources/map_1.png", &level1->tile_sheet_width, &level1->tile_sheet_height);
+		level1->load_tile_texture_async();
 
 		Level* level2 = new Level("map_2");
 		level2->app = app;
-		level2->tile_texture = app->LoadTexture("resources/map_2.png", &level2->tile_sheet_width, &level2->tile_sheet_height);
+		level2->load_tile_texture_async();
 
 		Level* level3 = new Level("map_3");
 		level3->app = app;
-		level3->tile_texture = app->LoadTexture("resources/map_3.png", &level3->tile_sheet_width, &level3->tile_sheet_height);
+		level3->load_tile_texture_async();
 
 		levels.push_back(level1);
 		levels.push_back(level2);
@@ -335,8 +406,9 @@ public:
 
 
 
-		float health_bar_x = 0.5f;
-		float health_bar_y = 0.5f;
+		//Screen space, the HUD pass draws without the camera
+		float health_bar_x = app->screen_left + 0.25f;
+		float health_bar_y = app->screen_top - 0.5f;
 
 		GameObject red_bar;
 		red_bar.set_app(app);
@@ -382,148 +454,234 @@ public:
 	}
 
 
-	void load_current_level(){
-
-		for (int x = 0; x < enemies.size(); x++){
-			delete enemies[x];
+	//What a level needs that doesn't touch GL: parsed map, tile geometry and
+	//the enemies to spawn. Built off the main thread for the next level.
+	struct EnemySpawn{
+		std::string type;
+		float x;
+		float y;
+		float speed;
+		float direction;
+	};
+
+	struct PreparedLevel{
+		int index;
+		FlareMap* map = NULL;
+		TileBake* bake = NULL;
+		TileMesh* tiles = NULL;
+		CollisionMesh* collision = NULL;
+		FlowField* flow = NULL;
+		NavGraph* nav = NULL;
+		std::vector<EnemySpawn> spawns;
+	};
+
+	//Start building the next level once the player is this far through the current one
+	float prefetch_threshold = 0.5f;
+	int prefetch_index = -1;
+	PreparedLevel* prefetched = NULL;
+	std::thread prefetch_thread;
+
+	std::vector<EnemySpawn> level_spawns(int index){
+		if (index == 0){
+			return{
+				{ "ground_spike", 7.0f, -3.2f, 5, -1 },
+				{ "ground_spike", 3.2f, -3.2f, 2, 1 },
+				{ "ground_spike", 14.0f, -3.2f, 2.5f, 1 },
+				{ "ground_spike", 15.0f, -3.2f, 3.0f, -1 },
+				{ "greymon", 11.4f, -1.6f, 0, -1 },
+				{ "greymon", 16.4f, -2.0f, 0, -1 },
+			};
 		}
-
-		enemies.clear();
-
-		if (current_level_index == 0){
-
-			enemies.push_back(create_ground_spike(7.0f, -3.2f, 5, -1));
-			enemies.push_back(create_ground_spike(3.2f, -3.2f, 2, 1));
-			enemies.push_back(create_ground_spike(14.0f, -3.2f, 2.5f, 1));
-			enemies.push_back(create_ground_spike(15.0f, -3.2f, 3.0f, -1));
-
-
-
-			GameObject* enemy = new GameObject("greymon");
-			enemy->set_app(app);
-			enemy->set_pos(11.4f, -1.6f, 0);
-			enemy->set_draw_mode("texture");
-			enemy->set_velocity(0, 0);
-			enemy->apply_velocity = false;
-			enemy->set_size(0.5, 0.7);
-			enemy->set_verts(app->quad_verts(enemy->size.x, enemy->size.y));
-			enemy->set_direction(-1, 0.0f);
-			enemy->add_animation("idle", 1);
-			enemy->set_animation("idle");
-			enemy->constant_x_velocity = false;
-			enemy->acceleration.x = 0.0f;
-
-			enemies.push_back(enemy);
-
-
-
-
-
-			GameObject* enemy2 = new GameObject("greymon");
-			enemy2->set_app(app);
-			enemy2->set_pos(16.4f, -2.0f, 0);
-			enemy2->set_draw_mode("texture");
-			enemy2->set_velocity(0, 0);
-			enemy2->apply_velocity = false;
-			enemy2->set_size(0.5, 0.7);
-			enemy2->set_verts(app->quad_verts(enemy->size.x, enemy->size.y));
-			enemy2->set_direction(-1, 0.0f);
-			enemy2->add_animation("idle", 1);
-			enemy2->set_animation("idle");
-			enemy2->constant_x_velocity = false;
-			enemy2->acceleration.x = 0.0f;
-
-			enemies.push_back(enemy2);
+		else if (index == 1){
+			return{
+				{ "ground_spike", 2.0f, -3.0f, 5, -1 },
+				{ "ground_spike", 2.4f, -3.0f, 2, 1 },
+				{ "ground_spike", 5.0f, -3.65f, 8, -1 },
+				{ "ground_spike", 5.4f, -3.65f, 3, 1 },
+				{ "ground_spike", 14.4f, -3.7f, 2.5f, 1 },
+				{ "ground_spike", 15.7f, -3.7f, 3.0f, -1 },
+				{ "greymon", 16.4f, -2.0f, 0, -1 },
+			};
+		}
+		else if (index == 2){
+			return{
+				{ "ground_spike", 2.0f, -3.0f, 3, -1 },
+				{ "ground_spike", 2.4f, -3.0f, 2, 1 },
+				{ "ground_spike", 2.2f, -3.0f, 1, 1 },
+				{ "ground_spike", 5.0f, -3.65f, 8, -1 },
+				{ "ground_spike", 5.4f, -3.65f, 3, 1 },
+				{ "ground_spike", 8.0f, -3.65f, 8, -1 },
+				{ "ground_spike", 8.4f, -3.65f, 3, 1 },
+				{ "ground_spike", 8.2f, -3.65f, 5, 1 },
+				{ "ground_spike", 14.4f, -3.7f, 2.5f, 1 },
+				{ "ground_spike", 15.7f, -3.7f, 3.0f, -1 },
+			};
 		}
-		else if (current_level_index == 1){
-			enemies.push_back(create_ground_spike(2.0f, -3.0f, 5, -1));
-			enemies.push_back(create_ground_spike(2.4f, -3.0f, 2, 1));
 
-			enemies.push_back(create_ground_spike(5.0f, -3.65f, 8, -1));
-			enemies.push_back(create_ground_spike(5.4f, -3.65f, 3, 1));
+		return{};
+	}
 
+	GameObject* create_greymon(float x, float y, float direction){
+		GameObject* enemy = new GameObject("greymon");
+		enemy->set_app(app);
+		enemy->set_pos(x, y, 0);
+		enemy->set_draw_mode("texture");
+		enemy->set_velocity(0, 0);
+		enemy->apply_velocity = false;
+		enemy->set_size(0.5, 0.7);
+		enemy->set_verts(app->quad_verts(enemy->size.x, enemy->size.y));
+		enemy->set_direction(direction, 0.0f);
+		enemy->add_animation("idle", greymon_clip);
+		enemy->set_animation("idle");
+		enemy->constant_x_velocity = false;
+		enemy->acceleration.x = 0.0f;
+		return enemy;
+	}
 
-			enemies.push_back(create_ground_spike(14.4f, -3.7f, 2.5f, 1));
-			enemies.push_back(create_ground_spike(15.7f, -3.7f, 3.0f, -1));
+	//Safe off the main thread once the level's tile sheet is resolved
+	PreparedLevel* prepare_level(int index){
+		Level* level = levels[index];
 
+		PreparedLevel* prepared = new PreparedLevel();
+		prepared->index = index;
+		prepared->spawns = level_spawns(index);
 
+		prepared->map = new FlareMap();
+		prepared->map->Load("resources/" + level->name + ".txt");
 
+		std::vector<int> baked_layers;
+		std::vector<int> mesh_layers;
+		for (int z = 0; z < prepared->map->layers.size(); z++){
+			if (z < app->collision_layer){
+				baked_layers.push_back(z);
+			}
+			else{
+				mesh_layers.push_back(z);
+			}
+		}
 
-			GameObject* enemy2 = new GameObject("greymon");
-			enemy2->set_app(app);
-			enemy2->set_pos(16.4f, -2.0f, 0);
-			enemy2->set_draw_mode("texture");
-			enemy2->set_velocity(0, 0);
-			enemy2->apply_velocity = false;
-			enemy2->set_size(0.5, 0.7);
-			enemy2->set_verts(app->quad_verts(enemy2->size.x, enemy2->size.y));
-			enemy2->set_direction(-1, 0.0f);
-			enemy2->add_animation("idle", 1);
-			enemy2->set_animation("idle");
-			enemy2->constant_x_velocity = false;
-			enemy2->acceleration.x = 0.0f;
+		//CPU only, textures and buffers are created on first draw
+		prepared->bake = new TileBake();
+		prepared->bake->build(*prepared->map, baked_layers, "resources/" + level->name + ".png", app->TILE_SIZE, app->tile_world_size);
+		prepared->tiles = new TileMesh();
+		prepared->tiles->build(*prepared->map, mesh_layers, level->tile_sheet_width, level->tile_sheet_height, app->TILE_SIZE, app->tile_world_size);
+		prepared->collision = new CollisionMesh();
+		prepared->collision->build(*prepared->map, app->collision_layer, app->tile_world_size);
+		prepared->flow = new FlowField();
+		prepared->flow->build(*prepared->map, app->collision_layer, app->tile_world_size);
+		prepared->nav = new NavGraph();
+		prepared->nav->timestep = app->sim_timestep;
+		prepared->nav->build(*prepared->map, app->collision_layer, app->tile_world_size);
+
+		return prepared;
+	}
 
-			enemies.push_back(enemy2);
-			
+	void start_prefetch(int index){
+		if (index >= levels.size() || prefetch_index == index){
+			return;
 		}
-		else if (current_level_index == 2){
-			enemies.push_back(create_ground_spike(2.0f, -3.0f, 3, -1));
-			enemies.push_back(create_ground_spike(2.4f, -3.0f, 2, 1));
-			enemies.push_back(create_ground_spike(2.2f, -3.0f, 1, 1));
 
+		cancel_prefetch();
 
-			enemies.push_back(create_ground_spike(5.0f, -3.65f, 8, -1));
-			enemies.push_back(create_ground_spike(5.4f, -3.65f, 3, 1));
+		//Tile sheet uploads have to happen here; they were queued back in the constructor
+		levels[index]->resolve_tile_texture();
 
-			enemies.push_back(create_ground_spike(8.0f, -3.65f, 8, -1));
-			enemies.push_back(create_ground_spike(8.4f, -3.65f, 3, 1));
-			enemies.push_back(create_ground_spike(8.2f, -3.65f, 5, 1));
-
-			enemies.push_back(create_ground_spike(14.4f, -3.7f, 2.5f, 1));
-			enemies.push_back(create_ground_spike(15.7f, -3.7f, 3.0f, -1));
+		prefetch_index = index;
+		prefetch_thread = std::thread([this, index]{
+			prefetched = prepare_level(index);
+		});
+	}
 
+	void cancel_prefetch(){
+		if (prefetch_thread.joinable()){
+			prefetch_thread.join();
 		}
 
+		if (prefetched != NULL){
+			delete prefetched->map;
+			delete prefetched->bake;
+			delete prefetched->tiles;
+			delete prefetched->collision;
+			delete prefetched->flow;
+			delete prefetched->nav;
+			delete prefetched;
+			prefetched = NULL;
+		}
+		prefetch_index = -1;
+	}
 
+	void load_current_level(){
+		PreparedLevel* prepared = NULL;
+		if (prefetch_index == current_level_index){
+			//Usually finished long ago, otherwise only the remainder is waited on
+			prefetch_thread.join();
+			prepared = prefetched;
+			prefetched = NULL;
+			prefetch_index = -1;
+		}
+		else{
+			cancel_prefetch();
+			current_level()->resolve_tile_texture();
+			prepared = prepare_level(current_level_index);
+		}
 
-		verts.clear();
-		tex_coords.clear();
-
+		//Everything below is swaps and spawns, no parsing or geometry
+		for (int x = 0; x < enemies.size(); x++){
+			delete enemies[x];
+		}
+		enemies.clear();
 
+		for (int i = 0; i < prepared->spawns.size(); i++){
+			const EnemySpawn& spawn = prepared->spawns[i];
+			if (spawn.type == "greymon"){
+				enemies.push_back(create_greymon(spawn.x, spawn.y, spawn.direction));
+			}
+			else{
+				enemies.push_back(create_ground_spike(spawn.x, spawn.y, spawn.speed, spawn.direction));
+			}
+		}
 
 		if (app->map != NULL){
 			delete app->map;
-			app->map = NULL;
 		}
+		app->map = prepared->map;
+		delete tile_bake;
+		tile_bake = prepared->bake;
+		delete tile_mesh;
+		tile_mesh = prepared->tiles;
+		delete app->collision;
+		app->collision = prepared->collision;
+		delete app->flow;
+		app->flow = prepared->flow;
+		delete app->nav;
+		app->nav = prepared->nav;
+		paths_dirty = false;
+		delete prepared;
+
+		app->music.play(current_level()->music, app->level_crossfade);
 
-		app->map = new FlareMap();
-		app->map->Load("resources/" + current_level()->name + ".txt");
 		for (int i = 0; i < app->map->entities.size(); i++) {
 			PlaceEntity(app->map->entities[i].type, app->map->entities[i].x * app->TILE_SIZE, app->map->entities[i].y * -app->TILE_SIZE);
 		}
 
+		app->camera.set_size(app->screen_width, app->screen_height);
+		app->camera.offset_y = -1.0f;
+		set_camera_bounds();
+		app->camera.snap(player.x(), player.y());
 
+		report_tile_fill();
 
-		for (int z = 0; z < app->map->layers.size(); z++){
-			//for (int z = 0; z < 1; z++){
-			for (int y = 0; y < app->map->mapHeight; y++) {
-				for (int x = 0; x < app->map->mapWidth; x++) {
-					// do something with map.mapData[y][x] 
-					//std::cout << map.mapData[y][x] << std::endl;
-					std::vector<float> this_verts;
-					std::vector<float> this_tex_coords;
-
-					load_tile(app->map->layers[z][y][x], x, y, this_verts, this_tex_coords);
-
-					verts.insert(verts.end(), this_verts.begin(), this_verts.end());
-					tex_coords.insert(tex_coords.end(), this_tex_coords.begin(), this_tex_coords.end());
-				}
-			}
-		}
+		//Everything uploaded so far, cooked vs the plain RGBA8 pngs with no mips it replaced
+		std::cout << "Level " << current_level_index + 1 << " texture VRAM: " << app->textures.resident_bytes() / 1024 << " KB ("
+			<< app->textures.baseline_bytes() / 1024 << " KB before cooking)" << std::endl;
 	}
 
 
 	~GameLevel(){
+		cancel_prefetch();
+		delete tile_bake;
+		delete tile_mesh;
+
 		for (int x = 0; x < objects.size(); x++){
 			delete objects[x];
 		}
@@ -542,8 +700,11 @@ public:
 	int movement_change_count = 0;
 
 	float last_movement = 0;
-	float last_attack = 0;
-	float attack_interval = 1.0f;
+	float last_attack = 0; //sim time
+	float greymon_sight_range = 6.0f;
+	std::vector<TileRay> sight_rays;
+	std::vector<TileHit> sight_hits;
+	float attack_interval = 3.0f; //sim seconds between greymon shots
 
 	int row_index = 0;
 	int row_change_count = 0;
@@ -563,79 +724,225 @@ public:
 
 
 	void enemy_shoot(GameObject* enemy){
-		Animation bullet_animation;
-		Sprite bullet_sprite_1_1("resources/blast_1_1.png");
-		Sprite bullet_sprite_1_2("resources/blast_1_2.png");
-		bullet_animation.add_sprite(bullet_sprite_1_1);
-		bullet_animation.add_sprite(bullet_sprite_1_2);
+		bullets.push_back(enemy->shoot(bullet_clip));
+	}
+
+	//Entities per job handed to the worker threads
+	int entity_chunk_size = 64;
 
-		bullets.push_back(enemy->shoot(bullet_animation));
+	void update_entity(GameObject& obj){
+		obj.defer_events = true;
+		obj.update();
 	}
 
-	void update(){
+	//Moves the floating origin to the given tile, shifting everything relative to it
+	void rebase_origin(int tile_x, int tile_y){
+		float shift_x = (tile_x - app->origin_tile_x) * app->tile_world_size;
+		float shift_y = (tile_y - app->origin_tile_y) * app->tile_world_size;
+		if (shift_x == 0 && shift_y == 0){
+			return;
+		}
+		app->origin_tile_x = tile_x;
+		app->origin_tile_y = tile_y;
+
+		app->camera.shift(-shift_x, shift_y);
+
+		auto shift = [shift_x, shift_y](GameObject& obj){
+			//Rows grow downwards, world y up
+			obj.pos.x -= shift_x;
+			obj.pos.y += shift_y;
+			obj.previous_pos.x -= shift_x;
+			obj.previous_pos.y += shift_y;
+			obj.start_pos.x -= shift_x;
+			obj.start_pos.y += shift_y;
+		};
+		shift(player);
+		shift(box);
+		shift(box2);
+		for (int i = 0; i < enemies.size(); i++){
+			shift(*enemies[i]);
+		}
+		for (int i = 0; i < objects.size(); i++){
+			shift(*objects[i]);
+		}
+		for (int i = 0; i < bullets.size(); i++){
+			shift(bullets[i]);
+		}
+		for (int i = 0; i < spells.size(); i++){
+			shift(spells[i]);
+		}
+	}
+
+	//Script logic (ground spike chasing) off the shared flow field
+	void update_scripts(){
+		//Only searches when the player reaches a new tile
+		app->flow->set_target(player.x(), player.y(), app->origin_tile_x, app->origin_tile_y);
+		app->flow->update();
+
+		player.update_scripts();
+		app->jobs->parallel_for(enemies.size(), entity_chunk_size, [this](int begin, int end){
+			for (int i = begin; i < end; i++) {
+				enemies[i]->update_scripts();
+			}
+		});
+		for (int i = 0; i < objects.size(); i++) {
+			objects[i]->update_scripts();
+		}
+	}
+
+	void update_physics(){
 		player.update();
 
+		//Integration and tile collision only touch each entity's own state (plus reads of the map and collision mesh),
+		//so they run in parallel chunks. Script events, spawns and destroys wait for the serial merge below.
+		app->jobs->parallel_for(bullets.size(), entity_chunk_size, [this](int begin, int end){
+			for (int i = begin; i < end; i++) {
+				update_entity(bullets[i]);
+			}
+		});
 
-		bullets.erase(std::remove_if(bullets.begin(), bullets.end(), shouldRemoveBullet), bullets.end());
+		app->jobs->parallel_for(enemies.size(), entity_chunk_size, [this](int begin, int end){
+			for (int i = begin; i < end; i++) {
+				update_entity(*enemies[i]);
+			}
+		});
 
-		enemies.erase(std::remove_if(enemies.begin(), enemies.end(), shouldRemoveObject), enemies.end());
-		//objects.erase(std::remove_if(objects.begin(), objects.end(), shouldRemoveObject), objects.end());
+		app->jobs->parallel_for(objects.size(), entity_chunk_size, [this](int begin, int end){
+			for (int i = begin; i < end; i++) {
+				update_entity(*objects[i]);
+			}
+		});
 
+		app->jobs->parallel_for(spells.size(), entity_chunk_size, [this](int begin, int end){
+			for (int i = begin; i < end; i++) {
+				update_entity(spells[i]);
+			}
+		});
+
+
+		//Serial merge, always in index order so the result doesn't depend on the thread count
 		for (int i = 0; i < bullets.size(); i++) {
-			bullets[i].update();
+			bullets[i].flush_events();
+		}
+
+		for (int i = 0; i < enemies.size(); i++) {
+			enemies[i]->flush_events();
+		}
+
+		for (int i = 0; i < objects.size(); i++) {
+			objects[i]->flush_events();
+		}
+
+		for (int i = 0; i < spells.size(); i++) {
+			spells[i].flush_events();
 		}
 
+		handle_collisions();
+	}
 
+	//Greymon line of sight, every ray in one batch, and attacks
+	void update_sight(){
+		sight_rays.clear();
 		for (int i = 0; i < enemies.size(); i++) {
-			
+			if (enemies[i]->name == "greymon"){
+				TileRay ray = { enemies[i]->x(), enemies[i]->y(), player.x() - enemies[i]->x(), player.y() - enemies[i]->y(), greymon_sight_range };
+				sight_rays.push_back(ray);
+			}
+		}
+		sight_hits.resize(sight_rays.size());
+		TileRaycast::cast(*app->map, app->collision_layer, app->tile_world_size, sight_rays.data(), sight_rays.size(), sight_hits.data(), app->jobs, app->origin_tile_x, app->origin_tile_y);
 
+		int sight_index = 0;
+		for (int i = 0; i < enemies.size(); i++) {
 			if (enemies[i]->name == "greymon"){
-				enemies[i]->update();
-				if (app->get_runtime() - last_attack > 3.0f){
+				const TileRay& ray = sight_rays[sight_index];
+				const TileHit& hit = sight_hits[sight_index++];
+				float player_distance = sqrtf(ray.direction_x * ray.direction_x + ray.direction_y * ray.direction_y);
+				bool can_see = player_distance <= greymon_sight_range && (!hit.hit || hit.distance >= player_distance);
+
+				if (can_see && app->scheduler.time() - last_attack > attack_interval){
 					//enemies[i]->direction[0] = player.velocity.x;
 					enemies[i]->velocity.x = player.velocity.x * -1;
-					last_attack = app->get_runtime();
+					last_attack = app->scheduler.time();
 					enemy_shoot(enemies[i]);
 				}
 			}
-			else{
-				enemies[i]->update();
-			}
 		}
+	}
 
-
+	//Frames come from each animator's sim time, so a lower animation_rate skips frames rather than slowing down
+	void update_animations(){
+		animators.clear();
+		animators.push_back(&player.animator);
+		for (int i = 0; i < enemies.size(); i++) {
+			animators.push_back(&enemies[i]->animator);
+		}
+		for (int i = 0; i < bullets.size(); i++) {
+			animators.push_back(&bullets[i].animator);
+		}
 		for (int i = 0; i < objects.size(); i++) {
-			objects[i]->update();
+			animators.push_back(&objects[i]->animator);
 		}
-
-
 		for (int i = 0; i < spells.size(); i++) {
-			spells[i].update();
+			animators.push_back(&spells[i].animator);
 		}
+		advance_animators(animators.data(), animators.size(), app->scheduler.elapsed(animation_system));
 
-
-		for (auto it = gui_objects.begin(); it != gui_objects.end(); ++it){
-			it->second.update();
+		player.update_animation();
+		for (int i = 0; i < bullets.size(); i++) {
+			bullets[i].update_animation();
 		}
+	}
 
-		
+	//Health bar, its verts only rebuilt when the player's life changed
+	void update_gui(){
+		GameObject& bar = gui_objects["health_bar"];
+		float height = health_bar_height * (player.life / player.max_life);
+		if (height == bar.size.y){
+			return;
+		}
 
+		bar.set_pos(bar.start_pos.x, bar.start_pos.y - (health_bar_height - height) / 2);
+		bar.size.y = height;
+		bar.set_verts(app->quad_verts(bar.size.x, height));
+	}
 
-		handle_collisions();
+	void update(){
+		//Only the axis that went past the limit moves, the other keeps its origin
+		int origin_x = fabs(player.x()) > app->rebase_distance ? app->tile_x(player.x()) : app->origin_tile_x;
+		int origin_y = fabs(player.y()) > app->rebase_distance ? app->tile_y(player.y()) : app->origin_tile_y;
+		rebase_origin(origin_x, origin_y);
+
+		//Only the cells around the edits, and the chunks whose edges cross the edited columns.
+		//A tick's worth of edits share one repair.
+		if (paths_dirty){
+			app->flow->repair(*app->map);
+			app->nav->update(*app->map);
+			paths_dirty = false;
+		}
 
-		float life_percent = (player.life / player.max_life);
+		bullets.erase(std::remove_if(bullets.begin(), bullets.end(), shouldRemoveBullet), bullets.end());
 
-		
-		gui_objects["health_bar"].pos.y = gui_objects["health_bar"].start_pos.y - ((health_bar_height - (health_bar_height * life_percent)) / 2);
-		gui_objects["health_bar"].size.y = health_bar_height * (player.life / player.max_life);
-		gui_objects["health_bar"].set_verts(app->quad_verts(gui_objects["health_bar"].size.x, gui_objects["health_bar"].size.y));
+		enemies.erase(std::remove_if(enemies.begin(), enemies.end(), shouldRemoveObject), enemies.end());
+		//objects.erase(std::remove_if(objects.begin(), objects.end(), shouldRemoveObject), objects.end());
 
+		app->scheduler.run(script_system, [this](){ update_scripts(); });
+		app->scheduler.run(physics_system, [this](){ update_physics(); });
+		app->scheduler.run(sight_system, [this](){ update_sight(); });
+		app->scheduler.run(animation_system, [this](){ update_animations(); });
+		app->scheduler.run(gui_system, [this](){ update_gui(); });
 
+		app->camera.follow(player.x(), player.y(), app->elapsed);
 
+		//Both edges relative to the origin, from whole tiles
+		if (player.pos.x > app->tile_left((int)(app->map->mapWidth * prefetch_threshold))){
+			start_prefetch(current_level_index + 1);
+		}
 
-		if (player.pos.x  > (app->map->mapWidth * app->tile_world_size) - 0.6f){
-			player.pos.x = player.start_pos.x;
-			player.pos.y = player.start_pos.y;
+		if (player.pos.x > app->tile_left(app->map->mapWidth) - 0.6f){
+			//The next level starts back at the map origin
+			rebase_origin(0, 0);
+			player.set_pos(player.start_pos.x, player.start_pos.y);
 			current_level_index += 1;
 
 
@@ -655,49 +962,38 @@ public:
 
 
 
-		//Move the camera to follow player
-		app->viewMatrix.Identity();
-
-		float clamped_screen_x = screen_x_clamp(player.x(), 0.0f, (app->map->mapWidth * app->tile_world_size) - app->tile_world_size);
-		float clamped_screen_y = screen_y_clamp(player.y() - 1.0f, 0.0f, (app->map->mapHeight * app->tile_world_size));
-		app->viewMatrix.Translate(-clamped_screen_x, -clamped_screen_y, 0);
+		app->camera.apply(app->viewMatrix, app->render_alpha);
 
 		//Draw tilemap
-		app->batch_draw(current_level()->tile_texture, verts, tex_coords);
+		app->batch_draw(*tile_bake);
+		app->batch_draw(current_level()->tile_texture, *tile_mesh);
 
 		box.set_pos(player.x(), player.y());
 		box2.set_pos(player.x(), player.y());
 
 		for (int i = 0; i < enemies.size(); i++) {
-			enemies[i]->draw();
+			draw_if_visible(*enemies[i]);
 		}
 
 		player.draw();
 
 		for (int i = 0; i < bullets.size(); i++) {
-			bullets[i].draw();
+			draw_if_visible(bullets[i]);
 		}
 
 		for (int i = 0; i < objects.size(); i++) {
-			objects[i]->draw();
+			draw_if_visible(*objects[i]);
 		}
 
 
 		for (int i = 0; i < spells.size(); i++) {
-			spells[i].draw();
+			draw_if_visible(spells[i]);
 		}
 
 
-
-		//float new_x = clamped_screen_x;
-
-
+		//HUD, fixed to the screen
+		app->viewMatrix.Identity();
 		for (auto it = gui_objects.begin(); it != gui_objects.end(); ++it){
-
-			//it->second.pos.x = new_x;
-			
-			it->second.pos.x = clamped_screen_x - 3.3f;
-			it->second.pos.y = clamped_screen_y + 1.5f;
 			it->second.draw();
 		}
 
@@ -707,62 +1003,67 @@ public:
 
 	}
 
-	float screen_y_clamp(float val, float top, float bottom){
-		if (val - (app->screen_height / 2) < top){
-			return top - (app->screen_height / 2);
+	void draw_if_visible(GameObject& obj){
+		if (app->camera.visible(obj.x(), obj.y(), obj.width(), obj.height())){
+			obj.draw();
 		}
-		else if (val + (app->screen_height / 2) > bottom){
-			return bottom + (app->screen_height / 2);
-		}
-
-		return val;
 	}
 
-
-	float screen_x_clamp(float val, float left, float right){
-		if (val - (app->screen_width / 2) < left){
-			return left + (app->screen_width / 2);
-		}
-		else if (val + (app->screen_width / 2) > right){
-			return right - (app->screen_width / 2);
-		}
-
-		return val;
+	//Same edges the view used to clamp to, in origin relative space
+	void set_camera_bounds(){
+		app->camera.set_bounds(app->tile_left(0), app->tile_left(app->map->mapWidth) - app->tile_world_size,
+			app->tile_top(app->map->mapHeight), app->tile_top(0));
 	}
 
 
 
-	void load_tile(int tile_id, int pos_x, int pos_y, std::vector<float>& verts, std::vector<float>& tex_coords){
-		if (tile_id == 0){
+	//Runtime map edits (doors, breakable blocks), from the main thread between
+	//entity updates. Collision sees the new tile right away, patched around
+	//the one rect it touches; the vertex buffer gets just this quad on the
+	//next draw; the flow field and nav graph catch up at the next update().
+	void set_tile(int layer, int x, int y, unsigned int tile_id){
+		if (!app->map->SetTile(layer, x, y, tile_id)){
 			return;
 		}
 
-		Level* level = current_level();
-
-
-		//Convert tile_id to x,y
-		//Starts from top left at 0 -> sheet_width
-		//then goes to next row starting from left
-		int tile_sheet_x_width = level->tile_sheet_width / app->TILE_SIZE; //x grid size
-		int tile_sheet_y_height = level->tile_sheet_height / app->TILE_SIZE; //x grid size
-		int tile_x = (tile_id % tile_sheet_x_width) - 1;
-		int tile_y = tile_id / tile_sheet_x_width;
-
-
-		//float tile_world_x = (pos_x * tile_size) - (screen_width / 2.0f);
-		//float tile_world_y = -1.0f*(pos_y * tile_size) + (screen_height / 2.0f);
-		float tile_world_x = (pos_x * app->tile_world_size);
-		float tile_world_y = -1.0f*(pos_y * app->tile_world_size);
-
-		
+		if (tile_bake->bakes(layer)){
+			tile_bake->set_tile(*app->map, x, y);
+		}
+		else{
+			tile_mesh->set_tile(layer, x, y, tile_id);
+		}
 
+		if (layer == app->collision_layer){
+			app->nav->invalidate_column(x);
+			app->flow->invalidate_tile(x, y);
+			app->collision->set_tile(x, y, tile_id != 0);
+			paths_dirty = true;
+		}
+	}
 
-		Sprite tile_sprite(level->tile_texture, (tile_x * app->TILE_SIZE) / level->tile_sheet_width, (tile_y * app->TILE_SIZE) / level->tile_sheet_height, app->TILE_SIZE / level->tile_sheet_width, app->TILE_SIZE / level->tile_sheet_height, app->tile_world_size);
+	//Fragments the tile pass shades per pixel of map, drawing every layer's quads vs the bake
+	void report_tile_fill(){
+		FlareMap* map = app->map;
+		int tile_texels = app->TILE_SIZE * app->TILE_SIZE;
+		float map_texels = (float)map->mapWidth * map->mapHeight * tile_texels;
+
+		int tile_quads = 0;
+		for (int z = 0; z < map->layers.size(); z++){
+			for (int y = 0; y < map->mapHeight; y++){
+				for (int x = 0; x < map->mapWidth; x++){
+					if (map->layers[z][y][x] != 0){
+						tile_quads++;
+					}
+				}
+			}
+		}
 
-		tile_sprite.set_pos(tile_world_x, tile_world_y, 0);
-		tile_sprite.set_vert_pos(tile_world_x, tile_world_y, 0);
-		verts = tile_sprite.get_verts();
-		tex_coords = tile_sprite.get_tex_coords();
+		int mesh_quads = tile_mesh->quad_count();
+		float before = tile_quads * tile_texels / map_texels;
+		float after = (tile_bake->covered_texels() + mesh_quads * tile_texels) / map_texels;
+		std::cout << "Level " << current_level_index + 1 << " tiles: " << tile_quads << " quads, " << before << " fragments/pixel -> "
+			<< tile_bake->chunk_count() << " baked chunks (" << tile_bake->texture_bytes() / 1024 << " KB) + " << mesh_quads
+			<< " quads, " << after << " fragments/pixel" << std::endl;
 	}
 
 
@@ -792,18 +1093,6 @@ public:
 
 
 	GameObject create_spell_hit(Vector3 pos){
-		Animation spell_hit_animation;
-		Sprite blast_hit_1("resources/blast_hit_1.png");
-		Sprite blast_hit_2("resources/blast_hit_2.png");
-		Sprite blast_hit_3("resources/blast_hit_3.png");
-		Sprite blast_hit_4("resources/blast_hit_4.png");
-		spell_hit_animation.add_sprite(blast_hit_1);
-		spell_hit_animation.add_sprite(blast_hit_2);
-		spell_hit_animation.add_sprite(blast_hit_3);
-		spell_hit_animation.add_sprite(blast_hit_4);
-
-		spell_hit_animation.loop = false;
-
 
 		//GameObject* new_spell_hit = new GameObject();
 		//new_spell_hit->set_pos(pos.x, pos.y);
@@ -833,8 +1122,7 @@ public:
 		new_spell_hit.check_collisions = false;
 
 
-		spell_hit_animation.set_app(app);
-		new_spell_hit.add_animation("idle", spell_hit_animation);
+		new_spell_hit.add_animation("idle", spell_hit_clip);
 		new_spell_hit.set_animation("idle");
 
 		return new_spell_hit;
@@ -953,15 +1241,18 @@ public:
 				}
 
 
+				if (event.key.keysym.sym == SDLK_F3){
+					app->show_debug_overlay = !app->show_debug_overlay;
+				}
+
+				if (event.key.keysym.sym == SDLK_F4){
+					app->textures.dump();
+				}
+
 				if (event.key.keysym.sym == SDLK_k){
 
 					player.set_animation("idle_shoot");
-					Animation bullet_animation;
-					Sprite bullet_sprite_1_1("resources/blast_1_1.png");
-					Sprite bullet_sprite_1_2("resources/blast_1_2.png");
-					bullet_animation.add_sprite(bullet_sprite_1_1);
-					bullet_animation.add_sprite(bullet_sprite_1_2);
-					GameObject bullet_ = player.shoot(bullet_animation);
+					GameObject bullet_ = player.shoot(bullet_clip);
 					bullet_.strings["shooter_name"] = "hero";
 
 					bullets.push_back(bullet_);
@@ -993,17 +1284,21 @@ void render_game() {
 	}
 	else if (app->mode == app->STATE_GAME_OVER){
 		glClear(GL_COLOR_BUFFER_BIT);
-		app->viewMatrix.SetPosition(0, 0, 0);
-		app->draw_text("GAME OVER", -1.25f, 0, app->font_texture, 0.5, 0.3);
+		//Screen space, the camera is still wherever the level left it
+		Matrix screen_view;
+		app->hud_font.add_text("GAME OVER", -1.25f, 0, 0.6f);
+		app->hud_font.flush(app->sdf_program, app->projectionMatrix, screen_view);
 	}
 	else if (app->mode == app->STATE_GAME_WON){
-		app->viewMatrix.SetPosition(0, 0, 0);
 		glClear(GL_COLOR_BUFFER_BIT);
-		app->draw_text("YOU WON", -1.25f, 0, app->font_texture, 0.5, 0.3);
+		Matrix screen_view;
+		app->hud_font.add_text("YOU WON", -1.25f, 0, 0.6f);
+		app->hud_font.flush(app->sdf_program, app->projectionMatrix, screen_view);
 	}
 }
 
 void update_game() {
+	app->scheduler.begin_tick();
 	if (app->mode == app->STATE_MAIN_MENU){
 		mainMenu->update();
 	}
@@ -1038,6 +1333,14 @@ int right_score = 0;
 
 int main(int argc, char *argv[]) {
 
+	//--sim-rate 30 ticks the simulation at 30 Hz, rendering still blends every frame
+	for (int i = 1; i + 1 < argc; i++){
+		if (std::string(argv[i]) == "--sim-rate" && atoi(argv[i + 1]) > 0){
+			app->sim_timestep = 1.0f / atoi(argv[i + 1]);
+		}
+	}
+
+	app->scheduler.set_tick_rate(1.0f / app->sim_timestep);
 	app->init();
 
 	mainMenu = new MainMenu(app);
@@ -1045,7 +1348,7 @@ int main(int argc, char *argv[]) {
 	gameLevel = new GameLevel(app);
 
 	float lastFrameTicks = 0.0f;
-	float FIXED_TIMESTEP = 0.0166666f;
+	float FIXED_TIMESTEP = app->sim_timestep;
 	float MAX_TIMESTEPS = 6;
 	float accumulator = 0.0f;
 	float elapsed2 = 0.0f;
@@ -1057,23 +1360,30 @@ int main(int argc, char *argv[]) {
 		lastFrameTicks = ticks;
 
 		elapsed2 += accumulator;
-		if (elapsed2 < FIXED_TIMESTEP){
-			accumulator = elapsed2;
-			continue;
-		}
 
+		//Every frame renders, ticks or not; the swap interval paces the loop
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		process_input();
 		while (elapsed2 >= FIXED_TIMESTEP){
 			app->elapsed = FIXED_TIMESTEP;
 			update_game();
+			app->sounds.end_tick();
 			elapsed2 -= FIXED_TIMESTEP;
 		}
 		accumulator = elapsed2;
+		app->render_alpha = accumulator / FIXED_TIMESTEP;
+
+		//Finish whatever finished decoding, without blowing the frame
+		app->assets->process_uploads(app->upload_budget);
+
 		render_game();
+		app->draw_debug_overlay();
 
 		SDL_GL_SwapWindow(app->displayWindow);
+		app->boot_profile.first_frame();
+		app->textures.end_frame();
+		app->music.update();
 	}
 
 	//VARIABLE TIMESTEP:
@@ -1096,6 +1406,11 @@ int main(int argc, char *argv[]) {
 	delete gameLevel;
 	delete app->tex_program;
 	delete app->shape_program;
+	delete app->sdf_program;
+	delete app->jobs;
+	delete app->assets;
+	app->sounds.stop();
+	app->music.close();
 
 
 
@@ -0,0 +1,68 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <math.h>
+#include <chrono>
+
+//Minimal test runner. TEST bodies run every time, BENCHMARK bodies only with --bench.
+//A failed CHECK prints where it failed and the run keeps going.
+
+typedef void(*TestFunction)();
+
+struct TestCase{
+	const char* name;
+	TestFunction fn;
+	bool benchmark;
+};
+
+std::vector<TestCase>& test_registry();
+int& test_failures();
+
+struct TestRegistrar{
+	TestRegistrar(const char* name, TestFunction fn, bool benchmark){
+		TestCase test_case;
+		test_case.name = name;
+		test_case.fn = fn;
+		test_case.benchmark = benchmark;
+		test_registry().push_back(test_case);
+	}
+};
+
+#define TEST(name) \
+	static void name(); \
+	static TestRegistrar name##_registrar(#name, name, false); \
+	static void name()
+
+#define BENCHMARK(name) \
+	static void name(); \
+	static TestRegistrar name##_registrar(#name, name, true); \
+	static void name()
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)){ \
+			std::cout << "  FAILED " << __FILE__ << ":" << __LINE__ << ": " << #condition << std::endl; \
+			test_failures()++; \
+		} \
+	} while (0)
+
+#define CHECK_NEAR(a, b, tolerance) \
+	do { \
+		double check_a = (a); \
+		double check_b = (b); \
+		if (fabs(check_a - check_b) > (tolerance)){ \
+			std::cout << "  FAILED " << __FILE__ << ":" << __LINE__ << ": " << #a << " = " << check_a \
+				<< ", " << #b << " = " << check_b << std::endl; \
+			test_failures()++; \
+		} \
+	} while (0)
+
+//Wall clock seconds, for the benchmarks
+inline double bench_seconds(){
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include "TestWorld.h"
+
+void make_test_gl_context(){
+	static bool made = false;
+	if (!made){
+		SDL_Init(SDL_INIT_VIDEO);
+		SDL_Window* window = SDL_CreateWindow("Tests", 0, 0, 64, 64, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+		SDL_GLContext context = SDL_GL_CreateContext(window);
+		SDL_GL_MakeCurrent(window, context);
+#ifdef _WINDOWS
+		glewInit();
+#endif
+		made = true;
+	}
+}
+
+TestWorld::TestWorld(const std::vector<std::string>& rows, int worker_count, int rows_above_){
+	app = std::make_shared<App>();
+	app->elapsed = app->sim_timestep;
+	rows_above = rows_above_;
+
+	FlareMap* map = new FlareMap();
+	map->mapHeight = rows_above + rows.size();
+	map->mapWidth = rows.empty() ? 0 : rows[0].size();
+
+	//Only the collision layer has anything in it, everything else is one shared empty row
+	empty_row = new unsigned int[map->mapWidth]();
+	empty_layer = new unsigned int*[map->mapHeight];
+	for (int y = 0; y < map->mapHeight; y++){
+		empty_layer[y] = empty_row;
+	}
+	map->mapData = empty_layer;
+	for (int layer = 0; layer < app->collision_layer; layer++){
+		map->layers.push_back(empty_layer);
+	}
+
+	unsigned int** data = new unsigned int*[map->mapHeight];
+	for (int y = 0; y < rows_above; y++){
+		data[y] = empty_row;
+	}
+	for (int y = 0; y < rows.size(); y++){
+		data[rows_above + y] = new unsigned int[map->mapWidth];
+		for (int x = 0; x < map->mapWidth; x++){
+			data[rows_above + y][x] = x < rows[y].size() && rows[y][x] == '#' ? 1 : 0;
+		}
+	}
+	map->layers.push_back(data);
+	app->map = map;
+
+	app->collision = new CollisionMesh();
+	app->collision->build(*map, app->collision_layer, app->tile_world_size);
+
+	app->jobs = new JobSystem(worker_count);
+}
+
+TestWorld::~TestWorld(){
+	delete app->jobs;
+	delete app->collision;
+
+	//Freed here rather than by ~FlareMap, which expects a row allocation per row
+	FlareMap* map = app->map;
+	unsigned int** data = map->layers[app->collision_layer];
+	for (int y = rows_above; y < map->mapHeight; y++){
+		delete[] data[y];
+	}
+	delete[] data;
+	delete[] empty_layer;
+	delete[] empty_row;
+
+	map->mapData = NULL;
+	map->mapHeight = 0;
+	delete map;
+}
+
+void TestWorld::spawn(GameObject& obj, float x, float y, float width, float height){
+	obj.set_app(app);
+	obj.size.x = width;
+	obj.size.y = height;
+	obj.set_pos(x, y);
+}
+
+void TestWorld::step(std::vector<GameObject>& objects){
+	app->jobs->parallel_for(objects.size(), 64, [&objects](int begin, int end){
+		for (int i = begin; i < end; i++){
+			objects[i].defer_events = true;
+			objects[i].update();
+		}
+	});
+
+	for (int i = 0; i < objects.size(); i++){
+		objects[i].flush_events();
+	}
+}
@@ -0,0 +1,38 @@
+#ifndef TESTWORLD_H
+#define TESTWORLD_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "../NYUCodebase/App.h"
+#include "../NYUCodebase/GameObject.h"
+
+//Hidden window with a current GL context, made once, for tests of code that
+//creates buffers or textures
+void make_test_gl_context();
+
+//A level built from rows of text ('#' is a solid tile, anything else is empty)
+//and an App wired to it the way GameLevel does, without a window or GL context.
+//Row 0 is the top of the map.
+class TestWorld{
+public:
+	std::shared_ptr<App> app;
+
+	//rows_above empty rows go on top of the level, all sharing one zero row,
+	//so a level can sit millions of tiles from the map origin without the memory
+	TestWorld(const std::vector<std::string>& rows, int worker_count = 0, int rows_above = 0);
+	~TestWorld();
+
+	//Puts obj at a relative position with the given size, ready to update()
+	void spawn(GameObject& obj, float x, float y, float width, float height);
+
+	//One sim tick of the entities, integration in parallel and events merged in index order
+	void step(std::vector<GameObject>& objects);
+
+private:
+	int rows_above = 0;
+	unsigned int* empty_row = NULL;
+	unsigned int** empty_layer = NULL; //mapData and the decoration layers
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "Test.h"
+#include "../NYUCodebase/Animation.h"
+
+//Frames off an unloaded sheet, only the count and timing matter here
+static Animation make_clip(int frames, float interval, bool loop){
+	Animation clip;
+	for (int i = 0; i < frames; i++){
+		clip.add_sprite(Sprite(0, i * 0.25f, 0, 0.25f, 1, 1));
+	}
+	clip.interval = interval;
+	clip.loop = loop;
+	return clip;
+}
+
+TEST(animation_frame_at_wraps_a_looping_clip){
+	Animation clip = make_clip(4, 0.1f, true);
+	CHECK(clip.frame_at(0) == 0);
+	CHECK(clip.frame_at(0.05f) == 0);
+	CHECK(clip.frame_at(0.15f) == 1);
+	CHECK(clip.frame_at(0.35f) == 3);
+	CHECK(clip.frame_at(0.45f) == 0);
+	CHECK(clip.frame_at(0.75f) == 3);
+	CHECK(clip.frame_at(123.45f) == 2);
+}
+
+//A long step lands on the frame for that time rather than the next one
+TEST(animation_large_elapsed_skips_frames){
+	Animation clip = make_clip(7, 0.05f, true);
+	Animator animator;
+	animator.play(&clip);
+
+	animator.advance(0.01f);
+	CHECK(animator.frame == 0);
+	animator.advance(0.16f); //0.17 s, frame 3: 1 and 2 skipped
+	CHECK(animator.frame == 3);
+	animator.advance(0.5f); //0.67 s, 13 frames in, past the end once
+	CHECK(animator.frame == 6);
+	CHECK_NEAR(animator.time, 0.67f, 1e-5);
+
+	//Replaying starts over
+	animator.play(&clip);
+	CHECK(animator.frame == 0 && animator.time == 0);
+}
+
+TEST(animation_non_looping_clip_ends_at_minus_one){
+	Animation clip = make_clip(4, 0.1f, false);
+	CHECK(clip.frame_at(0) == 0);
+	CHECK(clip.frame_at(0.35f) == 3);
+	CHECK(clip.frame_at(0.45f) == -1);
+	CHECK(clip.frame_at(100.0f) == -1);
+
+	Animator animator;
+	animator.play(&clip);
+	animator.advance(0.25f);
+	CHECK(animator.frame == 2);
+	animator.advance(0.25f);
+	CHECK(animator.frame == -1);
+	animator.advance(0.25f);
+	CHECK(animator.frame == -1);
+
+	//One frame clips hold it, looping or not, and so do empty ones
+	Animation still = make_clip(1, 0.1f, false);
+	CHECK(still.frame_at(0) == 0 && still.frame_at(5.0f) == 0);
+	Animation empty;
+	CHECK(empty.frame_at(5.0f) == 0);
+}
+
+//Shared clips, each animator keeps its own time; no clip stays on frame 0
+TEST(advance_animators_steps_every_animator){
+	Animation run = make_clip(13, 0.085f, true);
+	Animation hit = make_clip(4, 0.085f, false);
+
+	std::vector<Animator> storage(5);
+	storage[0].play(&run);
+	storage[1].play(&run);
+	storage[2].play(&hit);
+	storage[4].play(&hit);
+	storage[1].advance(0.3f);
+	storage[4].advance(0.3f);
+
+	std::vector<Animator*> animators;
+	for (int i = 0; i < storage.size(); i++){
+		animators.push_back(&storage[i]);
+	}
+	//Only the first four this pass
+	advance_animators(animators.data(), 4, 0.1f);
+
+	CHECK_NEAR(storage[0].time, 0.1f, 1e-6);
+	CHECK(storage[0].frame == 1);
+	CHECK_NEAR(storage[1].time, 0.4f, 1e-6);
+	CHECK(storage[1].frame == 4);
+	CHECK(storage[2].frame == 1);
+	CHECK(storage[3].clip == NULL && storage[3].frame == 0);
+	CHECK_NEAR(storage[4].time, 0.3f, 1e-6);
+	CHECK(storage[4].frame == 3);
+
+	for (int pass = 0; pass < 10; pass++){
+		advance_animators(animators.data(), animators.size(), 1 / 30.0f);
+	}
+	for (int i = 0; i < storage.size(); i++){
+		if (storage[i].clip != NULL){
+			CHECK(storage[i].frame == storage[i].clip->frame_at(storage[i].time));
+		}
+	}
+	CHECK(storage[2].frame == -1 && storage[4].frame == -1);
+	CHECK(storage[0].frame != storage[1].frame);
+}
@@ -0,0 +1,144 @@
+#include "Test.h"
+#include "../NYUCodebase/Camera.h"
+
+static const float tick = 1.0f / 60.0f;
+
+TEST(camera_holds_still_inside_the_dead_zone){
+	Camera camera;
+	camera.snap(0, 0);
+	camera.follow_rate = 0;
+
+	//Dead zone is 0.8 x 1.0 around the centre
+	float inside[] = { 0.3f, 0.4f, -0.39f, -0.49f, 0.4f, 0.5f };
+	for (int i = 0; i < 3; i++){
+		camera.follow(inside[i * 2], inside[i * 2 + 1], tick);
+		CHECK(camera.x == 0 && camera.y == 0);
+	}
+
+	//Past the edge, a snapping camera puts the target right on it
+	camera.follow(1.0f, -2.0f, tick);
+	CHECK_NEAR(camera.x, 0.6f, 1e-6);
+	CHECK_NEAR(camera.y, -1.5f, 1e-6);
+	CHECK_NEAR(camera.left(), 0.6f - camera.half_width, 1e-6);
+	CHECK_NEAR(camera.top(), -1.5f + camera.half_height, 1e-6);
+
+	//Offset looks ahead of the target
+	camera.offset_x = 1.0f;
+	camera.follow(1.0f, -2.0f, tick);
+	CHECK_NEAR(camera.x, 1.6f, 1e-6);
+}
+
+//The same second of following gets as far at 60 as at 240 ticks a second
+TEST(camera_easing_is_independent_of_tick_rate){
+	Camera slow;
+	Camera fast;
+	slow.snap(0, 0);
+	fast.snap(0, 0);
+
+	for (int i = 0; i < 60; i++){
+		slow.follow(5.0f, 0, tick);
+	}
+	for (int i = 0; i < 240; i++){
+		fast.follow(5.0f, 0, tick / 4);
+	}
+	//Goal is 4.6, the dead zone edge; 8 per second closes all but e^-8 of the gap
+	CHECK_NEAR(slow.x, fast.x, 1e-4);
+	CHECK_NEAR(slow.x, 4.6f * (1.0f - expf(-8.0f)), 1e-3);
+	CHECK(slow.x < 4.6f);
+
+	//One tick moves the expected fraction
+	Camera one;
+	one.snap(0, 0);
+	one.follow(5.0f, 0, tick);
+	CHECK_NEAR(one.x, 4.6f * (1.0f - expf(-8.0f * tick)), 1e-6);
+}
+
+TEST(camera_stays_inside_its_bounds){
+	Camera camera;
+	camera.follow_rate = 0;
+	camera.set_bounds(0, 20, -10, 0);
+	CHECK(camera.x == camera.half_width && camera.y == -camera.half_height);
+
+	camera.snap(-5, 5);
+	CHECK(camera.left() == 0 && camera.top() == 0);
+	camera.follow(30, -30, tick);
+	CHECK_NEAR(camera.right(), 20, 1e-5);
+	CHECK_NEAR(camera.bottom(), -10, 1e-5);
+	camera.follow(10, -5, tick);
+	CHECK_NEAR(camera.x, 10.4f, 1e-5);
+	CHECK_NEAR(camera.y, -5.5f, 1e-5);
+
+	//A level narrower than the view: centred on it whatever the target does
+	camera.set_bounds(0, 5, -10, 0);
+	CHECK(camera.x == 2.5f);
+	camera.follow(100, -5, tick);
+	CHECK(camera.x == 2.5f);
+	camera.snap(-100, -5);
+	CHECK(camera.x == 2.5f);
+
+	//And shorter than it
+	camera.set_bounds(0, 20, -3, 0);
+	camera.snap(10, -100);
+	CHECK(camera.y == -1.5f);
+}
+
+//Rebasing the origin moves the camera, what it's bounded by and where it's blending from
+TEST(camera_shift_matches_an_unshifted_camera){
+	Camera world;
+	Camera rebased;
+	world.set_bounds(0, 40, -20, 0);
+	rebased.set_bounds(0, 40, -20, 0);
+	world.snap(10, -10);
+	rebased.snap(10, -10);
+	world.follow(12, -9, tick);
+	rebased.follow(12, -9, tick);
+
+	float dx = -25.0f;
+	float dy = 8.0f;
+	rebased.shift(dx, dy);
+	CHECK_NEAR(rebased.x, world.x + dx, 1e-5);
+
+	//Blending between ticks picks up where it was, not from before the shift
+	Matrix world_view;
+	Matrix rebased_view;
+	world.apply(world_view, 0.5f);
+	rebased.apply(rebased_view, 0.5f);
+	CHECK_NEAR(rebased_view.m[3][0], world_view.m[3][0] - dx, 1e-5);
+	CHECK_NEAR(rebased_view.m[3][1], world_view.m[3][1] - dy, 1e-5);
+
+	//Chasing the same target into the bounds ends at the same place, shifted
+	for (int i = 0; i < 120; i++){
+		world.follow(45, -30, tick);
+		rebased.follow(45 + dx, -30 + dy, tick);
+		CHECK_NEAR(rebased.x, world.x + dx, 1e-4);
+		CHECK_NEAR(rebased.y, world.y + dy, 1e-4);
+	}
+	CHECK_NEAR(world.right(), 40, 1e-4);
+	CHECK_NEAR(rebased.right(), 40 + dx, 1e-4);
+	CHECK_NEAR(rebased.bottom(), -20 + dy, 1e-4);
+}
+
+TEST(camera_visible_pads_the_view_by_the_margin){
+	Camera camera;
+	camera.snap(0, 0);
+	camera.cull_margin = 0.5f;
+
+	//Edge of the view is 3.55 out, a 1 wide object reaches in from 0.5 further, plus the margin
+	CHECK(camera.visible(0, 0, 0.1f, 0.1f));
+	CHECK(camera.visible(4.5f, 0, 1.0f, 1.0f));
+	CHECK(!camera.visible(4.6f, 0, 1.0f, 1.0f));
+	CHECK(camera.visible(-4.5f, 0, 1.0f, 1.0f));
+	CHECK(camera.visible(0, 2.9f, 0.8f, 0.8f));
+	CHECK(!camera.visible(0, -3.0f, 0.8f, 0.8f));
+	CHECK(camera.visible(4.5f, 2.95f, 1.0f, 1.0f));
+	CHECK(!camera.visible(4.5f, 3.05f, 1.0f, 1.0f));
+
+	camera.cull_margin = 0;
+	CHECK(!camera.visible(4.5f, 0, 1.0f, 1.0f));
+	CHECK(camera.visible(4.0f, 0, 1.0f, 1.0f));
+
+	//Follows the camera
+	camera.snap(100, 0);
+	CHECK(!camera.visible(0, 0, 1.0f, 1.0f));
+	CHECK(camera.visible(100, 0, 1.0f, 1.0f));
+}
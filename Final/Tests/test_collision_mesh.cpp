@@ -0,0 +1,280 @@
+#include "Test.h"
+#include "TestWorld.h"
+#include "../NYUCodebase/CollisionMesh.h"
+#include "../NYUCodebase/GroundSpikeScript.h"
+#include <set>
+
+//Tile 0.18, so row 8's top is y = -1.44 and column 14's left edge is x = 2.52
+static std::vector<std::string> room_rows(){
+	std::vector<std::string> rows;
+	rows.push_back("#..................#");
+	rows.push_back("#..................#");
+	rows.push_back("#......####........#");
+	rows.push_back("#..................#");
+	rows.push_back("#..................#");
+	rows.push_back("#.............##...#");
+	rows.push_back("#.............##...#");
+	rows.push_back("#.............##...#");
+	rows.push_back("####################");
+	rows.push_back("####################");
+	return rows;
+}
+
+static std::vector<std::string> random_rows(int width, int height, int solid_percent, unsigned int seed){
+	srand(seed);
+	std::vector<std::string> rows(height, std::string(width, '.'));
+	for (int y = 0; y < height; y++){
+		for (int x = 0; x < width; x++){
+			if (rand() % 100 < solid_percent){
+				rows[y][x] = '#';
+			}
+		}
+	}
+	return rows;
+}
+
+static float random_unit(){
+	return (rand() % 10000) / 10000.0f;
+}
+
+//Every solid tile in exactly one rect, no empty tile in any, then random
+//boxes (some hanging off the map, some with a moved origin) find exactly
+//the rects of the solid tiles they cover
+static void check_against_tiles(const CollisionMesh& mesh, const std::vector<std::string>& rows, float tile, int queries){
+	int width = rows[0].size();
+	int height = rows.size();
+	std::vector<int> owner(width * height, -1);
+	int covered = 0;
+	for (int i = 0; i < mesh.rect_count(); i++){
+		const CollisionRect& r = mesh.rect(i);
+		for (int y = r.y; y < r.y + r.height; y++){
+			for (int x = r.x; x < r.x + r.width; x++){
+				CHECK(owner[y * width + x] == -1);
+				CHECK(rows[y][x] == '#');
+				owner[y * width + x] = i;
+				covered++;
+			}
+		}
+	}
+	CHECK(covered == mesh.solid_tiles());
+	for (int y = 0; y < height; y++){
+		for (int x = 0; x < width; x++){
+			CHECK(rows[y][x] != '#' || owner[y * width + x] >= 0);
+		}
+	}
+
+	std::vector<int> found;
+	for (int q = 0; q < queries; q++){
+		int origin_x = q % 2 == 0 ? 0 : rand() % width;
+		int origin_y = q % 2 == 0 ? 0 : rand() % height;
+
+		//Edges kept off tile boundaries
+		int left = rand() % (width + 13) - 8 - origin_x;
+		int top = rand() % (height + 9) - 5 - origin_y;
+		int span_x = rand() % 12;
+		int span_y = rand() % 12;
+		float min_x = (left + 0.1f + 0.8f * random_unit()) * tile;
+		float max_x = (left + span_x + 0.1f + 0.8f * random_unit()) * tile;
+		float max_y = -(top + 0.1f + 0.8f * random_unit()) * tile;
+		float min_y = -(top + span_y + 0.1f + 0.8f * random_unit()) * tile;
+		if (max_x < min_x || max_y < min_y){
+			continue;
+		}
+
+		std::set<int> expected;
+		for (int y = origin_y + top; y <= origin_y + top + span_y; y++){
+			for (int x = origin_x + left; x <= origin_x + left + span_x; x++){
+				if (y >= 0 && y < height && x >= 0 && x < width && rows[y][x] == '#'){
+					expected.insert(owner[y * width + x]);
+				}
+			}
+		}
+
+		mesh.query_box(min_x, min_y, max_x, max_y, found, origin_x, origin_y);
+		CHECK(std::set<int>(found.begin(), found.end()) == expected);
+		CHECK(found.size() == expected.size());
+	}
+}
+
+TEST(query_box_matches_tile_scan){
+	std::vector<std::string> rows = random_rows(97, 61, 35, 7);
+	TestWorld world(rows);
+	check_against_tiles(*world.app->collision, rows, world.app->tile_world_size, 2000);
+}
+
+//Doors opening and closing, blocks broken out of big merged rects
+TEST(set_tile_patches_rects_in_place){
+	std::vector<std::string> rows = random_rows(97, 61, 60, 8);
+	TestWorld world(rows);
+	CollisionMesh& mesh = *world.app->collision;
+	int rects_at_build = mesh.rect_count();
+
+	for (int round = 0; round < 30; round++){
+		for (int e = 0; e < 40; e++){
+			int x = rand() % rows[0].size();
+			int y = rand() % rows.size();
+			bool solid = rand() % 2 == 0;
+			rows[y][x] = solid ? '#' : '.';
+			mesh.set_tile(x, y, solid);
+		}
+		//Off the map does nothing
+		mesh.set_tile(-1, 0, true);
+		mesh.set_tile(0, rows.size(), true);
+		check_against_tiles(mesh, rows, world.app->tile_world_size, 200);
+	}
+
+	//Removed rects are reused, so edits don't just grow the list
+	CHECK(mesh.rect_count() < rects_at_build + 30 * 40);
+}
+
+TEST(falling_object_lands_on_the_floor){
+	TestWorld world(room_rows());
+	std::vector<GameObject> objects(1);
+	world.spawn(objects[0], 0.5f, -0.9f, 0.12f, 0.16f);
+	objects[0].jumping = true;
+
+	for (int tick = 0; tick < 60; tick++){
+		world.step(objects);
+		CHECK(objects[0].bottom() > -1.44f - 0.0001f);
+	}
+
+	CHECK(objects[0].collidedBottom);
+	CHECK(!objects[0].jumping);
+	CHECK(objects[0].velocity.y == 0);
+	CHECK_NEAR(objects[0].bottom(), -1.44f, 0.0001f);
+	//Resting on the floor is not a wall
+	CHECK(!objects[0].collidedLeft && !objects[0].collidedRight);
+}
+
+TEST(wall_stops_object_and_sends_event){
+	TestWorld world(room_rows());
+	std::vector<GameObject> objects(1);
+	world.spawn(objects[0], 2.0f, -1.44f + 0.08f, 0.12f, 0.16f);
+	objects[0].velocity.x = 2.0f;
+	objects[0].constant_x_velocity = true;
+	GroundSpikeScript script(&objects[0]);
+	objects[0].add_script("ground_spike", &script);
+
+	bool hit = false;
+	for (int tick = 0; tick < 30 && !hit; tick++){
+		world.step(objects);
+		CHECK(objects[0].right() < 2.52f + 0.0001f);
+		hit = objects[0].collidedRight;
+	}
+
+	CHECK(hit);
+	CHECK_NEAR(objects[0].right(), 2.52f, 0.0001f);
+	//right_collide turned it around
+	CHECK(objects[0].velocity.x < 0);
+	CHECK(objects[0].collidedBottom);
+
+	objects[0].scripts.clear();
+}
+
+TEST(ceiling_stops_a_jump){
+	TestWorld world(room_rows());
+	std::vector<GameObject> objects(1);
+	world.spawn(objects[0], 1.5f, -0.9f, 0.12f, 0.16f);
+	objects[0].velocity.y = 6.0f;
+
+	bool hit = false;
+	for (int tick = 0; tick < 30 && !hit; tick++){
+		world.step(objects);
+		//Row 2's bottom
+		CHECK(objects[0].collision_top() < -0.54f + 0.0001f);
+		hit = objects[0].collidedTop;
+	}
+
+	CHECK(hit);
+	CHECK(objects[0].velocity.y == 0);
+	CHECK_NEAR(objects[0].collision_top(), -0.54f, 0.0001f);
+}
+
+//Entity sized boxes over a big level: the merged rect grid vs reading every tile each box covers
+//Player sized boxes scattered over the whole map, merged rects against reading every tile
+static void bench_broad_phase(const char* name, const FlareMap& map, int layer, float tile){
+	CollisionMesh mesh;
+	mesh.build(map, layer, tile);
+	unsigned int** tiles = map.layers[layer];
+	int width = map.mapWidth;
+	int height = map.mapHeight;
+
+	int box_count = 200000;
+	std::vector<float> boxes(box_count * 4);
+	for (int i = 0; i < box_count; i++){
+		float x = random_unit() * (width - 2) * tile;
+		float y = -random_unit() * (height - 2) * tile;
+		boxes[i * 4] = x - 0.18f;
+		boxes[i * 4 + 1] = y - 0.22f;
+		boxes[i * 4 + 2] = x + 0.18f;
+		boxes[i * 4 + 3] = y + 0.17f;
+	}
+
+	std::vector<int> found;
+	int rect_hits = 0;
+	double start = bench_seconds();
+	for (int i = 0; i < box_count; i++){
+		mesh.query_box(boxes[i * 4], boxes[i * 4 + 1], boxes[i * 4 + 2], boxes[i * 4 + 3], found);
+		rect_hits += found.size();
+	}
+	double mesh_ms = (bench_seconds() - start) * 1000.0;
+
+	int tile_hits = 0;
+	int tile_reads = 0;
+	start = bench_seconds();
+	for (int i = 0; i < box_count; i++){
+		int first_x = std::max(0, (int)floorf(boxes[i * 4] / tile));
+		int last_x = std::min(width - 1, (int)floorf(boxes[i * 4 + 2] / tile));
+		int first_y = std::max(0, (int)floorf(-boxes[i * 4 + 3] / tile));
+		int last_y = std::min(height - 1, (int)floorf(-boxes[i * 4 + 1] / tile));
+		for (int y = first_y; y <= last_y; y++){
+			for (int x = first_x; x <= last_x; x++){
+				tile_hits += tiles[y][x] != 0;
+				tile_reads++;
+			}
+		}
+	}
+	double tile_ms = (bench_seconds() - start) * 1000.0;
+
+	std::cout << "  " << name << ", " << width << "x" << height << " tiles, " << mesh.solid_tiles() << " solid in " << mesh.rect_count() << " rects" << std::endl;
+	std::cout << "    per tile: " << tile_ms << " ms for " << box_count << " boxes, " << tile_reads << " tile reads, " << tile_hits << " solid" << std::endl;
+	std::cout << "    merged rects: " << mesh_ms << " ms, " << rect_hits << " rects to resolve against" << std::endl;
+}
+
+//Two tile thick platforms over a solid floor
+static std::vector<std::string> platform_rows(int width, int height, int platforms){
+	std::vector<std::string> rows(height, std::string(width, '.'));
+	for (int platform = 0; platform < platforms; platform++){
+		int x = rand() % (width - 16);
+		int y = rand() % (height - 4);
+		int length = 3 + rand() % 14;
+		for (int i = 0; i < length; i++){
+			rows[y][x + i] = '#';
+			rows[y + 1][x + i] = '#';
+		}
+	}
+	rows[height - 1] = std::string(width, '#');
+	rows[height - 2] = std::string(width, '#');
+	return rows;
+}
+
+BENCHMARK(collision_broad_phase){
+	srand(5);
+	TestWorld wide(platform_rows(1024, 128, 1500));
+	bench_broad_phase("platforms", *wide.app->map, wide.app->collision_layer, wide.app->tile_world_size);
+	TestWorld widest(platform_rows(4096, 128, 6000));
+	bench_broad_phase("platforms", *widest.app->map, widest.app->collision_layer, widest.app->tile_world_size);
+
+	//The shipped levels, run from the Tests directory
+	const char* levels[] = { "map_1", "map_2", "map_3" };
+	float tile = wide.app->tile_world_size;
+	for (int i = 0; i < 3; i++){
+		FlareMap map;
+		map.Load(std::string("../NYUCodebase/resources/") + levels[i] + ".txt");
+		if (map.layers.size() <= wide.app->collision_layer){
+			std::cout << "  missing " << levels[i] << ", run from the Tests directory" << std::endl;
+			continue;
+		}
+		bench_broad_phase(levels[i], map, wide.app->collision_layer, tile);
+	}
+}
@@ -0,0 +1,196 @@
+#include "Test.h"
+#include "TestWorld.h"
+#include "../NYUCodebase/FlowField.h"
+#include "../NYUCodebase/TileRaycast.h"
+#include <sstream>
+
+//About 1e6 world units of empty map above the level
+static const int far_rows = 5555556;
+
+static std::vector<std::string> far_level_rows(){
+	//Closed on top, so the near copy never needs the map edge clamp the far one doesn't have
+	std::vector<std::string> rows;
+	rows.push_back("####################");
+	rows.push_back("#....####..........#");
+	rows.push_back("#..................#");
+	rows.push_back("#..........###.....#");
+	rows.push_back("#.............#....#");
+	rows.push_back("#..##.........#....#");
+	rows.push_back("#.............#....#");
+	rows.push_back("####################");
+	rows.push_back("####################");
+	return rows;
+}
+
+//The same level at the top of the map and far_rows down it, origin on the level's top row
+TEST(tile_lookups_match_near_and_far_from_the_map_origin){
+	std::vector<std::string> rows = far_level_rows();
+	TestWorld near_world(rows);
+	TestWorld far_world(rows, 0, far_rows);
+	far_world.app->origin_tile_y = far_rows;
+
+	App& near_app = *near_world.app;
+	App& far_app = *far_world.app;
+	float half = 0.5f * near_app.tile_world_size;
+	for (int row = 0; row < rows.size(); row++){
+		CHECK(far_app.tile_top(far_rows + row) == near_app.tile_top(row));
+		CHECK(far_app.tile_y(near_app.tile_top(row) - half) == far_rows + row);
+		CHECK(near_app.tile_y(near_app.tile_top(row) - half) == row);
+	}
+	for (int column = 0; column < rows[0].size(); column++){
+		CHECK(far_app.tile_left(column) == near_app.tile_left(column));
+		CHECK(far_app.tile_x(near_app.tile_left(column) + half) == column);
+	}
+
+	//Every box sees the same rects, offset by the rows above
+	std::vector<int> near_found;
+	std::vector<int> far_found;
+	srand(3);
+	for (int q = 0; q < 500; q++){
+		float x = (rand() % 1000) / 1000.0f * 3.6f;
+		float y = -(rand() % 1000) / 1000.0f * 1.6f;
+		near_app.collision->query_box(x - 0.2f, y - 0.2f, x + 0.2f, y + 0.2f, near_found);
+		far_app.collision->query_box(x - 0.2f, y - 0.2f, x + 0.2f, y + 0.2f, far_found, far_app.origin_tile_x, far_app.origin_tile_y);
+		CHECK(near_found.size() == far_found.size());
+		for (int i = 0; i < near_found.size() && i < far_found.size(); i++){
+			const CollisionRect& a = near_app.collision->rect(near_found[i]);
+			const CollisionRect& b = far_app.collision->rect(far_found[i]);
+			CHECK(a.x == b.x && a.y + far_rows == b.y && a.width == b.width && a.height == b.height);
+		}
+	}
+}
+
+static std::string simulate(TestWorld& world){
+	std::vector<GameObject> objects(300);
+	srand(77);
+	for (int i = 0; i < objects.size(); i++){
+		world.spawn(objects[i], 0.3f + (rand() % 1000) / 1000.0f * 2.9f, -0.5f - (rand() % 1000) / 1000.0f * 0.5f, 0.12f, 0.16f);
+		objects[i].velocity.x = ((rand() % 1000) / 500.0f - 1.0f) * 3.0f;
+		objects[i].velocity.y = (rand() % 1000) / 1000.0f * 4.0f;
+		objects[i].constant_x_velocity = true;
+	}
+
+	std::ostringstream result;
+	for (int tick = 0; tick < 240; tick++){
+		world.step(objects);
+		if (tick % 60 == 59){
+			for (int i = 0; i < objects.size(); i++){
+				result << objects[i].x() << " " << objects[i].y() << " " << objects[i].collidedBottom << objects[i].collidedTop
+					<< objects[i].collidedLeft << objects[i].collidedRight << "\n";
+			}
+		}
+	}
+	return result.str();
+}
+
+//Landing, walls and ceilings come out bit for bit the same a million units down the map
+TEST(collision_matches_near_and_far_from_the_map_origin){
+	std::vector<std::string> rows = far_level_rows();
+	TestWorld near_world(rows);
+	TestWorld far_world(rows, 0, far_rows);
+	far_world.app->origin_tile_y = far_rows;
+
+	std::string near_result = simulate(near_world);
+	std::string far_result = simulate(far_world);
+	CHECK(near_result == far_result);
+
+	//Something actually collided
+	CHECK(near_result.find(" 1000\n") != std::string::npos);
+}
+
+//Rays from all over the level, some starting a hair inside a tile edge where
+//a map space float that far down could no longer tell the tiles apart
+TEST(raycasts_match_near_and_far_from_the_map_origin){
+	std::vector<std::string> rows = far_level_rows();
+	TestWorld near_world(rows);
+	TestWorld far_world(rows, 0, far_rows);
+	far_world.app->origin_tile_y = far_rows;
+	App& near_app = *near_world.app;
+	App& far_app = *far_world.app;
+	const FlareMap& near_map = *near_app.map;
+	const FlareMap& far_map = *far_app.map;
+	int layer = near_app.collision_layer;
+	float tile = near_app.tile_world_size;
+
+	srand(11);
+	std::vector<TileRay> rays;
+	for (int i = 0; i < 2000; i++){
+		int column = 1 + rand() % (rows[0].size() - 2);
+		int row = 1 + rand() % (rows.size() - 3);
+		float edge = i % 2 == 0 ? 0.001f : (rand() % 1000) / 1000.0f * tile;
+		float angle = (rand() % 6283) / 1000.0f;
+		TileRay ray = { near_app.tile_left(column) + edge, near_app.tile_top(row) - edge, cosf(angle), sinf(angle), 4.0f };
+		rays.push_back(ray);
+	}
+
+	std::vector<TileHit> near_hits(rays.size());
+	std::vector<TileHit> far_hits(rays.size());
+	TileRaycast::cast(near_map, layer, tile, rays.data(), rays.size(), near_hits.data());
+	TileRaycast::cast(far_map, layer, tile, rays.data(), rays.size(), far_hits.data(), NULL, 0, far_rows);
+
+	int hits = 0;
+	int mismatches = 0;
+	for (int i = 0; i < rays.size(); i++){
+		const TileHit& a = near_hits[i];
+		const TileHit& b = far_hits[i];
+		hits += a.hit;
+		if (a.hit != b.hit || a.tile_x != b.tile_x || (a.hit && a.tile_y + far_rows != b.tile_y) || a.distance != b.distance ||
+			a.x != b.x || a.y != b.y || a.normal_x != b.normal_x || a.normal_y != b.normal_y){
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+	CHECK(hits > 1000);
+
+	CHECK(TileRaycast::line_of_sight(far_map, layer, tile, near_app.tile_left(2), near_app.tile_top(3), near_app.tile_left(9), near_app.tile_top(3), 0, far_rows));
+	CHECK(!TileRaycast::line_of_sight(far_map, layer, tile, near_app.tile_left(2), near_app.tile_top(4), near_app.tile_left(17), near_app.tile_top(4), 0, far_rows));
+}
+
+//Same field, same answers, down to positions a hair inside each tile
+TEST(flow_field_lookups_match_near_and_far_from_the_map_origin){
+	std::vector<std::string> rows = far_level_rows();
+	TestWorld near_world(rows);
+	TestWorld far_world(rows, 0, far_rows);
+	far_world.app->origin_tile_y = far_rows;
+	App& near_app = *near_world.app;
+	int layer = near_app.collision_layer;
+	float tile = near_app.tile_world_size;
+
+	FlowField near_field;
+	near_field.build(*near_app.map, layer, tile);
+	FlowField far_field;
+	far_field.build(*far_world.app->map, layer, tile);
+
+	//Player on the floor left of the wall, then in the corner right of it
+	float targets[] = { near_app.tile_left(5) + 0.05f, near_app.tile_top(6) - 0.05f, near_app.tile_left(16) + 0.05f, near_app.tile_top(6) - 0.05f };
+	int least_reachable[] = { 50, 10 };
+	for (int t = 0; t < 2; t++){
+		near_field.set_target(targets[t * 2], targets[t * 2 + 1]);
+		near_field.update();
+		far_field.set_target(targets[t * 2], targets[t * 2 + 1], 0, far_rows);
+		far_field.update();
+
+		int reachable = 0;
+		int mismatches = 0;
+		float edges[] = { 0.001f, 0.09f, 0.179f };
+		for (int row = 1; row < rows.size() - 2; row++){
+			for (int column = 1; column < rows[0].size() - 1; column++){
+				for (int e = 0; e < 3; e++){
+					float x = near_app.tile_left(column) + edges[e];
+					float y = near_app.tile_top(row) - edges[2 - e];
+					int near_distance = near_field.distance(x, y);
+					int far_distance = far_field.distance(x, y, 0, far_rows);
+					int near_step_x = 0, near_step_y = 0, far_step_x = 0, far_step_y = 0;
+					bool near_direction = near_field.direction(x, y, &near_step_x, &near_step_y);
+					bool far_direction = far_field.direction(x, y, &far_step_x, &far_step_y, 0, far_rows);
+					if (near_distance != far_distance || near_direction != far_direction || near_step_x != far_step_x || near_step_y != far_step_y){
+						mismatches++;
+					}
+					reachable += near_distance > 0;
+				}
+			}
+		}
+		CHECK(mismatches == 0);
+		CHECK(reachable > least_reachable[t]);
+	}
+}
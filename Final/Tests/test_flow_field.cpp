@@ -0,0 +1,241 @@
+#include "Test.h"
+#include "TestWorld.h"
+#include "../NYUCodebase/FlowField.h"
+
+//Floor plus scattered one-row platforms, so there are ledges, steps and gaps to route around
+static std::vector<std::string> platform_rows(int width, int height, int platforms, unsigned int seed){
+	srand(seed);
+	std::vector<std::string> rows(height, std::string(width, '.'));
+	for (int i = 0; i < platforms; i++){
+		int x = rand() % (width - 12);
+		int y = 2 + rand() % (height - 6);
+		int length = 2 + rand() % 10;
+		for (int j = 0; j < length; j++){
+			rows[y][x + j] = '#';
+		}
+	}
+	rows[height - 1] = std::string(width, '#');
+	return rows;
+}
+
+static float cell_x(int x, float tile){
+	return (x + 0.5f) * tile;
+}
+
+static float cell_y(int y, float tile){
+	return -(y + 0.5f) * tile;
+}
+
+//Same distances as a field searched from scratch, and every step goes one closer
+static void check_matches_full_search(const FlowField& field, const FlareMap& map, int layer, float tile, float target_x, float target_y){
+	FlowField fresh;
+	fresh.build(map, layer, tile);
+	fresh.set_target(target_x, target_y);
+	fresh.update();
+
+	int mismatches = 0;
+	int bad_steps = 0;
+	for (int y = 0; y < map.mapHeight; y++){
+		for (int x = 0; x < map.mapWidth; x++){
+			int distance = field.distance(cell_x(x, tile), cell_y(y, tile));
+			if (distance != fresh.distance(cell_x(x, tile), cell_y(y, tile))){
+				mismatches++;
+				continue;
+			}
+
+			int step_x, step_y;
+			if (distance > 0 && field.direction(cell_x(x, tile), cell_y(y, tile), &step_x, &step_y)){
+				//direction() may have snapped down into the standing cell below
+				int from_y = map.layers[layer][y][x] == 0 && y + 1 < map.mapHeight && map.layers[layer][y + 1][x] == 0 ? y + 1 : y;
+				int next = field.distance(cell_x(x + step_x, tile), cell_y(from_y - step_y, tile));
+				if (next != distance - 1){
+					bad_steps++;
+				}
+			}
+		}
+	}
+	CHECK(mismatches == 0);
+	CHECK(bad_steps == 0);
+}
+
+TEST(flow_field_repair_matches_full_search){
+	for (int seed = 1; seed <= 6; seed++){
+		TestWorld world(platform_rows(80, 30, 60, seed));
+		FlareMap& map = *world.app->map;
+		int layer = world.app->collision_layer;
+		float tile = world.app->tile_world_size;
+
+		FlowField field;
+		field.build(map, layer, tile);
+		float target_x = cell_x(40, tile);
+		float target_y = cell_y(28, tile);
+		field.set_target(target_x, target_y);
+		field.update();
+
+		for (int round = 0; round < 40; round++){
+			//A few edits per tick, like doors and breakable blocks; never the target's floor
+			int edits = 1 + rand() % 3;
+			for (int e = 0; e < edits; e++){
+				int x = rand() % map.mapWidth;
+				int y = 1 + rand() % (map.mapHeight - 2);
+				if (x == 40 && y >= 27){
+					continue;
+				}
+				map.SetTile(layer, x, y, map.layers[layer][y][x] == 0 ? 1 : 0);
+				field.invalidate_tile(x, y);
+			}
+			field.repair(map);
+
+			check_matches_full_search(field, map, layer, tile, target_x, target_y);
+		}
+		CHECK(field.searches == 1);
+	}
+}
+
+TEST(flow_field_repair_waits_for_a_new_target_when_its_floor_goes){
+	TestWorld world(platform_rows(40, 12, 10, 3));
+	FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	FlowField field;
+	field.build(map, layer, tile);
+	field.set_target(cell_x(20, tile), cell_y(10, tile));
+	field.update();
+	CHECK(field.distance(cell_x(20, tile), cell_y(10, tile)) == 0);
+
+	map.SetTile(layer, 20, 11, 0);
+	field.invalidate_tile(20, 11);
+	field.repair(map);
+	CHECK(field.distance(cell_x(20, tile), cell_y(10, tile)) == -1);
+
+	map.SetTile(layer, 20, 11, 1);
+	field.invalidate_tile(20, 11);
+	field.repair(map);
+	field.set_target(cell_x(20, tile), cell_y(10, tile));
+	field.update();
+	check_matches_full_search(field, map, layer, tile, cell_x(20, tile), cell_y(10, tile));
+}
+
+//Rolling ground a walker can follow end to end, ground[x] is the first solid row of column x
+static std::vector<std::string> rolling_rows(int width, int height, std::vector<int>& ground){
+	std::vector<std::string> rows(height, std::string(width, '.'));
+	ground.resize(width);
+	int surface = height / 2;
+	for (int x = 0; x < width; x++){
+		surface = std::max(8, std::min(height - 2, surface + rand() % 3 - 1));
+		ground[x] = surface;
+		for (int y = surface; y < height; y++){
+			rows[y][x] = '#';
+		}
+	}
+	return rows;
+}
+
+//A block dropped on the walkway each edit: repairing around it vs building and searching the whole map
+BENCHMARK(flow_field_edit_cost){
+	int width = 4096;
+	int height = 128;
+	std::vector<int> ground;
+	srand(11);
+	std::vector<std::string> rows = rolling_rows(width, height, ground);
+
+	TestWorld world(rows);
+	FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	FlowField field;
+	field.build(map, layer, tile);
+	field.set_target(cell_x(width / 2, tile), cell_y(ground[width / 2] - 1, tile));
+	field.update();
+
+	int edits = 200;
+	std::vector<int> edit_x(edits);
+	for (int i = 0; i < edits; i++){
+		edit_x[i] = rand() % width;
+	}
+
+	double start = bench_seconds();
+	for (int i = 0; i < edits; i++){
+		map.SetTile(layer, edit_x[i], ground[edit_x[i]] - 1, 1);
+		field.build(map, layer, tile);
+		field.update();
+		map.SetTile(layer, edit_x[i], ground[edit_x[i]] - 1, 0);
+	}
+	double rebuild_ms = (bench_seconds() - start) * 1000.0 / edits;
+	int rebuild_cells = field.last_search_cells;
+	field.build(map, layer, tile);
+	field.update();
+
+	long long repair_cells = 0;
+	start = bench_seconds();
+	for (int i = 0; i < edits; i++){
+		for (int place = 1; place >= 0; place--){
+			map.SetTile(layer, edit_x[i], ground[edit_x[i]] - 1, place);
+			field.invalidate_tile(edit_x[i], ground[edit_x[i]] - 1);
+			repair_cells += field.repair(map);
+		}
+	}
+	double repair_ms = (bench_seconds() - start) * 1000.0 / (edits * 2);
+
+	std::cout << "  " << width << "x" << height << " map, " << edits << " blocks placed and removed" << std::endl;
+	std::cout << "  before, build + full search: " << rebuild_ms << " ms per edit, " << rebuild_cells << " cells searched" << std::endl;
+	std::cout << "  repair: " << repair_ms << " ms per edit, " << repair_cells / (edits * 2) << " cells on average" << std::endl;
+}
+
+//10k walkers reading one shared field while the player runs across the map,
+//one tile every 6 ticks, against each walker running its own search
+BENCHMARK(flow_field_agents){
+	int width = 1024;
+	int height = 256;
+	std::vector<int> ground;
+	srand(12);
+	std::vector<std::string> rows = rolling_rows(width, height, ground);
+
+	TestWorld world(rows);
+	FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	double start = bench_seconds();
+	FlowField field;
+	field.build(map, layer, tile);
+	double build_ms = (bench_seconds() - start) * 1000.0;
+
+	//Standing on the ground, centred a little above the cell like a sprite
+	int agent_count = 10000;
+	std::vector<float> agents(agent_count * 2);
+	for (int i = 0; i < agent_count; i++){
+		int x = rand() % width;
+		agents[i * 2] = cell_x(x, tile);
+		agents[i * 2 + 1] = cell_y(ground[x] - 1, tile) + 0.3f * tile;
+	}
+
+	int ticks = 600;
+	double search_ms = 0;
+	double lookup_ms = 0;
+	long long moving = 0;
+	for (int tick = 0; tick < ticks; tick++){
+		int player_x = width / 4 + tick / 6;
+		start = bench_seconds();
+		field.set_target(cell_x(player_x, tile), cell_y(ground[player_x] - 1, tile));
+		field.update();
+		search_ms += (bench_seconds() - start) * 1000.0;
+
+		start = bench_seconds();
+		for (int i = 0; i < agent_count; i++){
+			int step_x, step_y;
+			if (field.direction(agents[i * 2], agents[i * 2 + 1], &step_x, &step_y)){
+				moving += step_x != 0;
+			}
+		}
+		lookup_ms += (bench_seconds() - start) * 1000.0;
+	}
+
+	std::cout << "  " << width << "x" << height << " map, " << agent_count << " agents, " << ticks << " ticks" << std::endl;
+	std::cout << "  build: " << build_ms << " ms, " << field.searches << " searches: " << search_ms / field.searches << " ms each, "
+		<< field.last_search_cells << " cells" << std::endl;
+	std::cout << "  lookups: " << lookup_ms / ticks << " ms per tick, " << moving / ticks << " agents stepping" << std::endl;
+	std::cout << "  before, a search per agent: about " << search_ms / field.searches * agent_count << " ms per tick" << std::endl;
+}
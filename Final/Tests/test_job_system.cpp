@@ -0,0 +1,212 @@
+#include "Test.h"
+#include "TestWorld.h"
+#include "../NYUCodebase/JobSystem.h"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <map>
+#include <sstream>
+
+TEST(parallel_for_covers_every_index_once){
+	int worker_counts[] = { 0, 1, 3, 7 };
+	for (int w = 0; w < 4; w++){
+		JobSystem jobs(worker_counts[w]);
+		int counts[] = { 0, 1, 63, 64, 65, 1000 };
+		for (int c = 0; c < 6; c++){
+			std::vector<std::atomic<int>> hits(counts[c]);
+			for (int x = 0; x < counts[c]; x++){
+				hits[x] = 0;
+			}
+
+			jobs.parallel_for(counts[c], 16, [&hits](int begin, int end){
+				for (int x = begin; x < end; x++){
+					hits[x]++;
+				}
+			});
+
+			for (int x = 0; x < counts[c]; x++){
+				CHECK(hits[x] == 1);
+			}
+		}
+	}
+}
+
+//Chunks dealt to worker 1 are slow, the other threads run dry and take them
+TEST(idle_threads_steal_work){
+	JobSystem jobs(3);
+	int queue_count = jobs.thread_count();
+
+	std::mutex lock;
+	std::map<int, std::set<std::thread::id>> slow_runners;
+
+	int chunks = 64;
+	jobs.parallel_for(chunks, 1, [&](int begin, int end){
+		//Called from the main thread, so chunk x was dealt to queue x % queue_count
+		if (begin % queue_count == 1){
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		}
+
+		std::lock_guard<std::mutex> guard(lock);
+		slow_runners[begin % queue_count].insert(std::this_thread::get_id());
+	});
+
+	CHECK(jobs.steal_count() > 0);
+	//Worker 1 can't have run all of its own queue alone
+	CHECK(slow_runners[1].size() > 1);
+}
+
+//A job that calls parallel_for itself has to wait without starving the pool
+TEST(nested_parallel_for_waits_for_inner_jobs){
+	int worker_counts[] = { 0, 1, 3 };
+	for (int w = 0; w < 3; w++){
+		JobSystem jobs(worker_counts[w]);
+
+		int outer = 16;
+		int inner = 500;
+		std::vector<std::atomic<int>> sums(outer);
+		for (int x = 0; x < outer; x++){
+			sums[x] = 0;
+		}
+
+		jobs.parallel_for(outer, 1, [&](int begin, int end){
+			for (int o = begin; o < end; o++){
+				jobs.parallel_for(inner, 32, [&, o](int inner_begin, int inner_end){
+					//Three levels deep
+					jobs.parallel_for(inner_end - inner_begin, 8, [&, o](int b, int e){
+						sums[o] += e - b;
+					});
+				});
+
+				//Every inner chunk finished before the inner call returned
+				CHECK(sums[o] == inner);
+			}
+		});
+
+		for (int x = 0; x < outer; x++){
+			CHECK(sums[x] == inner);
+		}
+	}
+}
+
+//Logs every event an entity gets, in the order they are delivered
+class EventLogScript : public Script{
+public:
+	std::vector<std::string>* log;
+	int index;
+
+	void on_event(const std::string& event_name){
+		std::ostringstream line;
+		line << index << " " << event_name;
+		log->push_back(line.str());
+	}
+};
+
+static std::vector<std::string> level_rows(){
+	std::vector<std::string> rows;
+	for (int x = 0; x < 8; x++){
+		rows.push_back("##............................................................##");
+	}
+	rows.push_back("##........####..................................####..........##");
+	rows.push_back("##..............................................................##");
+	rows.push_back("##..................######..............######................##");
+	rows.push_back("##..............................................................##");
+	rows.push_back("##.######..............................................######...##");
+	rows.push_back("##..............................................................##");
+	rows.push_back("##################################################################");
+	rows.push_back("##################################################################");
+	return rows;
+}
+
+struct SimResult{
+	std::vector<float> positions;
+	std::vector<std::string> events;
+};
+
+static SimResult simulate(int worker_count){
+	TestWorld world(level_rows(), worker_count);
+	SimResult result;
+
+	std::vector<GameObject> objects(2000);
+	std::vector<EventLogScript> scripts(objects.size());
+	srand(1234);
+	for (int i = 0; i < objects.size(); i++){
+		float x = 0.5f + (rand() % 1000) / 1000.0f * 10.3f;
+		float y = -1.5f - (rand() % 1000) / 1000.0f * 0.8f;
+		world.spawn(objects[i], x, y, 0.12f, 0.16f);
+		objects[i].velocity.x = ((rand() % 1000) / 500.0f - 1.0f) * 3.0f;
+		objects[i].velocity.y = (rand() % 1000) / 1000.0f * 3.0f;
+		objects[i].constant_x_velocity = true;
+
+		scripts[i].log = &result.events;
+		scripts[i].index = i;
+		objects[i].scripts["log"] = &scripts[i];
+	}
+
+	for (int tick = 0; tick < 180; tick++){
+		world.step(objects);
+	}
+
+	for (int i = 0; i < objects.size(); i++){
+		result.positions.push_back(objects[i].x());
+		result.positions.push_back(objects[i].y());
+	}
+
+	for (int i = 0; i < objects.size(); i++){
+		objects[i].scripts.clear();
+	}
+	return result;
+}
+
+//Same level, same entities, 0 to 7 workers: bit identical positions and event order
+TEST(simulation_is_deterministic_across_thread_counts){
+	SimResult serial = simulate(0);
+	CHECK(!serial.events.empty());
+
+	int worker_counts[] = { 1, 3, 7 };
+	for (int w = 0; w < 3; w++){
+		SimResult threaded = simulate(worker_counts[w]);
+		CHECK(threaded.positions == serial.positions);
+		CHECK(threaded.events == serial.events);
+	}
+}
+
+//Entity update frame cost, serial loop (before the job system) against the pool
+BENCHMARK(entity_update_frame_time){
+	std::vector<std::string> rows = level_rows();
+	int entity_count = 20000;
+	int frames = 60;
+
+	int worker_counts[] = { -1, 0, 1, 3, 7 };
+	for (int w = 0; w < 5; w++){
+		TestWorld world(rows, worker_counts[w] < 0 ? 0 : worker_counts[w]);
+
+		std::vector<GameObject> objects(entity_count);
+		srand(99);
+		for (int i = 0; i < objects.size(); i++){
+			world.spawn(objects[i], 0.5f + (rand() % 1000) / 1000.0f * 10.3f, -1.5f - (rand() % 1000) / 1000.0f * 0.8f, 0.12f, 0.16f);
+			objects[i].velocity.x = ((rand() % 1000) / 500.0f - 1.0f) * 3.0f;
+			objects[i].constant_x_velocity = true;
+		}
+
+		double start = bench_seconds();
+		for (int frame = 0; frame < frames; frame++){
+			if (worker_counts[w] < 0){
+				for (int i = 0; i < objects.size(); i++){
+					objects[i].update();
+				}
+			}
+			else{
+				world.step(objects);
+			}
+		}
+		double ms = (bench_seconds() - start) * 1000.0 / frames;
+
+		if (worker_counts[w] < 0){
+			std::cout << "  before, serial loop: " << ms << " ms/frame" << std::endl;
+		}
+		else{
+			std::cout << "  job system, " << worker_counts[w] << " workers: " << ms << " ms/frame" << std::endl;
+		}
+	}
+	std::cout << "  " << entity_count << " entities, " << std::thread::hardware_concurrency() << " cores" << std::endl;
+}
@@ -0,0 +1,48 @@
+#include "Test.h"
+#include <cstring>
+
+std::vector<TestCase>& test_registry(){
+	static std::vector<TestCase> registry;
+	return registry;
+}
+
+int& test_failures(){
+	static int failures = 0;
+	return failures;
+}
+
+//Tests [--bench] [name filter]
+int main(int argc, char *argv[]){
+	bool run_benchmarks = false;
+	const char* filter = NULL;
+	for (int x = 1; x < argc; x++){
+		if (strcmp(argv[x], "--bench") == 0){
+			run_benchmarks = true;
+		}
+		else{
+			filter = argv[x];
+		}
+	}
+
+	int ran = 0;
+	std::vector<TestCase>& tests = test_registry();
+	for (int x = 0; x < tests.size(); x++){
+		if (tests[x].benchmark != run_benchmarks){
+			continue;
+		}
+		if (filter != NULL && strstr(tests[x].name, filter) == NULL){
+			continue;
+		}
+
+		std::cout << tests[x].name << std::endl;
+		int failures_before = test_failures();
+		tests[x].fn();
+		if (test_failures() == failures_before){
+			std::cout << "  ok" << std::endl;
+		}
+		ran++;
+	}
+
+	std::cout << ran << " run, " << test_failures() << " failed checks" << std::endl;
+	return test_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+#include "Test.h"
+#include "../NYUCodebase/Matrix.h"
+#include "../NYUCodebase/Vector3.h"
+#include <cstdlib>
+#include <vector>
+
+//The scalar Matrix code from before the SSE paths, kept as the reference
+
+static void ScalarMultiply(const float a[4][4], const float b[4][4], float out[4][4]) {
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			out[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j] + a[i][3] * b[3][j];
+		}
+	}
+}
+
+static void ScalarInverse(const float m[4][4], float out[4][4]) {
+	float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2], m03 = m[0][3];
+	float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2], m13 = m[1][3];
+	float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2], m23 = m[2][3];
+	float m30 = m[3][0], m31 = m[3][1], m32 = m[3][2], m33 = m[3][3];
+
+	float v0 = m20 * m31 - m21 * m30;
+	float v1 = m20 * m32 - m22 * m30;
+	float v2 = m20 * m33 - m23 * m30;
+	float v3 = m21 * m32 - m22 * m31;
+	float v4 = m21 * m33 - m23 * m31;
+	float v5 = m22 * m33 - m23 * m32;
+
+	float t00 = + (v5 * m11 - v4 * m12 + v3 * m13);
+	float t10 = - (v5 * m10 - v2 * m12 + v1 * m13);
+	float t20 = + (v4 * m10 - v2 * m11 + v0 * m13);
+	float t30 = - (v3 * m10 - v1 * m11 + v0 * m12);
+
+	float invDet = 1.0f / (t00 * m00 + t10 * m01 + t20 * m02 + t30 * m03);
+
+	float d00 = t00 * invDet;
+	float d10 = t10 * invDet;
+	float d20 = t20 * invDet;
+	float d30 = t30 * invDet;
+
+	float d01 = - (v5 * m01 - v4 * m02 + v3 * m03) * invDet;
+	float d11 = + (v5 * m00 - v2 * m02 + v1 * m03) * invDet;
+	float d21 = - (v4 * m00 - v2 * m01 + v0 * m03) * invDet;
+	float d31 = + (v3 * m00 - v1 * m01 + v0 * m02) * invDet;
+
+	v0 = m10 * m31 - m11 * m30;
+	v1 = m10 * m32 - m12 * m30;
+	v2 = m10 * m33 - m13 * m30;
+	v3 = m11 * m32 - m12 * m31;
+	v4 = m11 * m33 - m13 * m31;
+	v5 = m12 * m33 - m13 * m32;
+
+	float d02 = + (v5 * m01 - v4 * m02 + v3 * m03) * invDet;
+	float d12 = - (v5 * m00 - v2 * m02 + v1 * m03) * invDet;
+	float d22 = + (v4 * m00 - v2 * m01 + v0 * m03) * invDet;
+	float d32 = - (v3 * m00 - v1 * m01 + v0 * m02) * invDet;
+
+	v0 = m21 * m10 - m20 * m11;
+	v1 = m22 * m10 - m20 * m12;
+	v2 = m23 * m10 - m20 * m13;
+	v3 = m22 * m11 - m21 * m12;
+	v4 = m23 * m11 - m21 * m13;
+	v5 = m23 * m12 - m22 * m13;
+
+	float d03 = - (v5 * m01 - v4 * m02 + v3 * m03) * invDet;
+	float d13 = + (v5 * m00 - v2 * m02 + v1 * m03) * invDet;
+	float d23 = - (v4 * m00 - v2 * m01 + v0 * m03) * invDet;
+	float d33 = + (v3 * m00 - v1 * m01 + v0 * m02) * invDet;
+
+	out[0][0] = d00;
+	out[0][1] = d01;
+	out[0][2] = d02;
+	out[0][3] = d03;
+	out[1][0] = d10;
+	out[1][1] = d11;
+	out[1][2] = d12;
+	out[1][3] = d13;
+	out[2][0] = d20;
+	out[2][1] = d21;
+	out[2][2] = d22;
+	out[2][3] = d23;
+	out[3][0] = d30;
+	out[3][1] = d31;
+	out[3][2] = d32;
+	out[3][3] = d33;
+}
+
+static float random_float(float low, float high) {
+	return low + (rand() % 100000) / 100000.0f * (high - low);
+}
+
+static Matrix random_matrix() {
+	Matrix m;
+	for (int i = 0; i < 16; i++) {
+		m.ml[i] = random_float(-2.0f, 2.0f);
+	}
+	return m;
+}
+
+//What the game builds: scale, roll and translate
+static Matrix random_affine() {
+	Matrix m;
+	m.Scale(random_float(0.1f, 4.0f), random_float(0.1f, 4.0f), 1.0f);
+	m.Rotate(random_float(-3.14159f, 3.14159f));
+	m.Translate(random_float(-50.0f, 50.0f), random_float(-50.0f, 50.0f), 0.0f);
+	return m;
+}
+
+//Largest difference relative to the size of the reference values
+static double relative_error(const float* actual, const float* expected, int count) {
+	double largest = 1.0;
+	double error = 0.0;
+	for (int i = 0; i < count; i++) {
+		largest = fmax(largest, fabs(expected[i]));
+		error = fmax(error, fabs(actual[i] - expected[i]));
+	}
+	return error / largest;
+}
+
+TEST(matrix_multiply_matches_scalar) {
+	srand(29);
+	for (int n = 0; n < 100000; n++) {
+		Matrix a = random_matrix();
+		Matrix b = random_matrix();
+
+		float expected[4][4];
+		ScalarMultiply(a.m, b.m, expected);
+		Matrix actual = a * b;
+		CHECK(relative_error(actual.ml, &expected[0][0], 16) < 1e-6);
+	}
+}
+
+//Different elimination order, so only close. Both must still undo the matrix.
+TEST(matrix_inverse_matches_scalar) {
+	srand(30);
+	for (int n = 0; n < 100000; n++) {
+		Matrix m = (n % 2 == 0) ? random_affine() : random_matrix();
+
+		float expected[4][4];
+		ScalarInverse(m.m, expected);
+		Matrix actual = m.Inverse();
+
+		//Random general matrices can be close to singular, skip the badly conditioned ones
+		double largest_inverse = 0.0;
+		for (int i = 0; i < 16; i++) {
+			largest_inverse = fmax(largest_inverse, fabs((&expected[0][0])[i]));
+		}
+		if (largest_inverse > 100.0) {
+			continue;
+		}
+
+		CHECK(relative_error(actual.ml, &expected[0][0], 16) < 1e-4);
+
+		Matrix identity;
+		Matrix product = m * actual;
+		CHECK(relative_error(product.ml, identity.ml, 16) < 1e-4);
+	}
+}
+
+TEST(matrix_transform_vectors_matches_vector_times_matrix) {
+	srand(31);
+	for (int n = 0; n < 1000; n++) {
+		Matrix m = (n % 2 == 0) ? random_affine() : random_matrix();
+
+		int count = rand() % 40;
+		std::vector<Vector3> points;
+		for (int i = 0; i < count; i++) {
+			points.push_back(Vector3(random_float(-10.0f, 10.0f), random_float(-10.0f, 10.0f), random_float(-10.0f, 10.0f)));
+		}
+
+		std::vector<Vector3> out(count);
+		std::vector<Vector3> in_place = points;
+		if (count > 0) {
+			Vector3::transform(&points[0], &out[0], count, m);
+			Vector3::transform(&in_place[0], &in_place[0], count, m);
+		}
+
+		for (int i = 0; i < count; i++) {
+			Vector3 expected = points[i] * m;
+			CHECK(relative_error(&out[i].x, &expected.x, 3) < 1e-6);
+			CHECK(out[i].x == in_place[i].x && out[i].y == in_place[i].y && out[i].z == in_place[i].z);
+		}
+	}
+}
+
+//Operations per second, scalar reference against the current Matrix
+BENCHMARK(matrix_against_scalar_reference) {
+	srand(32);
+	int count = 1024;
+	std::vector<Matrix> matrices;
+	for (int i = 0; i < count; i++) {
+		matrices.push_back(random_affine());
+	}
+	int rounds = 2000;
+	float sink = 0;
+
+	double start = bench_seconds();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < count - 1; i++) {
+			float out[4][4];
+			ScalarMultiply(matrices[i].m, matrices[i + 1].m, out);
+			sink += out[r & 3][i & 3];
+		}
+	}
+	double scalar_multiply = bench_seconds() - start;
+
+	start = bench_seconds();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < count - 1; i++) {
+			Matrix out = matrices[i] * matrices[i + 1];
+			sink += out.m[r & 3][i & 3];
+		}
+	}
+	double sse_multiply = bench_seconds() - start;
+
+	start = bench_seconds();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < count; i++) {
+			float out[4][4];
+			ScalarInverse(matrices[i].m, out);
+			sink += out[r & 3][i & 3];
+		}
+	}
+	double scalar_inverse = bench_seconds() - start;
+
+	start = bench_seconds();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < count; i++) {
+			Matrix out = matrices[i].Inverse();
+			sink += out.m[r & 3][i & 3];
+		}
+	}
+	double sse_inverse = bench_seconds() - start;
+
+	std::vector<Vector3> points(100000, Vector3(1.0f, 2.0f, 0.0f));
+	std::vector<Vector3> out(points.size());
+	int transform_rounds = 50;
+
+	start = bench_seconds();
+	for (int r = 0; r < transform_rounds; r++) {
+		for (int i = 0; i < points.size(); i++) {
+			out[i] = points[i] * matrices[r];
+		}
+	}
+	double scalar_transform = bench_seconds() - start;
+
+	start = bench_seconds();
+	for (int r = 0; r < transform_rounds; r++) {
+		Vector3::transform(&points[0], &out[0], points.size(), matrices[r]);
+	}
+	double sse_transform = bench_seconds() - start;
+	sink += out[0].x;
+
+	double multiplies = (double)rounds * (count - 1);
+	double inverses = (double)rounds * count;
+	double transforms = (double)transform_rounds * points.size();
+	std::cout << "  multiply: scalar " << multiplies / scalar_multiply / 1e6 << "M/s, current " << multiplies / sse_multiply / 1e6 << "M/s" << std::endl;
+	std::cout << "  inverse: scalar " << inverses / scalar_inverse / 1e6 << "M/s, current " << inverses / sse_inverse / 1e6 << "M/s" << std::endl;
+	std::cout << "  transform: vector * matrix " << transforms / scalar_transform / 1e6 << "M/s, current " << transforms / sse_transform / 1e6 << "M/s" << std::endl;
+	std::cout << "  checksum " << sink << std::endl;
+}
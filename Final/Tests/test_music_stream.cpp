@@ -0,0 +1,180 @@
+#include "Test.h"
+#include "../NYUCodebase/MusicStream.h"
+#include <fstream>
+#include <cstdio>
+
+static const char* test_wav = "music_stream_test.wav";
+
+//16 bit PCM, a ramp with a kink in it, so linear interpolation has an exact answer everywhere
+static Sint16 source_sample(int frame, int channel){
+	int value = frame < 600 ? frame * 40 - 12000 : 12000 - (frame - 600) * 25;
+	return (Sint16)(channel == 0 ? value : -value / 2);
+}
+
+static void write_wav(const char* path, int rate, int channels, int frames){
+	std::ofstream out(path, std::ios::binary);
+	Uint32 data_bytes = frames * channels * 2;
+	Uint32 riff_bytes = 4 + 8 + 16 + 8 + data_bytes;
+	Uint32 fmt_bytes = 16;
+	Uint16 format_tag = 1;
+	Uint16 channel_count = channels;
+	Uint32 byte_rate = rate * channels * 2;
+	Uint16 block_align = channels * 2;
+	Uint16 bits = 16;
+	Uint32 sample_rate = rate;
+
+	out.write("RIFF", 4);
+	out.write((const char*)&riff_bytes, 4);
+	out.write("WAVE", 4);
+	out.write("fmt ", 4);
+	out.write((const char*)&fmt_bytes, 4);
+	out.write((const char*)&format_tag, 2);
+	out.write((const char*)&channel_count, 2);
+	out.write((const char*)&sample_rate, 4);
+	out.write((const char*)&byte_rate, 4);
+	out.write((const char*)&block_align, 2);
+	out.write((const char*)&bits, 2);
+	out.write("data", 4);
+	out.write((const char*)&data_bytes, 4);
+	for (int f = 0; f < frames; f++){
+		for (int c = 0; c < channels; c++){
+			Sint16 sample = source_sample(f, c);
+			out.write((const char*)&sample, 2);
+		}
+	}
+}
+
+//What device frame k should hold: the looping source, one frame of silence in front
+//(the resampler starts from a zero frame), sampled every source_rate / device_rate frames
+static float expected_sample(int k, int channel, int source_rate, int device_rate, int source_channels, int frames){
+	double position = (double)k * source_rate / device_rate;
+	int i = (int)position;
+	float t = (float)(position - i);
+	auto at = [&](int index) -> float {
+		if (index == 0){
+			return 0;
+		}
+		int frame = (index - 1) % frames;
+		return source_channels == 1 ? source_sample(frame, 0) : source_sample(frame, channel);
+	};
+	return at(i) * (1.0f - t) + at(i + 1) * t;
+}
+
+struct MusicStreamTest{
+	//Everything decode_chunk produces, chunk after chunk, starting from a fresh track
+	static std::vector<Sint16> decode(MusicStream& music, int frames_wanted){
+		MusicStream::Track track;
+		track.path = test_wav;
+		std::vector<Sint16> result;
+		if (!music.open_wav(track)){
+			return result;
+		}
+
+		std::vector<Sint16> source;
+		std::vector<Sint16> out;
+		while (result.size() < frames_wanted * music.device_channels){
+			if (!music.decode_chunk(track, source, out)){
+				break;
+			}
+			result.insert(result.end(), out.begin(), out.end());
+		}
+		return result;
+	}
+
+	//Runs a real decoder thread into a small ring and pulls it through mix() a buffer at a time
+	static std::vector<Sint16> stream(MusicStream& music, int ring_capacity, int buffer_samples, int buffers){
+		MusicStream::Track* track = new MusicStream::Track();
+		track->path = test_wav;
+		std::vector<Sint16> result;
+		if (!music.open_wav(*track)){
+			delete track;
+			return result;
+		}
+		track->ring.resize(ring_capacity);
+		track->decoder = std::thread(&MusicStream::decode_loop, &music, track);
+		music.start_track(track, 0);
+
+		std::vector<Sint16> buffer(buffer_samples);
+		for (int b = 0; b < buffers; b++){
+			//Only mix what's there, so an underrun can't zero fill the comparison
+			for (int wait = 0; wait < 2000; wait++){
+				if (track->write_pos - track->read_pos >= buffer_samples){
+					break;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			music.mix(buffer.data(), buffer_samples);
+			result.insert(result.end(), buffer.begin(), buffer.end());
+		}
+		return result;
+	}
+
+	static void set_device(MusicStream& music, int rate, int channels){
+		music.device_rate = rate;
+		music.device_channels = channels;
+	}
+};
+
+TEST(music_decode_resamples_across_chunk_edges){
+	int frames = 1000;
+	//Up from a mono file, down from a stereo one, and a rate that doesn't divide evenly
+	int source_rates[] = { 22050, 48000, 32000 };
+	int source_channels[] = { 1, 2, 2 };
+	int device_channels[] = { 2, 2, 1 };
+	for (int test = 0; test < 3; test++){
+		write_wav(test_wav, source_rates[test], source_channels[test], frames);
+
+		MusicStream music;
+		MusicStreamTest::set_device(music, 44100, device_channels[test]);
+		//Chunk size that doesn't divide the file, so the edges land everywhere and the file loops mid chunk
+		music.chunk_frames = 97;
+		int device_frames = 3000;
+		std::vector<Sint16> decoded = MusicStreamTest::decode(music, device_frames);
+		CHECK(decoded.size() >= device_frames * device_channels[test]);
+
+		int bad = 0;
+		for (int k = 0; k < device_frames && k * device_channels[test] < decoded.size(); k++){
+			for (int c = 0; c < device_channels[test]; c++){
+				float expected;
+				if (device_channels[test] == 1 && source_channels[test] == 2){
+					//Stereo folded down to mono
+					expected = (int)((expected_sample(k, 0, source_rates[test], 44100, 2, frames) +
+						expected_sample(k, 1, source_rates[test], 44100, 2, frames)) / 2);
+				}
+				else{
+					expected = expected_sample(k, c, source_rates[test], 44100, source_channels[test], frames);
+				}
+				if (fabs(decoded[k * device_channels[test] + c] - expected) > 2.0f){
+					bad++;
+				}
+			}
+		}
+		CHECK(bad == 0);
+	}
+	remove(test_wav);
+}
+
+//A ring of 1024 samples wraps every few buffers; what comes out of mix() is still the continuous signal
+TEST(music_mix_reads_through_ring_wraparound){
+	int frames = 1000;
+	write_wav(test_wav, 22050, 1, frames);
+
+	MusicStream music;
+	MusicStreamTest::set_device(music, 44100, 2);
+	music.chunk_frames = 97;
+	int buffer_samples = 256;
+	int buffers = 200;
+	std::vector<Sint16> mixed = MusicStreamTest::stream(music, 1024, buffer_samples, buffers);
+	CHECK(mixed.size() == buffer_samples * buffers);
+
+	int bad = 0;
+	for (int k = 0; k * 2 < mixed.size(); k++){
+		float expected = expected_sample(k, 0, 22050, 44100, 1, frames);
+		if (fabs(mixed[k * 2] - expected) > 2.0f || mixed[k * 2 + 1] != mixed[k * 2]){
+			bad++;
+		}
+	}
+	CHECK(bad == 0);
+	CHECK(music.underruns == 0);
+	remove(test_wav);
+}
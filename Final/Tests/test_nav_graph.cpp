@@ -0,0 +1,241 @@
+#include "Test.h"
+#include "TestWorld.h"
+#include "../NYUCodebase/NavGraph.h"
+
+struct NavGraphTest{
+	//Cells whose outgoing edges differ between the two graphs
+	static int edge_mismatches(NavGraph& a, NavGraph& b){
+		int mismatches = 0;
+		for (int cell = 0; cell < a.width * a.height; cell++){
+			int a_count, b_count;
+			const NavEdge* a_edges = a.edges_of(cell, &a_count);
+			const NavEdge* b_edges = b.edges_of(cell, &b_count);
+			bool same = a_count == b_count;
+			for (int i = 0; same && i < a_count; i++){
+				same = a_edges[i].to == b_edges[i].to && a_edges[i].type == b_edges[i].type &&
+					a_edges[i].cost == b_edges[i].cost && a_edges[i].speed_x == b_edges[i].speed_x;
+			}
+			mismatches += !same;
+		}
+		return mismatches;
+	}
+};
+
+//Two floors with a four tile gap down to the bottom of the map between them
+static std::vector<std::string> gap_rows(){
+	std::vector<std::string> rows(6, std::string(24, '.'));
+	rows.push_back("#########....###########");
+	rows.push_back("#########....###########");
+	return rows;
+}
+
+//Centre of a cell, where a character standing in it would be
+static float cell_x(int x, float tile){
+	return (x + 0.5f) * tile;
+}
+
+static float cell_y(int y, float tile){
+	return -(y + 0.5f) * tile;
+}
+
+//Every step lands where a character can stand, and consecutive steps are where the edge type says
+static bool path_is_walkable(const std::vector<NavStep>& path, const std::vector<std::string>& rows){
+	for (int i = 0; i < path.size(); i++){
+		const NavStep& step = path[i];
+		if (rows[step.tile_y][step.tile_x] == '#' || rows[step.tile_y + 1][step.tile_x] != '#'){
+			return false;
+		}
+		if (i > 0 && step.type == NAV_WALK && abs(step.tile_x - path[i - 1].tile_x) != 1){
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST(nav_path_jumps_a_gap){
+	std::vector<std::string> rows = gap_rows();
+	TestWorld world(rows);
+	float tile = world.app->tile_world_size;
+
+	NavGraph nav;
+	nav.build(*world.app->map, world.app->collision_layer, tile);
+	CHECK(nav.node_count() == 20);
+
+	std::vector<NavStep> path;
+	CHECK(nav.find_path(cell_x(2, tile), cell_y(5, tile), cell_x(20, tile), cell_y(5, tile), path));
+	CHECK(!path.empty() && path.back().tile_x == 20 && path.back().tile_y == 5);
+	CHECK(path_is_walkable(path, rows));
+
+	//Exactly one jump, rightwards, from the near edge over to the far side
+	int jumps = 0;
+	for (int i = 0; i < path.size(); i++){
+		if (path[i].type == NAV_JUMP){
+			jumps++;
+			CHECK(path[i].speed_x > 0);
+			CHECK(path[i].tile_x >= 13);
+			CHECK(i > 0 && path[i - 1].tile_x <= 8);
+		}
+	}
+	CHECK(jumps == 1);
+
+	//And back the other way
+	CHECK(nav.find_path(cell_x(20, tile), cell_y(5, tile), cell_x(2, tile), cell_y(5, tile), path));
+	CHECK(path.back().tile_x == 2);
+	CHECK(path_is_walkable(path, rows));
+
+	//Off the map, or over the gap with nothing to stand on
+	CHECK(!nav.find_path(cell_x(2, tile), cell_y(5, tile), cell_x(30, tile), cell_y(5, tile), path));
+	CHECK(!nav.find_path(cell_x(10, tile), cell_y(5, tile), cell_x(20, tile), cell_y(5, tile), path));
+	CHECK(path.empty());
+}
+
+//A wall too tall to jump goes up and comes down again: cached paths never outlive the graph they came from
+TEST(nav_path_cache_drops_paths_when_the_map_changes){
+	std::vector<std::string> rows = gap_rows();
+	TestWorld world(rows);
+	FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	NavGraph nav;
+	nav.build(map, layer, tile);
+
+	std::vector<NavStep> first;
+	std::vector<NavStep> again;
+	CHECK(nav.find_path(cell_x(2, tile), cell_y(5, tile), cell_x(20, tile), cell_y(5, tile), first));
+	CHECK(nav.find_path(cell_x(2, tile) + 0.05f, cell_y(5, tile) + 0.1f, cell_x(20, tile), cell_y(5, tile), again));
+	CHECK(nav.searches == 1 && nav.cache_hits == 1);
+	CHECK(again.size() == first.size());
+
+	for (int y = 0; y < 6; y++){
+		map.SetTile(layer, 17, y, 1);
+	}
+	nav.invalidate_column(17);
+	CHECK(nav.update(map) > 0);
+	CHECK(!nav.find_path(cell_x(2, tile), cell_y(5, tile), cell_x(20, tile), cell_y(5, tile), again));
+	CHECK(nav.searches == 2 && nav.cache_hits == 1);
+	//Still short of the wall
+	CHECK(nav.find_path(cell_x(2, tile), cell_y(5, tile), cell_x(15, tile), cell_y(5, tile), again));
+
+	for (int y = 0; y < 6; y++){
+		map.SetTile(layer, 17, y, 0);
+	}
+	nav.invalidate_column(17);
+	nav.update(map);
+	CHECK(nav.find_path(cell_x(2, tile), cell_y(5, tile), cell_x(20, tile), cell_y(5, tile), again));
+	CHECK(nav.searches == 4 && nav.cache_hits == 1);
+	CHECK(again.size() == first.size());
+	for (int i = 0; i < first.size() && i < again.size(); i++){
+		CHECK(again[i].tile_x == first[i].tile_x && again[i].tile_y == first[i].tile_y && again[i].type == first[i].type);
+	}
+
+	//Nothing changed, nothing rebuilt, the cache keeps working
+	CHECK(nav.update(map) == 0);
+	CHECK(nav.find_path(cell_x(2, tile), cell_y(5, tile), cell_x(20, tile), cell_y(5, tile), again));
+	CHECK(nav.cache_hits == 2);
+}
+
+//Floor with holes plus scattered platforms, for jumps and falls in every direction
+static std::vector<std::string> platform_rows(int width, int height, int platforms){
+	std::vector<std::string> rows(height, std::string(width, '.'));
+	for (int i = 0; i < platforms; i++){
+		int x = rand() % (width - 10);
+		int y = 3 + rand() % (height - 6);
+		int length = 2 + rand() % 8;
+		for (int j = 0; j < length; j++){
+			rows[y][x + j] = '#';
+		}
+	}
+	for (int x = 0; x < width; x++){
+		rows[height - 1][x] = rand() % 12 == 0 ? '.' : '#';
+	}
+	return rows;
+}
+
+//Edits here and there, each followed by update(): the same edges as a graph built from scratch
+TEST(nav_incremental_update_matches_a_full_build){
+	srand(17);
+	TestWorld world(platform_rows(160, 40, 120));
+	FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	NavGraph nav;
+	nav.build(map, layer, tile);
+	int chunk_count = (map.mapWidth + nav.chunk_columns - 1) / nav.chunk_columns;
+
+	int rebuilt = 0;
+	for (int round = 0; round < 25; round++){
+		int edits = 1 + rand() % 3;
+		for (int e = 0; e < edits; e++){
+			int x = rand() % map.mapWidth;
+			int y = 2 + rand() % (map.mapHeight - 2);
+			map.SetTile(layer, x, y, map.layers[layer][y][x] == 0 ? 1 : 0);
+			nav.invalidate_column(x);
+		}
+		rebuilt += nav.update(map);
+
+		NavGraph fresh;
+		fresh.build(map, layer, tile);
+		CHECK(nav.node_count() == fresh.node_count());
+		CHECK(nav.edge_count() == fresh.edge_count());
+		CHECK(NavGraphTest::edge_mismatches(nav, fresh) == 0);
+	}
+
+	//Only the chunks near the edits were rebuilt
+	CHECK(rebuilt < 25 * chunk_count / 2);
+}
+
+//Long runs across a wide level, fresh goals each time against the same goals again from the cache
+BENCHMARK(nav_cross_map_query){
+	srand(23);
+	std::vector<std::string> rows = platform_rows(1024, 64, 900);
+	TestWorld world(rows);
+	float tile = world.app->tile_world_size;
+
+	double start = bench_seconds();
+	NavGraph nav;
+	nav.build(*world.app->map, world.app->collision_layer, tile);
+	double build_ms = (bench_seconds() - start) * 1000.0;
+
+	//Start and goal in opposite quarters of the map, on some standing cell of that column
+	int query_count = 200;
+	std::vector<float> queries;
+	while (queries.size() < query_count * 4){
+		int from_x = rand() % 256;
+		int to_x = 768 + rand() % 256;
+		queries.push_back(cell_x(from_x, tile));
+		queries.push_back(cell_y(rand() % 60, tile));
+		queries.push_back(cell_x(to_x, tile));
+		queries.push_back(cell_y(rand() % 60, tile));
+	}
+
+	std::vector<NavStep> path;
+	int found = 0;
+	long long expanded = 0;
+	long long steps = 0;
+	start = bench_seconds();
+	for (int i = 0; i < query_count; i++){
+		if (nav.find_path(queries[i * 4], queries[i * 4 + 1], queries[i * 4 + 2], queries[i * 4 + 3], path)){
+			found++;
+			steps += path.size();
+		}
+		expanded += nav.last_expanded;
+	}
+	double search_ms = (bench_seconds() - start) * 1000.0 / query_count;
+
+	//The last cache_size queries again
+	int repeats = 10000;
+	int first_cached = query_count - nav.cache_size;
+	start = bench_seconds();
+	for (int i = 0; i < repeats; i++){
+		int q = first_cached + i % nav.cache_size;
+		nav.find_path(queries[q * 4], queries[q * 4 + 1], queries[q * 4 + 2], queries[q * 4 + 3], path);
+	}
+	double cached_us = (bench_seconds() - start) * 1000000.0 / repeats;
+
+	std::cout << "  1024x64 map, " << nav.node_count() << " nodes, " << nav.edge_count() << " edges, build " << build_ms << " ms" << std::endl;
+	std::cout << "  search: " << search_ms << " ms per query, " << found << "/" << query_count << " found, "
+		<< expanded / query_count << " nodes expanded, " << (found > 0 ? steps / found : 0) << " steps" << std::endl;
+	std::cout << "  cached: " << cached_us << " us per query, " << nav.cache_hits << " hits" << std::endl;
+}
@@ -0,0 +1,210 @@
+#include "Test.h"
+#include "../NYUCodebase/SoundBank.h"
+#include <thread>
+#include <atomic>
+
+//Fake mixer: every channel keeps playing until a test says it stopped
+static const int fake_channel_count = 4;
+static Mix_Chunk* fake_channels[fake_channel_count];
+static std::atomic<bool> fake_busy[fake_channel_count];
+static char fake_chunk_bytes[8];
+static std::atomic<int> fake_frees;
+
+static int fake_allocate_channels(int count){
+	for (int i = 0; i < fake_channel_count; i++){
+		fake_channels[i] = NULL;
+		fake_busy[i] = false;
+	}
+	return count;
+}
+
+static int fake_play_channel(int channel, Mix_Chunk* chunk){
+	fake_channels[channel] = chunk;
+	fake_busy[channel] = true;
+	return channel;
+}
+
+static bool fake_playing(int channel){
+	return fake_busy[channel];
+}
+
+static void fake_free_chunk(Mix_Chunk* chunk){
+	fake_frees++;
+}
+
+//Distinct pointers the fake mixer can tell apart, never dereferenced
+static Mix_Chunk* fake_chunk(int index){
+	return (Mix_Chunk*)&fake_chunk_bytes[index];
+}
+
+static void use_fake_mixer(SoundBank& sounds){
+	sounds.mixer.allocate_channels = fake_allocate_channels;
+	sounds.mixer.play_channel = fake_play_channel;
+	sounds.mixer.playing = fake_playing;
+	sounds.mixer.free_chunk = fake_free_chunk;
+}
+
+//Until the audio thread has started or dropped count sounds in total
+static bool wait_for_audio_thread(SoundBank& sounds, int count){
+	for (int i = 0; i < 2000; i++){
+		if (sounds.played + sounds.dropped >= count){
+			return true;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+TEST(sound_played_twice_in_a_tick_plays_once){
+	SoundBank sounds;
+	use_fake_mixer(sounds);
+	SoundId hit = sounds.add("hit", fake_chunk(0), 4);
+	SoundId jump = sounds.add("jump", fake_chunk(1), 4);
+	CHECK(sounds.find("jump") == jump);
+	CHECK(sounds.find("missing") == NO_SOUND);
+	sounds.start(fake_channel_count);
+
+	sounds.play(hit);
+	sounds.play(hit);
+	sounds.play(jump);
+	sounds.play(hit);
+	sounds.end_tick();
+	sounds.play(hit);
+	sounds.play(NO_SOUND);
+	sounds.play(17);
+
+	CHECK(wait_for_audio_thread(sounds, 3));
+	CHECK(sounds.played == 3);
+	CHECK(sounds.coalesced == 2);
+	CHECK(sounds.dropped == 0);
+
+	fake_frees = 0;
+	sounds.stop();
+	CHECK(fake_frees == 2);
+}
+
+//Producers on several threads, every (sound, tick) comes out exactly once
+TEST(sound_queue_takes_plays_from_many_threads){
+	SoundBank sounds;
+	use_fake_mixer(sounds);
+	int sound_count = 8;
+	for (int i = 0; i < sound_count; i++){
+		sounds.add("sound " + std::to_string(i), fake_chunk(i), 1);
+	}
+	sounds.start(fake_channel_count);
+
+	int thread_count = 4;
+	int ticks = 50;
+	for (int tick = 0; tick < ticks; tick++){
+		std::vector<std::thread> threads;
+		for (int t = 0; t < thread_count; t++){
+			threads.push_back(std::thread([&sounds, sound_count, t]{
+				for (int i = 0; i < sound_count; i++){
+					sounds.play((i + t) % sound_count);
+				}
+			}));
+		}
+		for (int t = 0; t < thread_count; t++){
+			threads[t].join();
+		}
+		sounds.end_tick();
+	}
+
+	CHECK(wait_for_audio_thread(sounds, sound_count * ticks));
+	CHECK(sounds.played == sound_count * ticks);
+	CHECK(sounds.coalesced == (thread_count - 1) * sound_count * ticks);
+	CHECK(sounds.dropped == 0);
+}
+
+//With no audio thread draining it, the ring holds 256 plays and drops the rest
+TEST(sound_queue_drops_when_full){
+	SoundBank sounds;
+	use_fake_mixer(sounds);
+	SoundId hit = sounds.add("hit", fake_chunk(0), 1);
+	for (int tick = 0; tick < 300; tick++){
+		sounds.play(hit);
+		sounds.end_tick();
+	}
+	CHECK(sounds.dropped == 300 - 256);
+
+	//Everything queued still comes out once the thread runs; one voice, so each steals the last
+	sounds.start(fake_channel_count);
+	CHECK(wait_for_audio_thread(sounds, 300));
+	CHECK(sounds.played == 256);
+	CHECK(sounds.stolen == 255);
+}
+
+TEST(sound_voice_caps_and_priority_stealing){
+	SoundBank sounds;
+	use_fake_mixer(sounds);
+	SoundId shot = sounds.add("shot", fake_chunk(0), 2, 0);
+	SoundId pain = sounds.add("pain", fake_chunk(1), 2, 1);
+	SoundId boss = sounds.add("boss", fake_chunk(2), 1, 2);
+	SoundId ambient = sounds.add("ambient", fake_chunk(3), 1, -1);
+	sounds.start(fake_channel_count);
+	int expected = 0;
+
+	//Third shot is over its cap of two, it restarts the oldest shot instead of taking a free channel
+	for (int i = 0; i < 3; i++){
+		sounds.play(shot);
+		sounds.end_tick();
+		CHECK(wait_for_audio_thread(sounds, ++expected));
+	}
+	CHECK(sounds.stolen == 1);
+	CHECK(fake_channels[0] == fake_chunk(0) && fake_channels[1] == fake_chunk(0));
+	CHECK(fake_channels[2] == NULL && fake_channels[3] == NULL);
+
+	sounds.play(pain);
+	sounds.end_tick();
+	sounds.play(pain);
+	sounds.end_tick();
+	CHECK(wait_for_audio_thread(sounds, expected += 2));
+	CHECK(fake_channels[2] == fake_chunk(1) && fake_channels[3] == fake_chunk(1));
+	CHECK(sounds.stolen == 1);
+
+	//All busy: boss takes the oldest voice of the lowest priority, channel 1's shot
+	//(channel 0 restarted later), then nothing playing is low enough for ambient
+	sounds.play(boss);
+	sounds.play(ambient);
+	sounds.end_tick();
+	CHECK(wait_for_audio_thread(sounds, expected += 2));
+	CHECK(fake_channels[1] == fake_chunk(2));
+	CHECK(fake_channels[0] == fake_chunk(0));
+	CHECK(sounds.stolen == 2);
+	CHECK(sounds.dropped == 1);
+
+	//A voice that finished frees its channel
+	fake_busy[3] = false;
+	sounds.play(ambient);
+	sounds.end_tick();
+	CHECK(wait_for_audio_thread(sounds, ++expected));
+	CHECK(fake_channels[3] == fake_chunk(3));
+	CHECK(sounds.stolen == 2);
+	CHECK(sounds.played == 7);
+}
+
+//The game thread's side only: a burst of plays per tick, with the tick's other work in between
+BENCHMARK(sound_play_cost){
+	SoundBank sounds;
+	use_fake_mixer(sounds);
+	for (int i = 0; i < 8; i++){
+		sounds.add("sound " + std::to_string(i), fake_chunk(i), 2);
+	}
+	sounds.start(fake_channel_count);
+
+	int ticks = 500;
+	double play_seconds = 0;
+	for (int tick = 0; tick < ticks; tick++){
+		double start = bench_seconds();
+		for (int i = 0; i < 8; i++){
+			sounds.play(i);
+		}
+		play_seconds += bench_seconds() - start;
+		sounds.end_tick();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	CHECK(wait_for_audio_thread(sounds, ticks * 8));
+	std::cout << "  " << ticks * 8 << " plays: " << play_seconds * 1e9 / (ticks * 8) << " ns each, "
+		<< sounds.dropped << " dropped" << std::endl;
+}
@@ -0,0 +1,121 @@
+#include "Test.h"
+#include "../NYUCodebase/SdfFont.h"
+#include "../NYUCodebase/TextMeshCache.h"
+
+//Proportional metrics without loading the sheet, so glyphs differ in width
+static void fake_metrics(SdfFont& font){
+	for (int i = 0; i < 256; i++){
+		font.glyphs[i].left = (i % 5) / 16.0f;
+		font.glyphs[i].advance = 0.3f + (i % 7) / 20.0f;
+	}
+}
+
+TEST(text_cache_hits_misses_and_evicts_least_recent){
+	TextMeshCache cache;
+	cache.max_entries = 2;
+	bool hit;
+
+	cache.get("score", 0, 0, 0.4f, 0, hit).verts.push_back(1.0f);
+	CHECK(!hit);
+	cache.get("score", 0, 0, 0.4f, 0, hit);
+	CHECK(hit);
+	CHECK(cache.get("score", 0, 0, 0.4f, 0, hit).verts.size() == 1);
+
+	//Any part of the key changing is a different mesh
+	cache.get("score", 0.1f, 0, 0.4f, 0, hit);
+	CHECK(!hit);
+	cache.get("score", 0, 0, 0.5f, 0, hit);
+	CHECK(!hit);
+	CHECK(cache.size() == 2);
+	CHECK(cache.evictions == 1);
+
+	//The (0.1, 0) one was used longer ago than the 0.5 size one, so it went next
+	cache.get("lives", 0, 0, 0.4f, 0, hit);
+	cache.get("score", 0, 0, 0.5f, 0, hit);
+	CHECK(hit);
+	cache.get("score", 0.1f, 0, 0.4f, 0, hit);
+	CHECK(!hit);
+
+	//Recycled entries come back empty
+	CHECK(cache.get("score", 0, 0, 0.4f, 0, hit).verts.empty());
+	CHECK(cache.hits == 3);
+	CHECK(cache.misses == 6);
+	CHECK(cache.rebuilt_glyphs == 30);
+}
+
+//Second frame copies the same quads the first one built
+TEST(sdf_text_from_the_cache_matches_a_fresh_layout){
+	SdfFont cached;
+	fake_metrics(cached);
+	const char* lines[] = { "Platformer", "Press Spacebar to play", "GAME OVER", "" };
+
+	std::vector<float> first_verts, first_tex_coords;
+	for (int frame = 0; frame < 3; frame++){
+		cached.begin();
+		for (int i = 0; i < 4; i++){
+			cached.add_text(lines[i], -1.5f, 1.0f - i * 0.5f, 0.4f, 0.01f);
+		}
+		if (frame == 0){
+			first_verts = cached.batch_verts();
+			first_tex_coords = cached.batch_tex_coords();
+		}
+		else{
+			CHECK(cached.batch_verts() == first_verts);
+			CHECK(cached.batch_tex_coords() == first_tex_coords);
+		}
+	}
+	CHECK(cached.text_cache.misses == 4);
+	CHECK(cached.text_cache.hits == 8);
+	CHECK(first_verts.size() == (10 + 22 + 9) * 12);
+
+	//Laid out in one go by a font that never saw these strings
+	SdfFont fresh;
+	fake_metrics(fresh);
+	fresh.begin();
+	for (int i = 0; i < 4; i++){
+		fresh.add_text(lines[i], -1.5f, 1.0f - i * 0.5f, 0.4f, 0.01f);
+	}
+	CHECK(fresh.batch_verts() == first_verts);
+
+	//A glyph's quad starts where the previous glyph's advance left the pen
+	float pen = -1.5f - 0.2f;
+	for (int i = 0; i < 10; i++){
+		const GlyphMetrics& glyph = cached.glyphs[(unsigned char)lines[0][i]];
+		CHECK_NEAR(first_verts[i * 12], pen - glyph.left * 0.4f, 0.00001f);
+		pen += glyph.advance * 0.4f + 0.01f;
+	}
+}
+
+//Menu lines that stay the same, copied out of the cache vs laid out again every frame
+BENCHMARK(sdf_text_cache){
+	SdfFont font;
+	fake_metrics(font);
+	std::vector<std::string> lines;
+	for (int i = 0; i < 12; i++){
+		lines.push_back("Static menu line number " + std::to_string(i));
+	}
+
+	int frames = 20000;
+	double start = bench_seconds();
+	for (int frame = 0; frame < frames; frame++){
+		font.begin();
+		for (int i = 0; i < lines.size(); i++){
+			font.add_text(lines[i], -1.5f, 1.0f - i * 0.2f, 0.18f);
+		}
+	}
+	double cached_ms = (bench_seconds() - start) * 1000.0 / frames;
+
+	start = bench_seconds();
+	for (int frame = 0; frame < frames; frame++){
+		font.begin();
+		font.text_cache.clear();
+		for (int i = 0; i < lines.size(); i++){
+			font.add_text(lines[i], -1.5f, 1.0f - i * 0.2f, 0.18f);
+		}
+	}
+	double rebuilt_ms = (bench_seconds() - start) * 1000.0 / frames;
+
+	std::cout << "  " << lines.size() << " lines, " << font.batch_verts().size() / 12 << " glyphs per frame" << std::endl;
+	std::cout << "  laid out every frame: " << rebuilt_ms << " ms" << std::endl;
+	std::cout << "  copied from the cache: " << cached_ms << " ms" << std::endl;
+}
@@ -0,0 +1,149 @@
+#include "Test.h"
+#include "../NYUCodebase/TextureCooker.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+
+//Works on a copy of a real sprite next to the test binary, so nothing under resources/ changes
+static const char* source_png = "../NYUCodebase/resources/zero_idle.png";
+static const char* test_png = "texture_cooker_test.png";
+
+static std::string read_file(const std::string& path){
+	std::ifstream in(path, std::ios::binary);
+	return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+static void write_file(const std::string& path, const std::string& bytes){
+	std::ofstream out(path, std::ios::binary);
+	out.write(bytes.data(), bytes.size());
+}
+
+//Fresh png copy and no cooked file
+static bool reset_test_png(){
+	std::string png = read_file(source_png);
+	if (png.empty()){
+		std::cout << "  missing " << source_png << ", run from the Tests directory" << std::endl;
+		return false;
+	}
+	write_file(test_png, png);
+	remove(TextureCooker::cooked_path(test_png).c_str());
+	return true;
+}
+
+static void cleanup(){
+	remove(test_png);
+	remove(TextureCooker::cooked_path(test_png).c_str());
+}
+
+TEST(cooker_writes_and_reads_back_the_same_texture){
+	if (!reset_test_png()){
+		CHECK(false);
+		return;
+	}
+
+	CookedTexture cooked;
+	CHECK(TextureCooker::load(test_png, cooked));
+	CHECK(cooked.width == 36 && cooked.height == 45);
+	CHECK(cooked.mips.size() == 6); //45, 22, 11, 5, 2, 1
+	CHECK(cooked.source_size > 0);
+
+	CookedTexture read_back;
+	CHECK(TextureCooker::read(read_back, TextureCooker::cooked_path(test_png)));
+	CHECK(read_back.format == cooked.format);
+	CHECK(read_back.source_size == cooked.source_size && read_back.source_time == cooked.source_time);
+	CHECK(read_back.mips.size() == cooked.mips.size());
+	for (int i = 0; i < read_back.mips.size() && i < cooked.mips.size(); i++){
+		CHECK(read_back.mips[i].data == cooked.mips[i].data);
+	}
+
+	//Before is the png as it was loaded: RGBA8, one level
+	CHECK(cooked.baseline_size() == 36 * 45 * 4);
+	CHECK(cooked.rgba8_size() > cooked.baseline_size());
+	cleanup();
+}
+
+//Every way the file can be cut short or lie about its contents is rejected, then recooked
+TEST(cooker_rejects_damaged_files_and_recooks){
+	if (!reset_test_png()){
+		CHECK(false);
+		return;
+	}
+
+	CookedTexture cooked;
+	TextureCooker::load(test_png, cooked);
+	std::string path = TextureCooker::cooked_path(test_png);
+	std::string good = read_file(path);
+	CHECK(good.size() > 60);
+
+	std::vector<std::string> damaged;
+	//Truncated anywhere: magic, header, mip header, mip data, last byte
+	int cuts[] = { 0, 3, 10, 25, 40, 50, 60 };
+	for (int i = 0; i < 7; i++){
+		damaged.push_back(good.substr(0, cuts[i]));
+	}
+	damaged.push_back(good.substr(0, good.size() - 1));
+
+	//Header fields: magic, width, format, mip count 0, mip count too big, mip count huge
+	int header_offset = 4 + 16;
+	std::string bad = good;
+	bad[0] = 'X';
+	damaged.push_back(bad);
+	int values[][2] = { { 0, -5 }, { 2, 9 }, { 3, 0 }, { 3, 8 }, { 3, 0x7fffffff } };
+	for (int i = 0; i < 5; i++){
+		bad = good;
+		memcpy(&bad[header_offset + values[i][0] * 4], &values[i][1], 4);
+		damaged.push_back(bad);
+	}
+
+	//First mip header: wrong width, byte count that doesn't match the size
+	int mip_offset = header_offset + 16;
+	int mip_values[][2] = { { 0, 18 }, { 2, 1 << 30 }, { 2, -1 } };
+	for (int i = 0; i < 3; i++){
+		bad = good;
+		memcpy(&bad[mip_offset + mip_values[i][0] * 4], &mip_values[i][1], 4);
+		damaged.push_back(bad);
+	}
+
+	for (int i = 0; i < damaged.size(); i++){
+		write_file(path, damaged[i]);
+
+		CookedTexture texture;
+		CHECK(!TextureCooker::read(texture, path));
+
+		//load falls back to the png and puts a good file back
+		CHECK(TextureCooker::load(test_png, texture));
+		CHECK(texture.mips.size() == cooked.mips.size());
+		CHECK(read_file(path) == good);
+	}
+	cleanup();
+}
+
+TEST(cooker_recooks_when_the_png_changes){
+	if (!reset_test_png()){
+		CHECK(false);
+		return;
+	}
+
+	CookedTexture cooked;
+	TextureCooker::load(test_png, cooked);
+	std::string path = TextureCooker::cooked_path(test_png);
+
+	//Bytes after IEND are ignored by the decoder but change the file size
+	std::string png = read_file(test_png);
+	write_file(test_png, png + "edited");
+
+	CookedTexture reloaded;
+	CHECK(TextureCooker::load(test_png, reloaded));
+	CHECK(reloaded.source_size == png.size() + 6);
+
+	CookedTexture saved;
+	CHECK(TextureCooker::read(saved, path));
+	CHECK(saved.source_size == png.size() + 6);
+
+	//Without the png, the cooked file is used as is
+	remove(test_png);
+	CookedTexture stripped;
+	CHECK(TextureCooker::load(test_png, stripped));
+	CHECK(stripped.mips.size() == cooked.mips.size());
+	cleanup();
+}
@@ -0,0 +1,118 @@
+#include "Test.h"
+#include "TestWorld.h"
+#include "../NYUCodebase/TextureManager.h"
+#include <fstream>
+#include <cstdio>
+
+//Copies of a real sprite next to the test binary, so evicted textures have a file to reload from
+static const char* source_png = "../NYUCodebase/resources/zero_idle.png";
+static const char* test_pngs[] = { "texture_manager_a.png", "texture_manager_b.png", "texture_manager_c.png" };
+
+static bool copy_test_pngs(){
+	std::ifstream in(source_png, std::ios::binary);
+	std::string png((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	if (png.empty()){
+		std::cout << "  missing " << source_png << ", run from the Tests directory" << std::endl;
+		return false;
+	}
+	for (int i = 0; i < 3; i++){
+		std::ofstream out(test_pngs[i], std::ios::binary);
+		out.write(png.data(), png.size());
+	}
+	return true;
+}
+
+static void cleanup(){
+	for (int i = 0; i < 3; i++){
+		remove(test_pngs[i]);
+		remove(TextureCooker::cooked_path(test_pngs[i]).c_str());
+	}
+}
+
+TEST(texture_loads_are_cached_by_path){
+	make_test_gl_context();
+	if (!copy_test_pngs()){
+		CHECK(false);
+		return;
+	}
+
+	TextureManager textures;
+	float width, height, width2, height2;
+	GLuint id = textures.load(test_pngs[0], &width, &height);
+	GLuint again = textures.load(test_pngs[0], &width2, &height2);
+	CHECK(id == again);
+	CHECK(width == width2 && height == height2);
+	CHECK(textures.count() == 1);
+	CHECK(textures.resident_bytes() == textures.find(id)->bytes);
+
+	GLuint other = textures.load(test_pngs[1], &width2, &height2);
+	CHECK(other != id);
+	CHECK(textures.count() == 2);
+
+	//Generated textures count towards memory but never answer a path lookup
+	GLuint generated = textures.create(test_pngs[0], 16, 16, 256);
+	CHECK(generated != id);
+	CHECK(textures.load(test_pngs[0], &width2, &height2) == id);
+	CHECK(textures.resident_bytes() == textures.find(id)->bytes * 2 + 256);
+
+	textures.release(generated);
+	textures.release(id);
+	CHECK(textures.find(id) == NULL);
+	CHECK(textures.count() == 1);
+	CHECK(textures.resident_bytes() == textures.find(other)->bytes);
+	cleanup();
+}
+
+TEST(over_budget_evicts_least_recently_bound_and_reloads_on_bind){
+	make_test_gl_context();
+	if (!copy_test_pngs()){
+		CHECK(false);
+		return;
+	}
+
+	TextureManager textures;
+	float width, height;
+	GLuint a = textures.load(test_pngs[0], &width, &height);
+	GLuint b = textures.load(test_pngs[1], &width, &height);
+	GLuint c = textures.load(test_pngs[2], &width, &height);
+	GLuint font = textures.create("font", 64, 64, 4096);
+	int each = textures.find(a)->bytes;
+	textures.end_frame();
+
+	//b last bound a frame ago, c and a this frame
+	textures.bind(b);
+	textures.end_frame();
+	textures.bind(c);
+	textures.bind(a);
+	CHECK(textures.evictions == 0);
+
+	//Nothing bound this frame can go, even under budget pressure
+	textures.budget_bytes = 0;
+	textures.end_frame();
+	CHECK(!textures.find(b)->resident);
+	CHECK(textures.find(a)->resident && textures.find(c)->resident);
+	CHECK(textures.find(font)->resident);
+	CHECK(textures.evictions == 1);
+	CHECK(textures.resident_bytes() == each * 2 + 4096);
+
+	//Room for two of the three sprites and the font, back under once the oldest goes
+	textures.budget_bytes = each * 2 + 4096;
+	textures.bind(b);
+	CHECK(textures.find(b)->resident);
+	CHECK(textures.find(b)->reloads == 1);
+	CHECK(textures.resident_bytes() == each * 3 + 4096);
+	textures.bind(c);
+	textures.end_frame();
+	CHECK(!textures.find(a)->resident);
+	CHECK(textures.find(b)->resident && textures.find(c)->resident);
+	CHECK(textures.evictions == 2);
+	CHECK(textures.resident_bytes() <= textures.budget_bytes);
+
+	//The generated font never goes, whatever the budget
+	textures.budget_bytes = 0;
+	textures.end_frame();
+	textures.end_frame();
+	CHECK(textures.find(font)->resident);
+	CHECK(textures.resident_bytes() == 4096);
+	cleanup();
+}
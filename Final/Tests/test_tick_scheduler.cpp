@@ -0,0 +1,149 @@
+#include "Test.h"
+#include "../NYUCodebase/TickScheduler.h"
+
+//Period in ticks, read back through elapsed()
+static int period_of(const TickScheduler& scheduler, int system, float tick_rate){
+	return (int)floorf(scheduler.elapsed(system) * tick_rate + 0.5f);
+}
+
+TEST(tick_scheduler_rounds_rates_to_whole_periods){
+	TickScheduler scheduler;
+	scheduler.set_tick_rate(60.0f);
+	int every = scheduler.add("every", 0);
+	int fast = scheduler.add("fast", 120.0f);
+	int tick_rate = scheduler.add("tick rate", 60.0f);
+	int down = scheduler.add("25 Hz", 25.0f); //2.4 ticks
+	int up = scheduler.add("24 Hz", 24.0f); //2.5 ticks rounds up
+	int slow = scheduler.add("slow", 7.0f); //8.57 ticks
+
+	CHECK(period_of(scheduler, every, 60) == 1);
+	CHECK(period_of(scheduler, fast, 60) == 1);
+	CHECK(period_of(scheduler, tick_rate, 60) == 1);
+	CHECK(period_of(scheduler, down, 60) == 2);
+	CHECK(period_of(scheduler, up, 60) == 3);
+	CHECK(period_of(scheduler, slow, 60) == 9);
+	CHECK_NEAR(scheduler.elapsed(slow), 9 / 60.0f, 1e-7);
+
+	//A new tick rate recomputes every period from the rate asked for
+	scheduler.set_tick_rate(120.0f);
+	CHECK(period_of(scheduler, every, 120) == 1);
+	CHECK(period_of(scheduler, fast, 120) == 1);
+	CHECK(period_of(scheduler, tick_rate, 120) == 2);
+	CHECK(period_of(scheduler, down, 120) == 5);
+	CHECK(period_of(scheduler, up, 120) == 5);
+	CHECK(period_of(scheduler, slow, 120) == 17);
+
+	scheduler.set_rate(slow, 30.0f);
+	CHECK(period_of(scheduler, slow, 120) == 4);
+}
+
+//Over whole periods every system runs exactly ticks / period times, on one phase
+TEST(tick_scheduler_runs_each_system_on_its_phase){
+	TickScheduler scheduler;
+	scheduler.set_tick_rate(60.0f);
+	float rates[] = { 0, 30.0f, 20.0f, 15.0f, 10.0f };
+	int periods[] = { 1, 2, 3, 4, 6 };
+	std::vector<int> ids;
+	for (int i = 0; i < 5; i++){
+		ids.push_back(scheduler.add("system", rates[i]));
+	}
+
+	std::vector<int> runs(5, 0);
+	std::vector<int> first_tick(5, -1);
+	for (int t = 0; t < 120; t++){
+		scheduler.begin_tick();
+		CHECK(scheduler.tick() == t);
+		for (int i = 0; i < 5; i++){
+			scheduler.run(ids[i], [&runs, i](){ runs[i]++; });
+			if (scheduler.due(ids[i])){
+				if (first_tick[i] < 0){
+					first_tick[i] = t;
+				}
+				CHECK((t - first_tick[i]) % periods[i] == 0);
+			}
+		}
+	}
+	for (int i = 0; i < 5; i++){
+		CHECK(runs[i] == 120 / periods[i]);
+		CHECK(first_tick[i] >= 0 && first_tick[i] < periods[i]);
+	}
+}
+
+//Systems at the same rate take turns instead of all landing on tick 0
+TEST(tick_scheduler_spreads_equal_periods_across_ticks){
+	TickScheduler scheduler;
+	scheduler.set_tick_rate(60.0f);
+	std::vector<int> ids;
+	for (int i = 0; i < 4; i++){
+		ids.push_back(scheduler.add("15 Hz", 15.0f));
+	}
+	//Every tick of a 4 tick period has exactly one of them
+	for (int t = 0; t < 8; t++){
+		scheduler.begin_tick();
+		int due = 0;
+		for (int i = 0; i < 4; i++){
+			due += scheduler.due(ids[i]);
+		}
+		CHECK(due == 1);
+	}
+
+	//Two 30 Hz systems go on opposite ticks, each meeting two of the 15 Hz ones
+	int a = scheduler.add("30 Hz", 30.0f);
+	int b = scheduler.add("30 Hz", 30.0f);
+	int most = 0;
+	for (int t = 0; t < 8; t++){
+		scheduler.begin_tick();
+		CHECK(scheduler.due(a) != scheduler.due(b));
+		int due = 0;
+		for (int i = 0; i < ids.size(); i++){
+			due += scheduler.due(ids[i]);
+		}
+		due += scheduler.due(a) + scheduler.due(b);
+		most = std::max(most, due);
+	}
+	CHECK(most == 2);
+
+	//Moving one to 15 Hz picks a phase without counting its own old one,
+	//which would tie every phase and stack three systems on tick 0
+	scheduler.set_rate(b, 15.0f);
+	int least = 100;
+	most = 0;
+	for (int t = 0; t < 8; t++){
+		scheduler.begin_tick();
+		int due = scheduler.due(a) + scheduler.due(b);
+		for (int i = 0; i < ids.size(); i++){
+			due += scheduler.due(ids[i]);
+		}
+		least = std::min(least, due);
+		most = std::max(most, due);
+	}
+	CHECK(most == 2 && least == 1);
+}
+
+TEST(tick_scheduler_time_and_elapsed_follow_the_ticks){
+	TickScheduler scheduler;
+	scheduler.set_tick_rate(60.0f);
+	int physics = scheduler.add("physics", 0);
+	int scripts = scheduler.add("scripts", 20.0f);
+
+	for (int t = 0; t < 90; t++){
+		scheduler.begin_tick();
+	}
+	CHECK(scheduler.tick() == 89);
+	CHECK_NEAR(scheduler.time(), 89 / 60.0f, 1e-6);
+	CHECK_NEAR(scheduler.elapsed(physics), 1 / 60.0f, 1e-7);
+	CHECK_NEAR(scheduler.elapsed(scripts), 3 / 60.0f, 1e-7);
+
+	//A system that runs every third tick covers three ticks of sim time per run
+	float covered = 0;
+	for (int t = 0; t < 60; t++){
+		scheduler.begin_tick();
+		scheduler.run(scripts, [&](){ covered += scheduler.elapsed(scripts); });
+	}
+	CHECK_NEAR(covered, 1.0f, 1e-5);
+
+	//At 120 ticks a second time runs at half a tick's worth per tick
+	scheduler.set_tick_rate(120.0f);
+	CHECK_NEAR(scheduler.time(), 149 / 120.0f, 1e-6);
+	CHECK_NEAR(scheduler.elapsed(scripts), 6 / 120.0f, 1e-7);
+}
@@ -0,0 +1,97 @@
+#include "Test.h"
+#include "TestWorld.h"
+#include "../NYUCodebase/TileMesh.h"
+
+//A 64x64 sheet of 8 pixel tiles, ids up to 63
+static void build_mesh(TileMesh& mesh, const FlareMap& map, int layer){
+	std::vector<int> layers(1, layer);
+	mesh.build(map, layers, 64, 64, 8, 0.18f);
+}
+
+static std::vector<std::string> random_rows(int width, int height, unsigned int seed){
+	srand(seed);
+	std::vector<std::string> rows(height, std::string(width, '.'));
+	for (int y = 0; y < height; y++){
+		for (int x = 0; x < width; x++){
+			if (rand() % 3 == 0){
+				rows[y][x] = '#';
+			}
+		}
+	}
+	return rows;
+}
+
+TEST(tile_mesh_edits_match_a_fresh_build){
+	TestWorld world(random_rows(70, 40, 9));
+	FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+
+	TileMesh mesh;
+	build_mesh(mesh, map, layer);
+	for (int round = 0; round < 20; round++){
+		for (int e = 0; e < 50; e++){
+			int x = rand() % map.mapWidth;
+			int y = rand() % map.mapHeight;
+			unsigned int tile_id = rand() % 3 == 0 ? 0 : 1 + rand() % 62;
+			map.SetTile(layer, x, y, tile_id);
+			mesh.set_tile(layer, x, y, tile_id);
+		}
+		//Off the map, and a layer the mesh doesn't have
+		mesh.set_tile(layer, -1, 3, 5);
+		mesh.set_tile(layer, map.mapWidth, 3, 5);
+		mesh.set_tile(layer - 1, 3, 3, 5);
+
+		TileMesh fresh;
+		build_mesh(fresh, map, layer);
+		CHECK(mesh.vertex_data() == fresh.vertex_data());
+		CHECK(mesh.tex_coord_data() == fresh.tex_coord_data());
+		CHECK(mesh.quad_count() == fresh.quad_count());
+	}
+	CHECK(mesh.edits == 20 * 50);
+}
+
+TEST(tile_mesh_upload_merges_dirty_runs){
+	make_test_gl_context();
+	TestWorld world(random_rows(80, 32, 4));
+	FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	int slot_floats = 12 * 2; //positions and uvs
+
+	TileMesh mesh;
+	build_mesh(mesh, map, layer);
+	mesh.upload();
+	CHECK(mesh.uploaded_ranges == 0);
+	CHECK(mesh.uploaded_floats == 80 * 32 * slot_floats);
+
+	//A row of three (a door) is one range, editing one of them twice doesn't add to it
+	mesh.set_tile(layer, 10, 5, 7);
+	mesh.set_tile(layer, 11, 5, 7);
+	mesh.set_tile(layer, 12, 5, 7);
+	mesh.set_tile(layer, 11, 5, 0);
+	mesh.upload();
+	CHECK(mesh.uploaded_ranges == 1);
+	CHECK(mesh.uploaded_floats == 3 * slot_floats);
+
+	//Chunks apart, so separate ranges; given out of order
+	mesh.set_tile(layer, 40, 20, 3);
+	mesh.set_tile(layer, 10, 5, 3);
+	mesh.set_tile(layer, 41, 20, 3);
+	mesh.upload();
+	CHECK(mesh.uploaded_ranges == 2);
+	CHECK(mesh.uploaded_floats == 3 * slot_floats);
+
+	//Nothing changed, nothing sent
+	mesh.upload();
+	CHECK(mesh.uploaded_ranges == 0);
+	CHECK(mesh.uploaded_floats == 0);
+
+	//Past max_upload_runs one range spans first to last. Every other tile of
+	//the first chunk's rows 1 to 5, its slots run row by row within the chunk.
+	CHECK(mesh.chunk_tiles == 16);
+	for (int i = 0; i <= mesh.max_upload_runs; i++){
+		mesh.set_tile(layer, 2 * (i % 8), 1 + i / 8, 9);
+	}
+	mesh.upload();
+	CHECK(mesh.uploaded_ranges == 1);
+	CHECK(mesh.uploaded_floats == (2 * mesh.max_upload_runs + 1) * slot_floats);
+}
@@ -0,0 +1,216 @@
+#include "Test.h"
+#include "TestWorld.h"
+#include "../NYUCodebase/TileRaycast.h"
+#include <thread>
+
+//Tile 0.18. A pillar tile at column 4, row 3 in a closed box.
+static std::vector<std::string> box_rows(){
+	std::vector<std::string> rows;
+	rows.push_back("##########");
+	rows.push_back("#........#");
+	rows.push_back("#........#");
+	rows.push_back("#...#....#");
+	rows.push_back("#........#");
+	rows.push_back("##########");
+	return rows;
+}
+
+//A ray from a point given in tiles (column, row from the top)
+static TileRay tile_ray(float tile, float column, float row, float direction_x, float direction_y, float max_distance = 100.0f){
+	TileRay ray = { column * tile, -row * tile, direction_x, direction_y, max_distance };
+	return ray;
+}
+
+static void check_hit(const TileHit& hit, int tile_x, int tile_y, float distance, float normal_x, float normal_y){
+	CHECK(hit.hit);
+	CHECK(hit.tile_x == tile_x && hit.tile_y == tile_y);
+	CHECK(hit.tile == 1);
+	CHECK_NEAR(hit.distance, distance, 1e-5);
+	CHECK(hit.normal_x == normal_x && hit.normal_y == normal_y);
+}
+
+TEST(raycast_axis_aligned_hits){
+	TestWorld world(box_rows());
+	const FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	//Right into the pillar's left face
+	TileHit hit = TileRaycast::cast(map, layer, tile, tile_ray(tile, 2.5f, 3.5f, 1, 0));
+	check_hit(hit, 4, 3, 1.5f * tile, -1, 0);
+	CHECK_NEAR(hit.x, 4 * tile, 1e-5);
+	CHECK_NEAR(hit.y, -3.5f * tile, 1e-5);
+
+	//Down onto the floor, its normal points up in world space
+	check_hit(TileRaycast::cast(map, layer, tile, tile_ray(tile, 2.5f, 1.5f, 0, -1)), 2, 5, 3.5f * tile, 0, 1);
+	//Up into the ceiling, left into the wall
+	check_hit(TileRaycast::cast(map, layer, tile, tile_ray(tile, 6.5f, 3.5f, 0, 1)), 6, 0, 2.5f * tile, 0, -1);
+	check_hit(TileRaycast::cast(map, layer, tile, tile_ray(tile, 3.5f, 2.5f, -2, 0)), 0, 2, 2.5f * tile, 1, 0);
+
+	//Stopping short of the wall is a miss
+	CHECK(!TileRaycast::cast(map, layer, tile, tile_ray(tile, 2.5f, 3.5f, 1, 0, 1.4f * tile)).hit);
+	CHECK(TileRaycast::cast(map, layer, tile, tile_ray(tile, 2.5f, 3.5f, 1, 0, 1.6f * tile)).hit);
+	//No direction, no hit
+	CHECK(!TileRaycast::cast(map, layer, tile, tile_ray(tile, 2.5f, 3.5f, 0, 0)).hit);
+}
+
+TEST(raycast_diagonal_hits){
+	TestWorld world(box_rows());
+	const FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+	float root2 = sqrtf(2.0f);
+
+	//Down and right: crosses x = 2, y = 2, x = 3, y = 3, then x = 4 into the pillar
+	TileHit hit = TileRaycast::cast(map, layer, tile, tile_ray(tile, 1.5f, 1.25f, 1, -1));
+	check_hit(hit, 4, 3, 2.5f * root2 * tile, -1, 0);
+	CHECK_NEAR(hit.x, 4 * tile, 1e-5);
+	CHECK_NEAR(hit.y, -3.75f * tile, 1e-5);
+
+	//Up and left from under the pillar: crosses x = 5, then y = 4 into the pillar's bottom
+	hit = TileRaycast::cast(map, layer, tile, tile_ray(tile, 5.25f, 4.5f, -1, 1));
+	check_hit(hit, 4, 3, 0.5f * root2 * tile, 0, -1);
+
+	//Shallow ray climbing along the floor ends in the right wall
+	hit = TileRaycast::cast(map, layer, tile, tile_ray(tile, 1.5f, 4.9f, 4, 0.05f));
+	CHECK(hit.hit && hit.tile_x == 9 && hit.tile_y == 4);
+	CHECK(hit.normal_x == -1 && hit.normal_y == 0);
+	CHECK_NEAR(hit.x, 9 * tile, 1e-5);
+}
+
+//Starting inside a solid tile hits it straight away, with no face to give a normal
+TEST(raycast_starting_inside_a_solid_tile){
+	TestWorld world(box_rows());
+	const FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	float directions[] = { 1, 0, -1, 0, 0, 1, 0, -1, 1, 1, -1, -1 };
+	for (int i = 0; i < 6; i++){
+		TileHit hit = TileRaycast::cast(map, layer, tile, tile_ray(tile, 4.3f, 3.6f, directions[i * 2], directions[i * 2 + 1]));
+		check_hit(hit, 4, 3, 0, 0, 0);
+		CHECK(hit.x == 4.3f * tile && hit.y == -3.6f * tile);
+	}
+	CHECK(!TileRaycast::line_of_sight(map, layer, tile, 4.3f * tile, -3.6f * tile, 2.5f * tile, -2.5f * tile));
+}
+
+//Outside the map is empty: rays come in through the edge, or miss when they never reach it
+TEST(raycast_starting_outside_the_map){
+	TestWorld world(box_rows());
+	const FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	check_hit(TileRaycast::cast(map, layer, tile, tile_ray(tile, -3.5f, 2.5f, 1, 0)), 0, 2, 3.5f * tile, -1, 0);
+	check_hit(TileRaycast::cast(map, layer, tile, tile_ray(tile, 13.5f, 2.5f, -1, 0)), 9, 2, 3.5f * tile, 1, 0);
+	check_hit(TileRaycast::cast(map, layer, tile, tile_ray(tile, 3.5f, -2.5f, 0, -1)), 3, 0, 2.5f * tile, 0, 1);
+	check_hit(TileRaycast::cast(map, layer, tile, tile_ray(tile, 3.5f, 8.5f, 0, 1)), 3, 5, 2.5f * tile, 0, -1);
+	//In across the top left corner on the diagonal
+	TileHit hit = TileRaycast::cast(map, layer, tile, tile_ray(tile, -2.0f, -1.5f, 1, -1));
+	CHECK(hit.hit && hit.tile_x == 0 && hit.tile_y == 0);
+
+	//Heading away, or passing by
+	CHECK(!TileRaycast::cast(map, layer, tile, tile_ray(tile, -3.5f, 2.5f, -1, 0)).hit);
+	CHECK(!TileRaycast::cast(map, layer, tile, tile_ray(tile, 3.5f, -2.5f, 0, 1)).hit);
+	CHECK(!TileRaycast::cast(map, layer, tile, tile_ray(tile, -3.5f, -1.5f, 1, 0)).hit);
+	CHECK(!TileRaycast::cast(map, layer, tile, tile_ray(tile, -3.5f, 8.5f, 1, 0.01f)).hit);
+}
+
+//Random open level with platforms, rays from anywhere on it
+static std::vector<std::string> platform_rows(int width, int height, int platforms){
+	std::vector<std::string> rows(height, std::string(width, '.'));
+	for (int i = 0; i < platforms; i++){
+		int x = rand() % (width - 12);
+		int y = rand() % (height - 2);
+		int length = 2 + rand() % 10;
+		for (int j = 0; j < length; j++){
+			rows[y][x + j] = '#';
+		}
+	}
+	rows[height - 1] = std::string(width, '#');
+	return rows;
+}
+
+static std::vector<TileRay> random_rays(int count, int width, int height, float tile, float max_distance){
+	std::vector<TileRay> rays(count);
+	for (int i = 0; i < count; i++){
+		float angle = (rand() % 6283) / 1000.0f;
+		rays[i] = tile_ray(tile, (rand() % (width * 100)) / 100.0f, (rand() % (height * 100)) / 100.0f, cosf(angle), sinf(angle), max_distance);
+	}
+	return rays;
+}
+
+static bool same_hit(const TileHit& a, const TileHit& b){
+	return a.hit == b.hit && a.tile_x == b.tile_x && a.tile_y == b.tile_y && a.tile == b.tile && a.distance == b.distance &&
+		a.x == b.x && a.y == b.y && a.normal_x == b.normal_x && a.normal_y == b.normal_y;
+}
+
+//Split across workers in small chunks, every ray still gets exactly its own answer
+TEST(raycast_batches_match_single_casts){
+	srand(21);
+	TestWorld world(platform_rows(200, 60, 300), 3);
+	const FlareMap& map = *world.app->map;
+	int layer = world.app->collision_layer;
+	float tile = world.app->tile_world_size;
+
+	int saved_chunk_size = TileRaycast::batch_chunk_size;
+	TileRaycast::batch_chunk_size = 64;
+	int hits = 0;
+	int origins[] = { 0, 0, 37, 12 };
+	for (int o = 0; o < 2; o++){
+		std::vector<TileRay> rays = random_rays(5000, 200 - origins[o * 2], 60 - origins[o * 2 + 1], tile, 6.0f);
+		std::vector<TileHit> batched(rays.size());
+		TileRaycast::cast(map, layer, tile, rays.data(), rays.size(), batched.data(), world.app->jobs, origins[o * 2], origins[o * 2 + 1]);
+
+		int mismatches = 0;
+		for (int i = 0; i < rays.size(); i++){
+			TileHit single = TileRaycast::cast(map, layer, tile, rays[i], origins[o * 2], origins[o * 2 + 1]);
+			mismatches += !same_hit(single, batched[i]);
+			hits += single.hit;
+		}
+		CHECK(mismatches == 0);
+	}
+	CHECK(hits > 1000);
+	TileRaycast::batch_chunk_size = saved_chunk_size;
+}
+
+//Sight checks for a crowd: thousands of rays a tick, one at a time against batched on the pool
+BENCHMARK(raycasts_per_tick){
+	srand(8);
+	std::vector<std::string> rows = platform_rows(1024, 128, 3000);
+	int rays_per_tick = 4096;
+	int ticks = 100;
+
+	int worker_counts[] = { -1, 0, 1, 3 };
+	for (int w = 0; w < 4; w++){
+		TestWorld world(rows, worker_counts[w] < 0 ? 0 : worker_counts[w]);
+		const FlareMap& map = *world.app->map;
+		int layer = world.app->collision_layer;
+		float tile = world.app->tile_world_size;
+		std::vector<TileRay> rays = random_rays(rays_per_tick, 1024, 128, tile, 6.0f);
+		std::vector<TileHit> hits(rays.size());
+
+		int hit_count = 0;
+		double start = bench_seconds();
+		for (int tick = 0; tick < ticks; tick++){
+			if (worker_counts[w] < 0){
+				for (int i = 0; i < rays.size(); i++){
+					hits[i] = TileRaycast::cast(map, layer, tile, rays[i]);
+				}
+			}
+			else{
+				TileRaycast::cast(map, layer, tile, rays.data(), rays.size(), hits.data(), world.app->jobs);
+			}
+			hit_count += hits[tick].hit;
+		}
+		double ms = (bench_seconds() - start) * 1000.0 / ticks;
+
+		if (worker_counts[w] < 0){
+			std::cout << "  one at a time: " << ms << " ms/tick" << std::endl;
+		}
+		else{
+			std::cout << "  batched, " << worker_counts[w] << " workers: " << ms << " ms/tick" << std::endl;
+		}
+	}
+	std::cout << "  " << rays_per_tick << " rays of 6 units a tick, " << std::thread::hardware_concurrency() << " cores" << std::endl;
+}
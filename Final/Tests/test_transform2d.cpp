@@ -0,0 +1,80 @@
+#include "Test.h"
+#include "../NYUCodebase/Transform2D.h"
+#include <cstdlib>
+
+static bool same_matrix(const Matrix& a, const Matrix& b){
+	for (int i = 0; i < 4; i++){
+		for (int j = 0; j < 4; j++){
+			if (a.m[i][j] != b.m[i][j]){
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static float random_float(float range){
+	return ((rand() % 20001) / 10000.0f - 1.0f) * range;
+}
+
+//The Identity/Translate/SetScale sequences the draw paths used before Transform2D
+TEST(transform2d_matches_the_old_matrix_sequences){
+	srand(30);
+	for (int i = 0; i < 1000; i++){
+		float x = random_float(500.0f);
+		float y = random_float(500.0f);
+		float z = random_float(1.0f);
+
+		//Sprite::draw and shape GameObjects
+		Matrix old_translate;
+		old_translate.Identity();
+		old_translate.Translate(x, y, z);
+		CHECK(same_matrix(Transform2D::translate(x, y).to_matrix(z), old_translate));
+
+		//Textured GameObjects, facing either way
+		for (int direction = -1; direction <= 1; direction += 2){
+			Matrix old_flip;
+			old_flip.Identity();
+			old_flip.Translate(x, y, z);
+			old_flip.SetScale(direction, 1, 1);
+			Transform2D transform = Transform2D::flip(direction) * Transform2D::translate(x, y);
+			CHECK(same_matrix(transform.to_matrix(z), old_flip));
+		}
+
+		float radians = random_float(6.3f);
+		Matrix old_rotate;
+		old_rotate.Identity();
+		old_rotate.SetRotation(radians);
+		Matrix rotate = Transform2D::rotate(radians).to_matrix();
+		for (int r = 0; r < 4; r++){
+			for (int c = 0; c < 4; c++){
+				CHECK_NEAR(rotate.m[r][c], old_rotate.m[r][c], 0.000001f);
+			}
+		}
+	}
+}
+
+//a * b applies a first, like Matrix, and apply() agrees with the expanded matrix
+TEST(transform2d_composes_in_matrix_order){
+	srand(31);
+	for (int i = 0; i < 1000; i++){
+		Transform2D a = Transform2D::scale(random_float(4.0f), random_float(4.0f)) * Transform2D::rotate(random_float(6.3f));
+		Transform2D b = Transform2D::rotate(random_float(6.3f)) * Transform2D::translate(random_float(50.0f), random_float(50.0f));
+
+		Matrix expected = a.to_matrix() * b.to_matrix();
+		Matrix composed = (a * b).to_matrix();
+		for (int r = 0; r < 4; r++){
+			for (int c = 0; c < 4; c++){
+				CHECK_NEAR(composed.m[r][c], expected.m[r][c], 0.0001f);
+			}
+		}
+
+		float x = random_float(10.0f);
+		float y = random_float(10.0f);
+		float mid_x, mid_y, out_x, out_y;
+		a.apply(x, y, &mid_x, &mid_y);
+		b.apply(mid_x, mid_y, &out_x, &out_y);
+		CHECK_NEAR(out_x, x * expected.m[0][0] + y * expected.m[1][0] + expected.m[3][0], 0.001f);
+		CHECK_NEAR(out_y, x * expected.m[0][1] + y * expected.m[1][1] + expected.m[3][1], 0.001f);
+	}
+}
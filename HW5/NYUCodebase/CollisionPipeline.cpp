@@ -0,0 +1,176 @@
+#include "CollisionPipeline.h"
+#include "SatCollision.h"
+#include <algorithm>
+
+CollisionPipeline::~CollisionPipeline() {
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quitting = true;
+	}
+	work_ready.notify_all();
+	for (int t = 0; t < workers.size(); t++) {
+		workers[t].join();
+	}
+}
+
+void CollisionPipeline::begin(int object_count) {
+	hulls.resize(object_count);
+	for (int i = 0; i < object_count; i++) {
+		hulls[i].points.clear();
+	}
+}
+
+void CollisionPipeline::update_bounds(int index) {
+	CollisionHull &hull = hulls[index];
+	if (hull.points.empty()) {
+		hull.min_x = hull.min_y = hull.max_x = hull.max_y = 0;
+		return;
+	}
+
+	hull.min_x = hull.max_x = hull.points[0].first;
+	hull.min_y = hull.max_y = hull.points[0].second;
+	for (int i = 1; i < hull.points.size(); i++) {
+		hull.min_x = std::min(hull.min_x, hull.points[i].first);
+		hull.max_x = std::max(hull.max_x, hull.points[i].first);
+		hull.min_y = std::min(hull.min_y, hull.points[i].second);
+		hull.max_y = std::max(hull.max_y, hull.points[i].second);
+	}
+}
+
+void CollisionPipeline::run() {
+	broad_phase();
+	narrow_phase();
+}
+
+std::pair<float, float> CollisionPipeline::push_out(const CollisionResult &result, int index) const {
+	//penetration points from b towards a
+	if (index == result.a) {
+		return result.penetration;
+	}
+	return std::make_pair(-result.penetration.first, -result.penetration.second);
+}
+
+void CollisionPipeline::broad_phase() {
+	candidate_pairs.clear();
+
+	sorted.resize(hulls.size());
+	for (int i = 0; i < sorted.size(); i++) {
+		sorted[i] = i;
+	}
+
+	const std::vector<CollisionHull> &h = hulls;
+	std::sort(sorted.begin(), sorted.end(), [&h](int i1, int i2) {
+		if (h[i1].min_x == h[i2].min_x) {
+			return i1 < i2;
+		}
+		return h[i1].min_x < h[i2].min_x;
+	});
+
+	//Everything after i in sorted order starts at or right of i's left edge,
+	//so stop as soon as one starts past i's right edge
+	for (int i = 0; i < sorted.size(); i++) {
+		const CollisionHull &e1 = hulls[sorted[i]];
+		if (e1.points.empty()) {
+			continue;
+		}
+
+		for (int j = i + 1; j < sorted.size(); j++) {
+			const CollisionHull &e2 = hulls[sorted[j]];
+			if (e2.min_x > e1.max_x) {
+				break;
+			}
+
+			if (e2.points.empty() || e2.max_y < e1.min_y || e2.min_y > e1.max_y) {
+				continue;
+			}
+
+			candidate_pairs.push_back(std::make_pair(std::min(sorted[i], sorted[j]), std::max(sorted[i], sorted[j])));
+		}
+	}
+}
+
+void CollisionPipeline::narrow_phase() {
+	results.clear();
+
+	int threads = thread_count;
+	if (threads <= 0) {
+		threads = std::max(1, (int)std::thread::hardware_concurrency());
+	}
+	threads = std::min(threads, (int)candidate_pairs.size() / min_pairs_per_thread);
+
+	if (threads <= 1) {
+		test_pairs(0, candidate_pairs.size(), results);
+		return;
+	}
+
+	//Each thread gets a contiguous slice and its own output so the merged
+	//results come out in candidate order no matter how many threads ran
+	thread_results.resize(threads);
+	while (workers.size() < threads - 1) {
+		workers.push_back(std::thread(&CollisionPipeline::worker_loop, this, (int)workers.size() + 1));
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		active_threads = threads;
+		per_thread = (candidate_pairs.size() + threads - 1) / threads;
+		pending = threads - 1;
+		generation++;
+	}
+	work_ready.notify_all();
+
+	test_slice(0);
+
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		work_done.wait(guard, [this] { return pending == 0; });
+	}
+
+	for (int t = 0; t < threads; t++) {
+		results.insert(results.end(), thread_results[t].begin(), thread_results[t].end());
+	}
+}
+
+void CollisionPipeline::test_slice(int t) {
+	int begin = std::min((int)candidate_pairs.size(), t * per_thread);
+	int end = std::min((int)candidate_pairs.size(), begin + per_thread);
+	thread_results[t].clear();
+	test_pairs(begin, end, thread_results[t]);
+}
+
+//Sleeps between ticks, wakes up for each narrow phase that has a slice for it
+void CollisionPipeline::worker_loop(int t) {
+	int seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			work_ready.wait(guard, [this, seen] { return quitting || generation != seen; });
+			if (quitting) {
+				return;
+			}
+			seen = generation;
+			if (t >= active_threads) {
+				continue;
+			}
+		}
+
+		test_slice(t);
+
+		std::lock_guard<std::mutex> guard(lock);
+		pending--;
+		if (pending == 0) {
+			work_done.notify_one();
+		}
+	}
+}
+
+void CollisionPipeline::test_pairs(int begin, int end, std::vector<CollisionResult> &out) {
+	for (int i = begin; i < end; i++) {
+		CollisionResult result;
+		result.a = candidate_pairs[i].first;
+		result.b = candidate_pairs[i].second;
+		if (CheckSATCollision(hulls[result.a].points, hulls[result.b].points, result.penetration)) {
+			out.push_back(result);
+		}
+	}
+}
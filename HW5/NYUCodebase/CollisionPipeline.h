@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//World space hull of one object, transformed once per tick
+struct CollisionHull {
+	std::vector<std::pair<float, float>> points;
+	float min_x;
+	float min_y;
+	float max_x;
+	float max_y;
+};
+
+//One colliding pair, a < b. penetration pushes a away from b.
+struct CollisionResult {
+	int a;
+	int b;
+	std::pair<float, float> penetration;
+};
+
+//Sort and sweep broad phase on the hull AABBs, then SAT on the unique
+//candidate pairs, split across threads when there are enough of them.
+//The worker threads are started the first time they're needed and kept for the next ticks.
+class CollisionPipeline {
+public:
+	CollisionPipeline() {}
+	~CollisionPipeline();
+	CollisionPipeline(const CollisionPipeline&) = delete;
+	CollisionPipeline& operator=(const CollisionPipeline&) = delete;
+
+	std::vector<CollisionHull> hulls;
+	std::vector<std::pair<int, int>> candidate_pairs;
+	std::vector<CollisionResult> results;
+
+	//Candidate pairs below this count are tested on the calling thread
+	int min_pairs_per_thread = 128;
+	int thread_count = 0; //0 = use every core
+
+	//Keeps the hull buffers (and their capacity) around between ticks
+	void begin(int object_count);
+
+	//Call after filling hulls[index].points
+	void update_bounds(int index);
+
+	void run();
+
+	//How far to move object index (result.a or result.b) so it stops overlapping the other one
+	std::pair<float, float> push_out(const CollisionResult &result, int index) const;
+
+private:
+	std::vector<int> sorted;
+	std::vector<std::vector<CollisionResult>> thread_results;
+
+	//Worker t tests slice t of the current tick; slice 0 runs on the calling thread
+	std::vector<std::thread> workers;
+	std::mutex lock;
+	std::condition_variable work_ready;
+	std::condition_variable work_done;
+	int generation = 0;
+	int active_threads = 0;
+	int per_thread = 0;
+	int pending = 0;
+	bool quitting = false;
+
+	void broad_phase();
+	void narrow_phase();
+	void test_pairs(int begin, int end, std::vector<CollisionResult>& out);
+	void test_slice(int t);
+	void worker_loop(int t);
+};
@@ -1,6 +1,12 @@
 
 #pragma once
 
+//SSE is used when the compiler targets it (x64, /arch:SSE or higher, -msse),
+//otherwise everything falls back to the scalar code.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define MATRIX_USE_SSE
+#endif
+
 class Matrix {
     public:
     
@@ -14,6 +20,10 @@ class Matrix {
         void Identity();
         Matrix operator * (const Matrix &m2) const;
         Matrix Inverse() const;
+
+        //Same math as Vector3 * Matrix (upper 3x3 only, no translation) for count
+        //packed x,y,z triples. in and out may be the same array.
+        void TransformVectors(const float *in, float *out, int count) const;
     
         void Translate(float x, float y, float z);
         void Scale(float x, float y, float z);
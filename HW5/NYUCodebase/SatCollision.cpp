@@ -1,31 +1,92 @@
 #include "SatCollision.h"
 #include <math.h>
-#include <algorithm>
+#include <float.h>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define SAT_USE_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#include <xmmintrin.h>
+	#define SAT_USE_SSE
+#endif
+
+//The projections read the points as a flat x,y,x,y... float array
+static_assert(sizeof(std::pair<float, float>) == 2 * sizeof(float), "std::pair<float, float> must be two packed floats");
+
+//Finds the min and max of the points projected onto (normalX, normalY) without storing the projections
+void ProjectPoints(const std::pair<float, float> *points, int count, float normalX, float normalY, float &outMin, float &outMax) {
+	const float *p = reinterpret_cast<const float*>(points);
+	float minValue = FLT_MAX;
+	float maxValue = -FLT_MAX;
+	int i = 0;
+
+#if defined(SAT_USE_AVX)
+	//8 vertices per iteration, 4 per register
+	if (count >= 8) {
+		__m256 normal = _mm256_setr_ps(normalX, normalY, normalX, normalY, normalX, normalY, normalX, normalY);
+		__m256 minV = _mm256_set1_ps(FLT_MAX);
+		__m256 maxV = _mm256_set1_ps(-FLT_MAX);
+		for (; i + 8 <= count; i += 8) {
+			__m256 a = _mm256_mul_ps(_mm256_loadu_ps(p + i * 2), normal);
+			__m256 b = _mm256_mul_ps(_mm256_loadu_ps(p + i * 2 + 8), normal);
+			//x*nx + y*ny for each point; lane order doesn't matter for min/max
+			__m256 dots = _mm256_add_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+			minV = _mm256_min_ps(minV, dots);
+			maxV = _mm256_max_ps(maxV, dots);
+		}
+		float mins[8], maxs[8];
+		_mm256_storeu_ps(mins, minV);
+		_mm256_storeu_ps(maxs, maxV);
+		for (int j = 0; j < 8; j++) {
+			minValue = mins[j] < minValue ? mins[j] : minValue;
+			maxValue = maxs[j] > maxValue ? maxs[j] : maxValue;
+		}
+	}
+#endif
+
+#if defined(SAT_USE_AVX) || defined(SAT_USE_SSE)
+	//4 vertices per iteration, 2 per register
+	if (count - i >= 4) {
+		__m128 normal = _mm_setr_ps(normalX, normalY, normalX, normalY);
+		__m128 minV = _mm_set1_ps(FLT_MAX);
+		__m128 maxV = _mm_set1_ps(-FLT_MAX);
+		for (; i + 4 <= count; i += 4) {
+			__m128 a = _mm_mul_ps(_mm_loadu_ps(p + i * 2), normal);
+			__m128 b = _mm_mul_ps(_mm_loadu_ps(p + i * 2 + 4), normal);
+			__m128 dots = _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+			minV = _mm_min_ps(minV, dots);
+			maxV = _mm_max_ps(maxV, dots);
+		}
+		float mins[4], maxs[4];
+		_mm_storeu_ps(mins, minV);
+		_mm_storeu_ps(maxs, maxV);
+		for (int j = 0; j < 4; j++) {
+			minValue = mins[j] < minValue ? mins[j] : minValue;
+			maxValue = maxs[j] > maxValue ? maxs[j] : maxValue;
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		float projected = p[i * 2] * normalX + p[i * 2 + 1] * normalY;
+		minValue = projected < minValue ? projected : minValue;
+		maxValue = projected > maxValue ? projected : maxValue;
+	}
+
+	outMin = minValue;
+	outMax = maxValue;
+}
 
-bool TestSATSeparationForEdge(float edgeX, float edgeY, const std::vector<std::pair<float, float>> &points1, const std::vector<std::pair<float, float>> &points2, std::pair<float, float> &penetration) {
+bool TestSATSeparationForEdge(float edgeX, float edgeY, const std::pair<float, float> *points1, int count1, const std::pair<float, float> *points2, int count2, std::pair<float, float> &penetration) {
 	float normalX = -edgeY;
 	float normalY = edgeX;
 	float len = sqrtf(normalX*normalX + normalY*normalY);
 	normalX /= len;
 	normalY /= len;
 
-	std::vector<float> e1Projected;
-	std::vector<float> e2Projected;
-
-	for (int i = 0; i < points1.size(); i++) {
-		e1Projected.push_back(points1[i].first * normalX + points1[i].second * normalY);
-	}
-	for (int i = 0; i < points2.size(); i++) {
-		e2Projected.push_back(points2[i].first * normalX + points2[i].second * normalY);
-	}
-
-	std::sort(e1Projected.begin(), e1Projected.end());
-	std::sort(e2Projected.begin(), e2Projected.end());
-
-	float e1Min = e1Projected[0];
-	float e1Max = e1Projected[e1Projected.size() - 1];
-	float e2Min = e2Projected[0];
-	float e2Max = e2Projected[e2Projected.size() - 1];
+	float e1Min, e1Max, e2Min, e2Max;
+	ProjectPoints(points1, count1, normalX, normalY, e1Min, e1Max);
+	ProjectPoints(points2, count2, normalX, normalY, e2Min, e2Max);
 
 	float e1Width = fabs(e1Max - e1Min);
 	float e2Width = fabs(e2Max - e2Min);
@@ -52,68 +113,55 @@ bool TestSATSeparationForEdge(float edgeX, float edgeY, const std::vector<std::p
 	return true;
 }
 
-bool PenetrationSort(const std::pair<float, float> &p1, const std::pair<float, float> &p2) {
-	return sqrtf(p1.first*p1.first + p1.second*p1.second) < sqrtf(p2.first*p2.first + p2.second*p2.second);
-}
-
-bool CheckSATCollision(const std::vector<std::pair<float, float>> &e1Points, const std::vector<std::pair<float, float>> &e2Points, std::pair<float, float> &penetration) {
-	std::vector<std::pair<float, float>> penetrations;
-	for (int i = 0; i < e1Points.size(); i++) {
-		float edgeX, edgeY;
+//Tests every edge of edgePoints, keeping the shortest penetration seen so far (compared squared)
+bool TestSATSeparationForEdges(const std::pair<float, float> *edgePoints, int edgeCount, const std::pair<float, float> *e1Points, int e1Count, const std::pair<float, float> *e2Points, int e2Count, std::pair<float, float> &best, float &bestLengthSquared) {
+	for (int i = 0; i < edgeCount; i++) {
+		int next = (i == edgeCount - 1) ? 0 : i + 1;
+		float edgeX = edgePoints[next].first - edgePoints[i].first;
+		float edgeY = edgePoints[next].second - edgePoints[i].second;
 
-		if (i == e1Points.size() - 1) {
-			edgeX = e1Points[0].first - e1Points[i].first;
-			edgeY = e1Points[0].second - e1Points[i].second;
-		}
-		else {
-			edgeX = e1Points[i + 1].first - e1Points[i].first;
-			edgeY = e1Points[i + 1].second - e1Points[i].second;
-		}
 		std::pair<float, float> penetration;
-		bool result = TestSATSeparationForEdge(edgeX, edgeY, e1Points, e2Points, penetration);
-		if (!result) {
+		if (!TestSATSeparationForEdge(edgeX, edgeY, e1Points, e1Count, e2Points, e2Count, penetration)) {
 			return false;
 		}
-		penetrations.push_back(penetration);
-	}
-	for (int i = 0; i < e2Points.size(); i++) {
-		float edgeX, edgeY;
 
-		if (i == e2Points.size() - 1) {
-			edgeX = e2Points[0].first - e2Points[i].first;
-			edgeY = e2Points[0].second - e2Points[i].second;
-		}
-		else {
-			edgeX = e2Points[i + 1].first - e2Points[i].first;
-			edgeY = e2Points[i + 1].second - e2Points[i].second;
+		float lengthSquared = penetration.first*penetration.first + penetration.second*penetration.second;
+		if (lengthSquared < bestLengthSquared) {
+			bestLengthSquared = lengthSquared;
+			best = penetration;
 		}
-		std::pair<float, float> penetration;
-		bool result = TestSATSeparationForEdge(edgeX, edgeY, e1Points, e2Points, penetration);
+	}
+	return true;
+}
 
-		if (!result) {
-			return false;
-		}
-		penetrations.push_back(penetration);
+bool CheckSATCollision(const std::pair<float, float> *e1Points, int e1Count, const std::pair<float, float> *e2Points, int e2Count, std::pair<float, float> &penetration) {
+	if (e1Count == 0 || e2Count == 0) {
+		return false;
 	}
 
-	std::sort(penetrations.begin(), penetrations.end(), PenetrationSort);
-	penetration = penetrations[0];
+	float bestLengthSquared = FLT_MAX;
+	if (!TestSATSeparationForEdges(e1Points, e1Count, e1Points, e1Count, e2Points, e2Count, penetration, bestLengthSquared)) {
+		return false;
+	}
+	if (!TestSATSeparationForEdges(e2Points, e2Count, e1Points, e1Count, e2Points, e2Count, penetration, bestLengthSquared)) {
+		return false;
+	}
 
-	std::pair<float, float> e1Center;
-	for (int i = 0; i < e1Points.size(); i++) {
+	std::pair<float, float> e1Center(0.0f, 0.0f);
+	for (int i = 0; i < e1Count; i++) {
 		e1Center.first += e1Points[i].first;
 		e1Center.second += e1Points[i].second;
 	}
-	e1Center.first /= (float)e1Points.size();
-	e1Center.second /= (float)e1Points.size();
+	e1Center.first /= (float)e1Count;
+	e1Center.second /= (float)e1Count;
 
-	std::pair<float, float> e2Center;
-	for (int i = 0; i < e2Points.size(); i++) {
+	std::pair<float, float> e2Center(0.0f, 0.0f);
+	for (int i = 0; i < e2Count; i++) {
 		e2Center.first += e2Points[i].first;
 		e2Center.second += e2Points[i].second;
 	}
-	e2Center.first /= (float)e2Points.size();
-	e2Center.second /= (float)e2Points.size();
+	e2Center.first /= (float)e2Count;
+	e2Center.second /= (float)e2Count;
 
 	std::pair<float, float> ba;
 	ba.first = e1Center.first - e2Center.first;
@@ -125,4 +173,11 @@ bool CheckSATCollision(const std::vector<std::pair<float, float>> &e1Points, con
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+bool CheckSATCollision(const std::vector<std::pair<float, float>> &e1Points, const std::vector<std::pair<float, float>> &e2Points, std::pair<float, float> &penetration) {
+	if (e1Points.empty() || e2Points.empty()) {
+		return false;
+	}
+	return CheckSATCollision(&e1Points[0], e1Points.size(), &e2Points[0], e2Points.size(), penetration);
+}
@@ -1,4 +1,7 @@
 #include <vector>
 #include <utility>
 
-bool CheckSATCollision(const std::vector<std::pair<float, float>> &e1Points, const std::vector<std::pair<float, float>> &e2Points, std::pair<float, float> &penetration);
\ No newline at end of file
+bool CheckSATCollision(const std::vector<std::pair<float, float>> &e1Points, const std::vector<std::pair<float, float>> &e2Points, std::pair<float, float> &penetration);
+
+//Same test on raw point arrays. Does not allocate.
+bool CheckSATCollision(const std::pair<float, float> *e1Points, int e1Count, const std::pair<float, float> *e2Points, int e2Count, std::pair<float, float> &penetration);
\ No newline at end of file
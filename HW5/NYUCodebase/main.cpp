@@ -9,6 +9,7 @@
 
 #include "ShaderProgram.h"
 #include "SatCollision.h"
+#include "CollisionPipeline.h"
 #include <vector>
 #include <unordered_map>
 #include <math.h>
@@ -1300,47 +1301,48 @@ public:
 	}
 
 
+	CollisionPipeline collision_pipeline;
+
 	void handle_collisions(){
-		for (int x = 0; x < objects.size(); x++){
-			objects[x]->colliding = false;
-		}
+		collision_pipeline.begin(objects.size());
 
+		//Transform every hull to world space once, not once per pair
 		for (int x = 0; x < objects.size(); x++){
-			for (int y = 0; y < objects.size(); y++){
-				if (x == y){
-					continue; //dont collide with self
-				}
-
-				std::pair<float, float> penetration;
-
-				std::vector<std::pair<float, float>> e1Points;
-				std::vector<std::pair<float, float>> e2Points;
-
-				for (int i = 0; i < objects[x]->get_points().size(); i++) {
-					Vector3 point = objects[x]->get_points()[i] * objects[x]->matrix;
-					e1Points.push_back(std::make_pair(point.x, point.y));
-				}
-
+			objects[x]->colliding = false;
 
-				for (int i = 0; i < objects[y]->get_points().size(); i++) {
-					Vector3 point = objects[y]->get_points()[i] * objects[y]->matrix;
-					e2Points.push_back(std::make_pair(point.x, point.y));
-				}
+			std::vector<Vector3> points = objects[x]->get_points();
+			objects[x]->matrix.TransformVectors(&points[0].x, &points[0].x, points.size());
 
-				bool sat_collided = CheckSATCollision(e1Points, e2Points, penetration);
-				if (sat_collided){
-					objects[x]->colliding = true;
-					objects[y]->colliding = true;
+			CollisionHull& hull = collision_pipeline.hulls[x];
+			for (int i = 0; i < points.size(); i++) {
+				hull.points.push_back(std::make_pair(points[i].x, points[i].y));
+			}
+			collision_pipeline.update_bounds(x);
+		}
 
+		collision_pipeline.run();
+
+		for (int i = 0; i < collision_pipeline.results.size(); i++){
+			CollisionResult& result = collision_pipeline.results[i];
+			GameObject* e1 = objects[result.a];
+			GameObject* e2 = objects[result.b];
+			e1->colliding = true;
+			e2->colliding = true;
+
+			GameObject* mover = NULL;
+			int mover_index = -1;
+			if (e1->id == "1"){
+				mover = e1;
+				mover_index = result.a;
+			} else if (e2->id == "1"){
+				mover = e2;
+				mover_index = result.b;
+			}
 
-					if (objects[x]->id == "1"){
-						objects[x]->pos.x += (penetration.first);
-						objects[x]->pos.y += (penetration.second);
-					} else if (objects[y]->id == "1"){
-						objects[y]->pos.x += (penetration.first);
-						objects[y]->pos.y += (penetration.second);
-					}
-				}
+			if (mover != NULL){
+				std::pair<float, float> push = collision_pipeline.push_out(result, mover_index);
+				mover->pos.x += push.first;
+				mover->pos.y += push.second;
 			}
 		}
 
@@ -0,0 +1,206 @@
+#include "Test.h"
+#include "../NYUCodebase/CollisionPipeline.h"
+#include "../NYUCodebase/SatCollision.h"
+#include <set>
+#include <cstdlib>
+
+static float random_float(float low, float high) {
+	return low + (rand() % 10000) / 10000.0f * (high - low);
+}
+
+//Rotated rectangle, points in winding order like GameObject::get_points
+static std::vector<std::pair<float, float>> box(float x, float y, float half_width, float half_height, float angle) {
+	float corners[4][2] = { { -half_width, -half_height }, { half_width, -half_height }, { half_width, half_height }, { -half_width, half_height } };
+	std::vector<std::pair<float, float>> points;
+	for (int i = 0; i < 4; i++) {
+		float px = corners[i][0] * cosf(angle) - corners[i][1] * sinf(angle);
+		float py = corners[i][0] * sinf(angle) + corners[i][1] * cosf(angle);
+		points.push_back(std::make_pair(x + px, y + py));
+	}
+	return points;
+}
+
+static void fill(CollisionPipeline &pipeline, const std::vector<std::vector<std::pair<float, float>>> &shapes) {
+	pipeline.begin(shapes.size());
+	for (int i = 0; i < shapes.size(); i++) {
+		pipeline.hulls[i].points = shapes[i];
+		pipeline.update_bounds(i);
+	}
+}
+
+static std::vector<std::vector<std::pair<float, float>>> random_scene(int count, float spread) {
+	std::vector<std::vector<std::pair<float, float>>> shapes;
+	for (int i = 0; i < count; i++) {
+		shapes.push_back(box(random_float(-spread, spread), random_float(-spread, spread), random_float(0.05f, 0.4f), random_float(0.05f, 0.4f), random_float(0.0f, 3.14159f)));
+	}
+	return shapes;
+}
+
+static void move(std::vector<std::pair<float, float>> &points, std::pair<float, float> delta) {
+	for (int i = 0; i < points.size(); i++) {
+		points[i].first += delta.first;
+		points[i].second += delta.second;
+	}
+}
+
+//The player used to be pushed into the wall when it was the second object of a pair
+TEST(push_out_moves_the_player_away_in_either_order) {
+	std::vector<std::pair<float, float>> player = box(-0.45f, 0.1f, 0.25f, 0.25f, 0.0f);
+	std::vector<std::pair<float, float>> wall = box(0.0f, 0.0f, 0.25f, 1.0f, 0.0f);
+
+	for (int order = 0; order < 2; order++) {
+		std::vector<std::vector<std::pair<float, float>>> shapes;
+		shapes.push_back(order == 0 ? player : wall);
+		shapes.push_back(order == 0 ? wall : player);
+		int player_index = order;
+
+		CollisionPipeline pipeline;
+		fill(pipeline, shapes);
+		pipeline.run();
+		CHECK(pipeline.results.size() == 1);
+		if (pipeline.results.size() != 1) {
+			continue;
+		}
+
+		std::pair<float, float> push = pipeline.push_out(pipeline.results[0], player_index);
+		//Player is left of the wall, so out is left by the 0.05 overlap
+		CHECK_NEAR(push.first, -0.05f, 1e-4);
+		CHECK_NEAR(push.second, 0.0f, 1e-4);
+
+		std::vector<std::pair<float, float>> moved = player;
+		move(moved, push);
+		std::pair<float, float> remaining;
+		if (CheckSATCollision(moved, wall, remaining)) {
+			CHECK(remaining.first * remaining.first + remaining.second * remaining.second < 1e-8f);
+		}
+	}
+}
+
+//Both objects of every random overlapping pair come apart when pushed
+TEST(push_out_separates_random_pairs) {
+	srand(27);
+	for (int n = 0; n < 2000; n++) {
+		std::vector<std::vector<std::pair<float, float>>> shapes;
+		shapes.push_back(box(random_float(-0.3f, 0.3f), random_float(-0.3f, 0.3f), random_float(0.1f, 0.4f), random_float(0.1f, 0.4f), random_float(0.0f, 3.14159f)));
+		shapes.push_back(box(0.0f, 0.0f, random_float(0.1f, 0.4f), random_float(0.1f, 0.4f), random_float(0.0f, 3.14159f)));
+
+		CollisionPipeline pipeline;
+		fill(pipeline, shapes);
+		pipeline.run();
+		for (int i = 0; i < pipeline.results.size(); i++) {
+			for (int side = 0; side < 2; side++) {
+				int index = side == 0 ? pipeline.results[i].a : pipeline.results[i].b;
+				int other = side == 0 ? pipeline.results[i].b : pipeline.results[i].a;
+
+				std::vector<std::pair<float, float>> moved = shapes[index];
+				move(moved, pipeline.push_out(pipeline.results[i], index));
+				std::pair<float, float> remaining;
+				if (CheckSATCollision(moved, shapes[other], remaining)) {
+					CHECK(remaining.first * remaining.first + remaining.second * remaining.second < 1e-6f);
+				}
+			}
+		}
+	}
+}
+
+//Sort and sweep finds exactly the AABB overlaps, each once with a < b
+TEST(broad_phase_pairs_match_brute_force) {
+	srand(1);
+	int counts[] = { 0, 1, 2, 50, 600 };
+	for (int c = 0; c < 5; c++) {
+		std::vector<std::vector<std::pair<float, float>>> shapes = random_scene(counts[c], 4.0f);
+		CollisionPipeline pipeline;
+		fill(pipeline, shapes);
+		pipeline.run();
+
+		std::set<std::pair<int, int>> expected;
+		for (int a = 0; a < shapes.size(); a++) {
+			for (int b = a + 1; b < shapes.size(); b++) {
+				const CollisionHull &h1 = pipeline.hulls[a];
+				const CollisionHull &h2 = pipeline.hulls[b];
+				if (h1.min_x <= h2.max_x && h2.min_x <= h1.max_x && h1.min_y <= h2.max_y && h2.min_y <= h1.max_y) {
+					expected.insert(std::make_pair(a, b));
+				}
+			}
+		}
+
+		std::set<std::pair<int, int>> found;
+		for (int i = 0; i < pipeline.candidate_pairs.size(); i++) {
+			CHECK(pipeline.candidate_pairs[i].first < pipeline.candidate_pairs[i].second);
+			found.insert(pipeline.candidate_pairs[i]);
+		}
+		CHECK(found.size() == pipeline.candidate_pairs.size());
+		CHECK(found == expected);
+	}
+}
+
+//Threaded narrow phase gives the same results, in the same order, as one thread
+TEST(narrow_phase_is_the_same_on_any_thread_count) {
+	srand(2);
+	std::vector<std::vector<std::pair<float, float>>> shapes = random_scene(3000, 8.0f);
+
+	CollisionPipeline single;
+	single.thread_count = 1;
+	fill(single, shapes);
+	single.run();
+	CHECK(single.candidate_pairs.size() > 4 * single.min_pairs_per_thread);
+
+	int thread_counts[] = { 2, 3, 8 };
+	for (int t = 0; t < 3; t++) {
+		CollisionPipeline threaded;
+		threaded.thread_count = thread_counts[t];
+		fill(threaded, shapes);
+		threaded.run();
+
+		CHECK(threaded.results.size() == single.results.size());
+		for (int i = 0; i < threaded.results.size() && i < single.results.size(); i++) {
+			CHECK(threaded.results[i].a == single.results[i].a && threaded.results[i].b == single.results[i].b);
+			CHECK(threaded.results[i].penetration == single.results[i].penetration);
+		}
+	}
+
+	//Every pair that really collides made it through the broad phase
+	int collisions = 0;
+	for (int a = 0; a < shapes.size(); a++) {
+		for (int b = a + 1; b < shapes.size(); b++) {
+			std::pair<float, float> penetration;
+			if (CheckSATCollision(shapes[a], shapes[b], penetration)) {
+				collisions++;
+			}
+		}
+	}
+	CHECK(collisions == single.results.size());
+}
+
+//All ordered pairs through SAT (the old handle_collisions) against the pipeline
+BENCHMARK(collision_pipeline_against_all_pairs) {
+	srand(3);
+	int counts[] = { 100, 1000, 3000 };
+	for (int c = 0; c < 3; c++) {
+		std::vector<std::vector<std::pair<float, float>>> shapes = random_scene(counts[c], 20.0f);
+
+		double start = bench_seconds();
+		int hits = 0;
+		for (int a = 0; a < shapes.size(); a++) {
+			for (int b = 0; b < shapes.size(); b++) {
+				std::pair<float, float> penetration;
+				if (a != b && CheckSATCollision(shapes[a], shapes[b], penetration)) {
+					hits++;
+				}
+			}
+		}
+		double all_pairs_ms = (bench_seconds() - start) * 1000.0;
+
+		CollisionPipeline pipeline;
+		int runs = 20;
+		start = bench_seconds();
+		for (int r = 0; r < runs; r++) {
+			fill(pipeline, shapes);
+			pipeline.run();
+		}
+		double pipeline_ms = (bench_seconds() - start) * 1000.0 / runs;
+
+		std::cout << "  " << counts[c] << " objects: all pairs " << all_pairs_ms << " ms (" << hits / 2 << " hits), pipeline "
+			<< pipeline_ms << " ms (" << pipeline.candidate_pairs.size() << " candidates, " << pipeline.results.size() << " hits)" << std::endl;
+	}
+}
@@ -0,0 +1,250 @@
+#include "Test.h"
+#include "../NYUCodebase/SatCollision.h"
+#include <algorithm>
+#include <cstdlib>
+
+//The scalar SAT from before the SIMD projection, kept as the reference
+
+static bool ScalarSATSeparationForEdge(float edgeX, float edgeY, const std::vector<std::pair<float, float>> &points1, const std::vector<std::pair<float, float>> &points2, std::pair<float, float> &penetration) {
+	float normalX = -edgeY;
+	float normalY = edgeX;
+	float len = sqrtf(normalX*normalX + normalY*normalY);
+	normalX /= len;
+	normalY /= len;
+
+	std::vector<float> e1Projected;
+	std::vector<float> e2Projected;
+
+	for (int i = 0; i < points1.size(); i++) {
+		e1Projected.push_back(points1[i].first * normalX + points1[i].second * normalY);
+	}
+	for (int i = 0; i < points2.size(); i++) {
+		e2Projected.push_back(points2[i].first * normalX + points2[i].second * normalY);
+	}
+
+	std::sort(e1Projected.begin(), e1Projected.end());
+	std::sort(e2Projected.begin(), e2Projected.end());
+
+	float e1Min = e1Projected[0];
+	float e1Max = e1Projected[e1Projected.size() - 1];
+	float e2Min = e2Projected[0];
+	float e2Max = e2Projected[e2Projected.size() - 1];
+
+	float e1Width = fabs(e1Max - e1Min);
+	float e2Width = fabs(e2Max - e2Min);
+	float e1Center = e1Min + (e1Width / 2.0);
+	float e2Center = e2Min + (e2Width / 2.0);
+	float dist = fabs(e1Center - e2Center);
+	float p = dist - ((e1Width + e2Width) / 2.0);
+
+	if (p >= 0) {
+		return false;
+	}
+
+	float penetrationMin1 = e1Max - e2Min;
+	float penetrationMin2 = e2Max - e1Min;
+
+	float penetrationAmount = penetrationMin1;
+	if (penetrationMin2 < penetrationAmount) {
+		penetrationAmount = penetrationMin2;
+	}
+
+	penetration.first = normalX * penetrationAmount;
+	penetration.second = normalY * penetrationAmount;
+
+	return true;
+}
+
+static bool ScalarPenetrationSort(const std::pair<float, float> &p1, const std::pair<float, float> &p2) {
+	return sqrtf(p1.first*p1.first + p1.second*p1.second) < sqrtf(p2.first*p2.first + p2.second*p2.second);
+}
+
+static bool ScalarSATCollision(const std::vector<std::pair<float, float>> &e1Points, const std::vector<std::pair<float, float>> &e2Points, std::pair<float, float> &penetration) {
+	std::vector<std::pair<float, float>> penetrations;
+	for (int i = 0; i < e1Points.size(); i++) {
+		float edgeX, edgeY;
+
+		if (i == e1Points.size() - 1) {
+			edgeX = e1Points[0].first - e1Points[i].first;
+			edgeY = e1Points[0].second - e1Points[i].second;
+		}
+		else {
+			edgeX = e1Points[i + 1].first - e1Points[i].first;
+			edgeY = e1Points[i + 1].second - e1Points[i].second;
+		}
+		std::pair<float, float> penetration;
+		bool result = ScalarSATSeparationForEdge(edgeX, edgeY, e1Points, e2Points, penetration);
+		if (!result) {
+			return false;
+		}
+		penetrations.push_back(penetration);
+	}
+	for (int i = 0; i < e2Points.size(); i++) {
+		float edgeX, edgeY;
+
+		if (i == e2Points.size() - 1) {
+			edgeX = e2Points[0].first - e2Points[i].first;
+			edgeY = e2Points[0].second - e2Points[i].second;
+		}
+		else {
+			edgeX = e2Points[i + 1].first - e2Points[i].first;
+			edgeY = e2Points[i + 1].second - e2Points[i].second;
+		}
+		std::pair<float, float> penetration;
+		bool result = ScalarSATSeparationForEdge(edgeX, edgeY, e1Points, e2Points, penetration);
+
+		if (!result) {
+			return false;
+		}
+		penetrations.push_back(penetration);
+	}
+
+	std::sort(penetrations.begin(), penetrations.end(), ScalarPenetrationSort);
+	penetration = penetrations[0];
+
+	std::pair<float, float> e1Center;
+	for (int i = 0; i < e1Points.size(); i++) {
+		e1Center.first += e1Points[i].first;
+		e1Center.second += e1Points[i].second;
+	}
+	e1Center.first /= (float)e1Points.size();
+	e1Center.second /= (float)e1Points.size();
+
+	std::pair<float, float> e2Center;
+	for (int i = 0; i < e2Points.size(); i++) {
+		e2Center.first += e2Points[i].first;
+		e2Center.second += e2Points[i].second;
+	}
+	e2Center.first /= (float)e2Points.size();
+	e2Center.second /= (float)e2Points.size();
+
+	std::pair<float, float> ba;
+	ba.first = e1Center.first - e2Center.first;
+	ba.second = e1Center.second - e2Center.second;
+
+	if ((penetration.first * ba.first) + (penetration.second * ba.second) < 0.0f) {
+		penetration.first *= -1.0f;
+		penetration.second *= -1.0f;
+	}
+
+	return true;
+}
+static float random_float(float low, float high) {
+	return low + (rand() % 10000) / 10000.0f * (high - low);
+}
+
+//Convex polygon with points on an ellipse at sorted random angles, CCW
+static std::vector<std::pair<float, float>> random_polygon(int count, float x, float y, float radius) {
+	//Distinct angles, a repeated point makes a zero length edge and a NaN axis
+	std::vector<float> angles;
+	while (angles.size() < count) {
+		angles.push_back(random_float(0.0f, 6.2831853f));
+		std::sort(angles.begin(), angles.end());
+		angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+	}
+
+	float stretch = random_float(0.5f, 1.5f);
+	std::vector<std::pair<float, float>> points;
+	for (int i = 0; i < count; i++) {
+		points.push_back(std::make_pair(x + cosf(angles[i]) * radius * stretch, y + sinf(angles[i]) * radius));
+	}
+	return points;
+}
+
+static float length(std::pair<float, float> v) {
+	return sqrtf(v.first * v.first + v.second * v.second);
+}
+
+//3 to 20 points covers the 8 wide, 4 wide and leftover loops of the projection
+TEST(sat_matches_scalar_reference_on_random_polygons) {
+	srand(28);
+	int collisions = 0;
+	int separated = 0;
+	int tied = 0;
+	for (int n = 0; n < 200000; n++) {
+		std::vector<std::pair<float, float>> e1 = random_polygon(3 + rand() % 18, random_float(-1.0f, 1.0f), random_float(-1.0f, 1.0f), random_float(0.1f, 0.8f));
+		std::vector<std::pair<float, float>> e2 = random_polygon(3 + rand() % 18, random_float(-1.0f, 1.0f), random_float(-1.0f, 1.0f), random_float(0.1f, 0.8f));
+
+		std::pair<float, float> expected;
+		std::pair<float, float> actual;
+		bool expected_hit = ScalarSATCollision(e1, e2, expected);
+		bool actual_hit = CheckSATCollision(e1, e2, actual);
+
+		CHECK(expected_hit == actual_hit);
+		if (!expected_hit || !actual_hit) {
+			separated++;
+			continue;
+		}
+		collisions++;
+
+		//Same shortest axis, unless two axes tie on length (std::sort may pick either)
+		CHECK_NEAR(length(actual), length(expected), 1e-5);
+		if (fabs(actual.first - expected.first) > 1e-5f || fabs(actual.second - expected.second) > 1e-5f) {
+			tied++;
+		}
+	}
+
+	//Both outcomes were exercised, and ties stay rare
+	CHECK(collisions > 10000);
+	CHECK(separated > 10000);
+	CHECK(tied < collisions / 1000);
+}
+
+//Touching and nearly touching boxes, where rounding decides the answer
+TEST(sat_matches_scalar_reference_at_contact) {
+	std::vector<std::pair<float, float>> wall;
+	wall.push_back(std::make_pair(0.0f, -1.0f));
+	wall.push_back(std::make_pair(1.0f, -1.0f));
+	wall.push_back(std::make_pair(1.0f, 1.0f));
+	wall.push_back(std::make_pair(0.0f, 1.0f));
+
+	float offsets[] = { -0.5f, -0.001f, -1e-6f, 0.0f, 1e-6f, 0.001f };
+	for (int o = 0; o < 6; o++) {
+		std::vector<std::pair<float, float>> box;
+		box.push_back(std::make_pair(-0.5f + offsets[o] * -1.0f, -0.25f));
+		box.push_back(std::make_pair(0.0f - offsets[o], -0.25f));
+		box.push_back(std::make_pair(0.0f - offsets[o], 0.25f));
+		box.push_back(std::make_pair(-0.5f - offsets[o], 0.25f));
+
+		std::pair<float, float> expected;
+		std::pair<float, float> actual;
+		CHECK(ScalarSATCollision(box, wall, expected) == CheckSATCollision(box, wall, actual));
+	}
+}
+
+//Old scalar SAT (allocates and sorts) against the current one, same random pairs
+BENCHMARK(sat_against_scalar_reference) {
+	int sizes[] = { 4, 8, 16 };
+	for (int s = 0; s < 3; s++) {
+		srand(5);
+		std::vector<std::vector<std::pair<float, float>>> shapes;
+		for (int i = 0; i < 2000; i++) {
+			shapes.push_back(random_polygon(sizes[s], random_float(-1.0f, 1.0f), random_float(-1.0f, 1.0f), random_float(0.1f, 0.8f)));
+		}
+
+		int pairs = shapes.size() / 2;
+		int rounds = 50;
+		int hits = 0;
+		double start = bench_seconds();
+		for (int r = 0; r < rounds; r++) {
+			for (int i = 0; i < pairs; i++) {
+				std::pair<float, float> penetration;
+				hits += ScalarSATCollision(shapes[i * 2], shapes[i * 2 + 1], penetration) ? 1 : 0;
+			}
+		}
+		double scalar_seconds = bench_seconds() - start;
+
+		start = bench_seconds();
+		for (int r = 0; r < rounds; r++) {
+			for (int i = 0; i < pairs; i++) {
+				std::pair<float, float> penetration;
+				hits += CheckSATCollision(shapes[i * 2], shapes[i * 2 + 1], penetration) ? 1 : 0;
+			}
+		}
+		double simd_seconds = bench_seconds() - start;
+
+		double tests = (double)pairs * rounds;
+		std::cout << "  " << sizes[s] << " points: scalar " << scalar_seconds * 1e9 / tests << " ns/test, current "
+			<< simd_seconds * 1e9 / tests << " ns/test (" << hits << " hits)" << std::endl;
+	}
+}
@@ -0,0 +1,387 @@
+#include "MusicStream.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+MusicStream::MusicStream(){
+	underruns = 0;
+	volume = 1.0f;
+	pending = NULL;
+	pending_fade_samples = 0;
+	retired_head = NULL;
+}
+
+MusicStream::~MusicStream(){
+	close();
+}
+
+void MusicStream::open(){
+	int rate;
+	Uint16 format;
+	int channels;
+	if (Mix_QuerySpec(&rate, &format, &channels) == 0){
+		std::cout << "MusicStream: audio is not open" << std::endl;
+		return;
+	}
+
+	device_rate = rate;
+	device_channels = std::min(channels, 2);
+	can_stream = format == AUDIO_S16SYS && channels <= 2;
+	if (!can_stream){
+		std::cout << "MusicStream: device format not 16 bit, using SDL_mixer for music" << std::endl;
+	}
+}
+
+void MusicStream::close(){
+	if (hooked){
+		//Once this returns the callback won't run again, so the tracks are ours
+		Mix_HookMusic(NULL, NULL);
+		hooked = false;
+	}
+
+	delete_track(pending.exchange(NULL));
+	delete_track(current);
+	delete_track(previous);
+	current = NULL;
+	previous = NULL;
+	update();
+
+	if (fallback_music != NULL){
+		Mix_HaltMusic();
+		Mix_FreeMusic(fallback_music);
+		fallback_music = NULL;
+	}
+	current_path = "";
+}
+
+static bool is_wav(const std::string& path){
+	if (path.size() < 4){
+		return false;
+	}
+	std::string extension = path.substr(path.size() - 4);
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension == ".wav";
+}
+
+void MusicStream::play(const std::string& path, float fade_seconds){
+	update();
+
+	if (path == current_path){
+		return;
+	}
+
+	if (can_stream && is_wav(path)){
+		Track* track = new Track();
+		track->path = path;
+		if (open_wav(*track)){
+			current_path = path;
+			if (fallback_music != NULL){
+				Mix_HaltMusic();
+				Mix_FreeMusic(fallback_music);
+				fallback_music = NULL;
+			}
+
+			//Power of two, so the positions can wrap freely
+			unsigned int capacity = 1024;
+			while (capacity < buffer_seconds * device_rate * device_channels){
+				capacity *= 2;
+			}
+			track->ring.resize(capacity);
+			track->decoder = std::thread(&MusicStream::decode_loop, this, track);
+
+			if (!hooked){
+				Mix_HookMusic(&MusicStream::mix_callback, this);
+				hooked = true;
+			}
+			start_track(track, fade_seconds);
+			return;
+		}
+		delete track;
+	}
+
+	//Whatever is playing keeps playing if the new track can't be loaded
+	Mix_Music* music = Mix_LoadMUS(path.c_str());
+	if (music == NULL){
+		std::cout << "Unable to load music " << path << std::endl;
+		return;
+	}
+	current_path = path;
+
+	//SDL_mixer's player streams these itself, but can't overlap two tracks
+	if (fade_seconds > 0){
+		std::cout << "MusicStream: " << path << " is not WAV, fading in without a crossfade" << std::endl;
+	}
+	if (hooked){
+		Mix_HookMusic(NULL, NULL);
+		hooked = false;
+		delete_track(pending.exchange(NULL));
+		delete_track(current);
+		delete_track(previous);
+		current = NULL;
+		previous = NULL;
+	}
+
+	if (fallback_music != NULL){
+		Mix_HaltMusic();
+		Mix_FreeMusic(fallback_music);
+	}
+	fallback_music = music;
+	Mix_VolumeMusic((int)(volume.load() * MIX_MAX_VOLUME));
+	Mix_FadeInMusic(music, -1, (int)(fade_seconds * 1000));
+}
+
+void MusicStream::stop(float fade_seconds){
+	current_path = "";
+
+	if (hooked){
+		//A track with no ring plays silence
+		start_track(new Track(), fade_seconds);
+	}
+	if (fallback_music != NULL){
+		Mix_FadeOutMusic((int)(fade_seconds * 1000));
+	}
+}
+
+void MusicStream::set_volume(float volume_){
+	volume = volume_;
+	Mix_VolumeMusic((int)(volume_ * MIX_MAX_VOLUME));
+}
+
+void MusicStream::start_track(Track* track, float fade_seconds){
+	pending_fade_samples = std::max(1, (int)(fade_seconds * device_rate));
+
+	//A track the callback never picked up is still ours to free
+	delete_track(pending.exchange(track));
+}
+
+void MusicStream::retire(Track* track){
+	track->next_retired = retired_head.load();
+	while (!retired_head.compare_exchange_weak(track->next_retired, track)){
+	}
+}
+
+void MusicStream::update(){
+	Track* track = retired_head.exchange(NULL);
+	while (track != NULL){
+		Track* next = track->next_retired;
+		delete_track(track);
+		track = next;
+	}
+}
+
+void MusicStream::delete_track(Track* track){
+	if (track == NULL){
+		return;
+	}
+
+	track->stopping = true;
+	if (track->decoder.joinable()){
+		track->decoder.join();
+	}
+	delete track;
+}
+
+bool MusicStream::open_wav(Track& track){
+	track.file.open(track.path, std::ios::binary);
+	if (!track.file){
+		std::cout << "Unable to open music " << track.path << std::endl;
+		return false;
+	}
+
+	char riff[12];
+	track.file.read(riff, 12);
+	if (!track.file || strncmp(riff, "RIFF", 4) != 0 || strncmp(riff + 8, "WAVE", 4) != 0){
+		return false;
+	}
+
+	bool have_format = false;
+	while (track.file){
+		char id[4];
+		Uint32 size;
+		track.file.read(id, 4);
+		track.file.read((char*)&size, 4);
+		if (!track.file){
+			break;
+		}
+
+		if (strncmp(id, "fmt ", 4) == 0){
+			Uint16 format_tag, channels, block_align, bits;
+			Uint32 rate, byte_rate;
+			track.file.read((char*)&format_tag, 2);
+			track.file.read((char*)&channels, 2);
+			track.file.read((char*)&rate, 4);
+			track.file.read((char*)&byte_rate, 4);
+			track.file.read((char*)&block_align, 2);
+			track.file.read((char*)&bits, 2);
+			track.file.seekg(size - 16 + (size & 1), std::ios::cur);
+
+			if (format_tag != 1 || bits != 16 || channels < 1 || channels > 2){
+				std::cout << "MusicStream: " << track.path << " is not 16 bit PCM" << std::endl;
+				return false;
+			}
+			track.source_rate = rate;
+			track.source_channels = channels;
+			have_format = true;
+		}
+		else if (strncmp(id, "data", 4) == 0){
+			track.data_start = track.file.tellg();
+			track.data_bytes = size;
+			return have_format && size > 0;
+		}
+		else{
+			track.file.seekg(size + (size & 1), std::ios::cur);
+		}
+	}
+	return false;
+}
+
+//Reads one chunk of source frames and converts it to device channels and rate
+bool MusicStream::decode_chunk(Track& track, std::vector<Sint16>& source, std::vector<Sint16>& out){
+	int frame_bytes = track.source_channels * 2;
+	if (track.read_bytes + frame_bytes > track.data_bytes){
+		//Loop
+		track.file.clear();
+		track.file.seekg(track.data_start);
+		track.read_bytes = 0;
+	}
+
+	int frames = std::min(chunk_frames, (track.data_bytes - track.read_bytes) / frame_bytes);
+	source.resize(frames * track.source_channels);
+	track.file.read((char*)source.data(), frames * frame_bytes);
+	frames = (int)track.file.gcount() / frame_bytes;
+	track.read_bytes += frames * frame_bytes;
+	if (frames <= 0){
+		return false;
+	}
+
+	//frame(0) is the last frame of the previous chunk, so interpolation runs across chunk edges
+	auto sample = [&](int frame, int channel) -> int {
+		if (frame == 0){
+			return track.last_frame[channel];
+		}
+		const Sint16* f = &source[(frame - 1) * track.source_channels];
+		if (device_channels == 1){
+			return track.source_channels == 1 ? f[0] : (f[0] + f[1]) / 2;
+		}
+		return track.source_channels == 1 ? f[0] : f[channel];
+	};
+
+	double step = (double)track.source_rate / device_rate;
+	out.clear();
+	while (track.phase < frames){
+		int i = (int)track.phase;
+		float t = (float)(track.phase - i);
+		for (int c = 0; c < device_channels; c++){
+			out.push_back((Sint16)(sample(i, c) * (1.0f - t) + sample(i + 1, c) * t));
+		}
+		track.phase += step;
+	}
+	track.phase -= frames;
+
+	for (int c = 0; c < device_channels; c++){
+		track.last_frame[c] = (Sint16)sample(frames, c);
+	}
+	return true;
+}
+
+void MusicStream::decode_loop(Track* track){
+	std::vector<Sint16> source;
+	std::vector<Sint16> out;
+	unsigned int capacity = track->ring.size();
+
+	while (!track->stopping){
+		if (out.empty() && !decode_chunk(*track, source, out)){
+			std::cout << "MusicStream: read failed for " << track->path << std::endl;
+			return;
+		}
+
+		unsigned int write = track->write_pos.load(std::memory_order_relaxed);
+		unsigned int used = write - track->read_pos.load(std::memory_order_acquire);
+		if (capacity - used < out.size()){
+			//Ring full, wait for the mixer to drain it
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			continue;
+		}
+
+		for (int i = 0; i < out.size(); i++){
+			track->ring[(write + i) & (capacity - 1)] = out[i];
+		}
+		track->write_pos.store(write + out.size(), std::memory_order_release);
+		out.clear();
+	}
+}
+
+void MusicStream::mix_callback(void* udata, Uint8* stream, int len){
+	((MusicStream*)udata)->mix((Sint16*)stream, len / 2);
+}
+
+//Copies up to samples from the ring, zero fills the rest
+static int pull(std::vector<Sint16>& ring, std::atomic<unsigned int>& read_pos, std::atomic<unsigned int>& write_pos, Sint16* out, int samples){
+	if (ring.empty()){
+		memset(out, 0, samples * sizeof(Sint16));
+		return samples;
+	}
+
+	unsigned int capacity = ring.size();
+	unsigned int read = read_pos.load(std::memory_order_relaxed);
+	unsigned int available = write_pos.load(std::memory_order_acquire) - read;
+	int count = std::min((unsigned int)samples, available);
+	for (int i = 0; i < count; i++){
+		out[i] = ring[(read + i) & (capacity - 1)];
+	}
+	memset(out + count, 0, (samples - count) * sizeof(Sint16));
+	read_pos.store(read + count, std::memory_order_release);
+	return count;
+}
+
+void MusicStream::mix(Sint16* out, int samples){
+	Track* incoming = pending.exchange(NULL);
+	if (incoming != NULL){
+		if (previous != NULL){
+			retire(previous);
+		}
+		previous = current;
+		current = incoming;
+		fade_samples = pending_fade_samples;
+		fade_pos = 0;
+	}
+
+	if (scratch.size() < samples){
+		scratch.resize(samples);
+	}
+
+	if (current == NULL){
+		memset(out, 0, samples * sizeof(Sint16));
+	}
+	else{
+		//A track whose decoder hasn't produced anything yet is starting, not starving
+		bool primed = current->write_pos.load(std::memory_order_acquire) != 0;
+		if (pull(current->ring, current->read_pos, current->write_pos, out, samples) < samples && primed){
+			underruns++;
+		}
+	}
+
+	float gain = volume;
+	if (previous != NULL){
+		pull(previous->ring, previous->read_pos, previous->write_pos, scratch.data(), samples);
+	}
+
+	for (int i = 0; i < samples; i += device_channels){
+		float fade = fade_pos < fade_samples ? (float)fade_pos / fade_samples : 1.0f;
+		for (int c = 0; c < device_channels; c++){
+			float value = out[i + c] * fade;
+			if (previous != NULL){
+				value += scratch[i + c] * (1.0f - fade);
+			}
+			value *= gain;
+			out[i + c] = (Sint16)std::max(-32768.0f, std::min(32767.0f, value));
+		}
+		fade_pos++;
+	}
+
+	if (previous != NULL && fade_pos >= fade_samples){
+		retire(previous);
+		previous = NULL;
+	}
+}
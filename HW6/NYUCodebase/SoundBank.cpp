@@ -0,0 +1,227 @@
+#include "SoundBank.h"
+#include <iostream>
+#include <chrono>
+
+static int mix_allocate_channels(int count){
+	return Mix_AllocateChannels(count);
+}
+
+static int mix_play_channel(int channel, Mix_Chunk* chunk){
+	return Mix_PlayChannel(channel, chunk, 0);
+}
+
+static bool mix_playing(int channel){
+	return Mix_Playing(channel) != 0;
+}
+
+static void mix_free_chunk(Mix_Chunk* chunk){
+	Mix_FreeChunk(chunk);
+}
+
+SoundBank::SoundBank(){
+	mixer.allocate_channels = mix_allocate_channels;
+	mixer.play_channel = mix_play_channel;
+	mixer.playing = mix_playing;
+	mixer.free_chunk = mix_free_chunk;
+
+	played = 0;
+	coalesced = 0;
+	stolen = 0;
+	dropped = 0;
+	tick = 1;
+	enqueue_pos = 0;
+	stopping = false;
+
+	for (unsigned int i = 0; i < QUEUE_SIZE; i++){
+		commands[i].sequence = i;
+	}
+}
+
+SoundBank::~SoundBank(){
+	stop();
+}
+
+SoundId SoundBank::load(const std::string& name, const std::string& path, int max_voices, int priority){
+	Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+	if (chunk == NULL){
+		std::cout << "Unable to load sound " << path << std::endl;
+		return NO_SOUND;
+	}
+
+	return add(name, chunk, max_voices, priority);
+}
+
+SoundId SoundBank::add(const std::string& name, Mix_Chunk* chunk, int max_voices, int priority){
+	std::unique_ptr<Sound> sound(new Sound());
+	sound->name = name;
+	sound->chunk = chunk;
+	sound->max_voices = max_voices;
+	sound->priority = priority;
+	sound->queued_tick = 0;
+	sounds.push_back(std::move(sound));
+	return sounds.size() - 1;
+}
+
+SoundId SoundBank::find(const std::string& name){
+	for (int i = 0; i < sounds.size(); i++){
+		if (sounds[i]->name == name){
+			return i;
+		}
+	}
+	return NO_SOUND;
+}
+
+void SoundBank::start(int voice_count){
+	mixer.allocate_channels(voice_count);
+	voices.resize(voice_count);
+	audio_thread = std::thread(&SoundBank::audio_loop, this);
+}
+
+void SoundBank::stop(){
+	if (audio_thread.joinable()){
+		stopping = true;
+		wake.notify_one();
+		audio_thread.join();
+	}
+
+	for (int i = 0; i < sounds.size(); i++){
+		mixer.free_chunk(sounds[i]->chunk);
+	}
+	sounds.clear();
+}
+
+void SoundBank::play(SoundId id){
+	if (id < 0 || id >= sounds.size()){
+		return;
+	}
+
+	unsigned int now = tick.load(std::memory_order_relaxed);
+	if (sounds[id]->queued_tick.exchange(now) == now){
+		coalesced++;
+		return;
+	}
+
+	if (!push(id)){
+		dropped++;
+	}
+}
+
+void SoundBank::end_tick(){
+	tick++;
+}
+
+bool SoundBank::push(SoundId id){
+	unsigned int pos = enqueue_pos.load(std::memory_order_relaxed);
+	Command* command;
+	while (true){
+		command = &commands[pos % QUEUE_SIZE];
+		unsigned int sequence = command->sequence.load(std::memory_order_acquire);
+		int difference = (int)(sequence - pos);
+		if (difference == 0){
+			if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+				break;
+			}
+		}
+		else if (difference < 0){
+			//Full
+			return false;
+		}
+		else{
+			pos = enqueue_pos.load(std::memory_order_relaxed);
+		}
+	}
+
+	command->sound = id;
+	command->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+bool SoundBank::pop(SoundId& id){
+	Command& command = commands[dequeue_pos % QUEUE_SIZE];
+	unsigned int sequence = command.sequence.load(std::memory_order_acquire);
+	if ((int)(sequence - (dequeue_pos + 1)) < 0){
+		return false;
+	}
+
+	id = command.sound;
+	command.sequence.store(dequeue_pos + QUEUE_SIZE, std::memory_order_release);
+	dequeue_pos++;
+	return true;
+}
+
+void SoundBank::audio_loop(){
+	while (!stopping){
+		{
+			//Polls instead of being woken by play(), so playing never makes a syscall.
+			//stop() notifies so shutdown doesn't wait out the timeout.
+			std::unique_lock<std::mutex> guard(wake_lock);
+			wake.wait_for(guard, std::chrono::milliseconds(5));
+		}
+
+		SoundId id;
+		while (pop(id)){
+			start_voice(id);
+		}
+	}
+}
+
+void SoundBank::start_voice(SoundId id){
+	const Sound& sound = *sounds[id];
+
+	int same_count = 0;
+	int oldest_same = -1;
+	int free_channel = -1;
+	int victim = -1;
+	for (int channel = 0; channel < voices.size(); channel++){
+		Voice& voice = voices[channel];
+		if (voice.sound != NO_SOUND && !mixer.playing(channel)){
+			voice.sound = NO_SOUND;
+		}
+
+		if (voice.sound == NO_SOUND){
+			if (free_channel < 0){
+				free_channel = channel;
+			}
+			continue;
+		}
+
+		if (voice.sound == id){
+			same_count++;
+			if (oldest_same < 0 || voice.started < voices[oldest_same].started){
+				oldest_same = channel;
+			}
+		}
+
+		//Lowest priority first, then oldest
+		if (voice.priority <= sound.priority){
+			if (victim < 0 || voice.priority < voices[victim].priority ||
+				(voice.priority == voices[victim].priority && voice.started < voices[victim].started)){
+				victim = channel;
+			}
+		}
+	}
+
+	int channel;
+	if (same_count >= sound.max_voices){
+		channel = oldest_same;
+		stolen++;
+	}
+	else if (free_channel >= 0){
+		channel = free_channel;
+	}
+	else if (victim >= 0){
+		channel = victim;
+		stolen++;
+	}
+	else{
+		//Everything playing matters more
+		dropped++;
+		return;
+	}
+
+	mixer.play_channel(channel, sound.chunk);
+	voices[channel].sound = id;
+	voices[channel].priority = sound.priority;
+	voices[channel].started = ++voice_clock;
+	played++;
+}
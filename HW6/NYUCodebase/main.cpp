@@ -14,6 +14,8 @@
 #include <math.h>
 #include <algorithm> //std::remove_if
 #include <time.h>  
+#include "SoundBank.h"
+#include "MusicStream.h"
 #ifdef _WINDOWS
 	#define RESOURCE_FOLDER ""
 #else
@@ -790,35 +792,29 @@ public:
 	int score = 0;
 	int enemies_per_row = 11;
 
-	Mix_Music* music1 = NULL;
+	MusicStream music;
 
-	std::unordered_map<std::string, Mix_Chunk*> sounds;
-
-	void play_sound(std::string sound_name){
-		if (sounds.find(sound_name) == sounds.end()){
-			//key not found
-			return;
-		}
-
-		Mix_PlayChannel(-1, sounds[sound_name], 0); //if channel is -1, pick the first free unreserved channel.
-	}
+	SoundBank sounds;
+	//Mixer device buffer in sample frames, 1024 is about 23ms at 44.1kHz
+	int sfx_buffer_samples = 1024;
+	SoundId laser_2_sound = NO_SOUND;
+	SoundId laser_3_sound = NO_SOUND;
+	SoundId explosion_sound = NO_SOUND;
 
 	GameLevel(){
-		Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
-		Mix_Chunk* laser1 = Mix_LoadWAV("resources/laser_1.wav");
-		Mix_Chunk* laser2 = Mix_LoadWAV("resources/laser_2.wav");
-		Mix_Chunk* laser3 = Mix_LoadWAV("resources/laser_3.wav");
-		Mix_Chunk* explosion1 = Mix_LoadWAV("resources/explosion_1.wav");
-
-		sounds["laser_1"] = laser1;
-		sounds["laser_2"] = laser2;
-		sounds["laser_3"] = laser3;
-		sounds["explosion_1"] = explosion1;
+		//deltron.wav streams through its own ring buffer, so the device buffer can stay small for the lasers
+		Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, sfx_buffer_samples);
+		music.open();
+		//Enemy shots matter least, explosions most
+		sounds.load("laser_1", "resources/laser_1.wav");
+		laser_2_sound = sounds.load("laser_2", "resources/laser_2.wav", 3, 0);
+		laser_3_sound = sounds.load("laser_3", "resources/laser_3.wav", 2, 1);
+		explosion_sound = sounds.load("explosion_1", "resources/explosion_1.wav", 3, 2);
+		sounds.start();
 		//Mix_PlayChannel(-1, sound1, 0);
 
 		//Play music
-		music1 = Mix_LoadMUS("resources/deltron.wav");
-		Mix_PlayMusic(music1, -1);
+		music.play("resources/deltron.wav", 0);
 		//Mix_HaltMusic();
 		//Mix_VolumeMusic(30);
 		//Mix_VolumeChunk(sound1, 10); //set sound volume from 0 to 128
@@ -935,16 +931,10 @@ public:
 
 	~GameLevel(){
 
-		std::unordered_map<std::string, Mix_Chunk*>::iterator it;
-
-		for (it = sounds.begin(); it != sounds.end(); it++){
-			//it->first = key
-			//it->second = value
-			Mix_FreeChunk(it->second);
-		}
+		sounds.stop();
 		
 
-		Mix_FreeMusic(music1);
+		music.close();
 
 		for (int x = 0; x < objects.size(); x++){
 			delete objects[x];
@@ -1072,7 +1062,7 @@ public:
 
 		bullets.push_back(enemy.shoot(bullet_animation));
 
-		play_sound("laser_2");
+		sounds.play(laser_2_sound);
 	}
 
 	void render(){
@@ -1164,7 +1154,7 @@ public:
 
 			for (int z = 0; z < barriers.size(); z++){
 				if (check_box_collision(bullets[x], *barriers[z])){
-					play_sound("explosion_1");
+					sounds.play(explosion_sound);
 					barrier_take_hit(barriers[z]);
 					bullets[x].destroy();
 					continue_to_next_loop = true;
@@ -1214,7 +1204,7 @@ public:
 			if (event.type == SDL_KEYDOWN){
 				if (event.key.keysym.sym == SDLK_SPACE){
 
-					play_sound("laser_3");
+					sounds.play(laser_3_sound);
 					Animation bullet_animation;
 					Sprite bullet_sprite(sprite_sheet_texture, 112.0f / sheet_width, 0.0f / sheet_height, 16.0f / sheet_width, 16.0f / sheet_height, 0.35);
 
@@ -1353,6 +1343,8 @@ int main(int argc, char *argv[]) {
 
 		process_input();
 		update_game();
+		gameLevel->sounds.end_tick();
+		gameLevel->music.update();
 		render_game();
 
 		SDL_GL_SwapWindow(displayWindow);